@@ -0,0 +1,175 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	An OpenGL context which shares objects with the main
+		 *	context.
+		 *
+		 *	How contexts are created depends on the windowing system
+		 *	and therefore implementations of this interface are
+		 *	supplied by the application.
+		 */
+		class shared_context {
+			
+			
+			public:
+			
+			
+				virtual ~shared_context () noexcept;
+				
+				
+				/**
+				 *	Makes this context current on the calling thread.
+				 */
+				virtual void make_current () = 0;
+				/**
+				 *	Makes no context current on the calling thread.
+				 */
+				virtual void release () noexcept = 0;
+			
+			
+		};
+		
+		
+		/**
+		 *	Compiles and links programs on worker threads, each of
+		 *	which owns a context shared with the main context.
+		 *
+		 *	This is intended for implementations which lack
+		 *	KHR_parallel_shader_compile, on which program_batch
+		 *	cannot keep the thread to which the main context is
+		 *	bound from blocking.
+		 *
+		 *	Once a program has been linked its worker waits on a
+		 *	fence so that the program is complete before it is
+		 *	handed to the main context.  Since programs are shared
+		 *	between the contexts the returned program objects may
+		 *	be used and destroyed on the main thread as usual.
+		 */
+		class compile_service {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The type of callback used to create worker contexts.
+				 */
+				using factory_type=std::function<std::unique_ptr<shared_context> ()>;
+			
+			
+			private:
+			
+			
+				class job {
+					
+					
+					public:
+					
+					
+						std::vector<shader_source> sources;
+						std::promise<program> result;
+					
+					
+				};
+				
+				
+				std::mutex m_;
+				std::condition_variable cv_;
+				std::deque<job> queue_;
+				bool stop_;
+				std::vector<std::unique_ptr<shared_context>> contexts_;
+				std::vector<std::thread> threads_;
+				
+				
+				void worker (shared_context &);
+				void stop () noexcept;
+			
+			
+			public:
+			
+			
+				compile_service (const compile_service &) = delete;
+				compile_service (compile_service &&) = delete;
+				compile_service & operator = (const compile_service &) = delete;
+				compile_service & operator = (compile_service &&) = delete;
+				
+				
+				/**
+				 *	Creates the worker contexts and starts the worker
+				 *	threads.
+				 *
+				 *	Must be called on the thread to which the main
+				 *	context is bound.
+				 *
+				 *	\param [in] factory
+				 *		Invoked once per worker on the calling thread to
+				 *		create a context which shares with the main
+				 *		context.
+				 *	\param [in] threads
+				 *		The number of workers, which must not be zero.
+				 *		Defaults to 1.
+				 */
+				explicit compile_service (const factory_type & factory, std::size_t threads=1);
+				
+				
+				/**
+				 *	Finishes all submitted programs and then stops the
+				 *	worker threads and destroys their contexts.
+				 */
+				~compile_service () noexcept;
+				
+				
+				/**
+				 *	Retrieves the number of workers.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t size () const noexcept;
+				
+				
+				/**
+				 *	Submits a program to be compiled and linked.
+				 *
+				 *	\param [in] sources
+				 *		The shaders which make up the program.
+				 *
+				 *	\return
+				 *		A future which yields the linked program, or
+				 *		the shader_compilation_error or
+				 *		program_linking_error encountered building it.
+				 */
+				std::future<program> submit (std::vector<shader_source> sources);
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,119 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	A shader source file compiled into the executable by
+		 *	the gl_utilities_embed_shaders CMake function.
+		 */
+		class embedded_source {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The path of the file relative to the directory
+				 *	from which it was embedded.
+				 */
+				const char * name;
+				const char * data;
+				std::size_t size;
+				/**
+				 *	The FNV-1a hash of the contents of the file,
+				 *	computed at build time.
+				 */
+				std::uint64_t hash;
+			
+			
+		};
+		
+		
+		/**
+		 *	A table of embedded_source objects sorted by name, as
+		 *	generated by the gl_utilities_embed_shaders CMake
+		 *	function.
+		 */
+		class embedded_table {
+			
+			
+			public:
+			
+			
+				const embedded_source * sources;
+				std::size_t count;
+				
+				
+				const embedded_source * begin () const noexcept {
+					
+					return sources;
+					
+				}
+				
+				
+				const embedded_source * end () const noexcept {
+					
+					return sources+count;
+					
+				}
+				
+				
+				/**
+				 *	Finds an embedded source by name.
+				 *
+				 *	\param [in] name
+				 *		The name of the source.
+				 *
+				 *	\return
+				 *		A pointer to the source if it was embedded,
+				 *		\em nullptr otherwise.
+				 */
+				const embedded_source * find (const char * name) const noexcept {
+					
+					std::size_t lo=0;
+					std::size_t hi=count;
+					while (lo<hi) {
+						
+						auto mid=lo+((hi-lo)/2);
+						auto c=std::strcmp(sources[mid].name,name);
+						if (c==0) return sources+mid;
+						if (c<0) lo=mid+1;
+						else hi=mid;
+						
+					}
+					
+					return nullptr;
+					
+				}
+				
+				
+				const embedded_source * find (const std::string & name) const noexcept {
+					
+					return find(name.c_str());
+					
+				}
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
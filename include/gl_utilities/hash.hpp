@@ -0,0 +1,107 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+namespace gl_utilities {
+	
+	
+	/**
+	 *	The initial state of a 64 bit FNV-1a hash.
+	 */
+	constexpr std::uint64_t fnv1a_offset_basis=14695981039346656037ULL;
+	/**
+	 *	The multiplier of a 64 bit FNV-1a hash.
+	 */
+	constexpr std::uint64_t fnv1a_prime=1099511628211ULL;
+	
+	
+	/**
+	 *	Computes (or continues computing) the 64 bit FNV-1a hash
+	 *	of a sequence of bytes.
+	 *
+	 *	Since this function is constexpr hashes of string literals
+	 *	may be computed at compile time.
+	 *
+	 *	\param [in] begin
+	 *		A pointer to the first byte.
+	 *	\param [in] len
+	 *		The number of bytes.
+	 *	\param [in] h
+	 *		The hash to continue, defaults to the initial state.
+	 *
+	 *	\return
+	 *		The hash.
+	 */
+	constexpr std::uint64_t fnv1a (const char * begin, std::size_t len, std::uint64_t h=fnv1a_offset_basis) noexcept {
+		
+		for (std::size_t i=0;i<len;++i) {
+			
+			h^=static_cast<unsigned char>(begin[i]);
+			h*=fnv1a_prime;
+			
+		}
+		
+		return h;
+		
+	}
+	
+	
+	/**
+	 *	Computes (or continues computing) the 64 bit FNV-1a hash
+	 *	of a string.
+	 *
+	 *	\param [in] str
+	 *		The string.
+	 *	\param [in] h
+	 *		The hash to continue, defaults to the initial state.
+	 *
+	 *	\return
+	 *		The hash.
+	 */
+	inline std::uint64_t fnv1a (const std::string & str, std::uint64_t h=fnv1a_offset_basis) noexcept {
+		
+		return fnv1a(str.data(),str.size(),h);
+		
+	}
+	
+	
+	/**
+	 *	Continues computing the 64 bit FNV-1a hash of a sequence
+	 *	of bytes with the bytes of an integer, least significant
+	 *	first, so that the result does not depend on the byte order
+	 *	of the machine.
+	 *
+	 *	\param [in] i
+	 *		The integer.
+	 *	\param [in] h
+	 *		The hash to continue, defaults to the initial state.
+	 *
+	 *	\return
+	 *		The hash.
+	 */
+	template <typename T>
+	constexpr std::uint64_t fnv1a_integer (T i, std::uint64_t h=fnv1a_offset_basis) noexcept {
+		
+		auto u=static_cast<std::uint64_t>(i);
+		for (std::size_t n=0;n<sizeof(T);++n) {
+			
+			h^=(u>>(n*8))&0xFFU;
+			h*=fnv1a_prime;
+			
+		}
+		
+		return h;
+		
+	}
+	
+	
+}
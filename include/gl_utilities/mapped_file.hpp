@@ -0,0 +1,81 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <string>
+
+
+namespace gl_utilities {
+	
+	
+	/**
+	 *	Maps a file into memory read only.
+	 */
+	class mapped_file {
+		
+		
+		private:
+		
+		
+			void * data_;
+			std::size_t size_;
+			
+			
+			void destroy () noexcept;
+		
+		
+		public:
+		
+		
+			mapped_file (const mapped_file &) = delete;
+			mapped_file & operator = (const mapped_file &) = delete;
+			
+			
+			/**
+			 *	Creates an object which does not map any file.
+			 */
+			mapped_file () noexcept;
+			/**
+			 *	Maps a file.  Throws std::system_error if the file
+			 *	cannot be opened or mapped.
+			 *
+			 *	\param [in] filename
+			 *		The name of the file.
+			 */
+			explicit mapped_file (const std::string & filename);
+			mapped_file (mapped_file &&) noexcept;
+			mapped_file & operator = (mapped_file &&) noexcept;
+			
+			
+			/**
+			 *	Unmaps the file.
+			 */
+			~mapped_file () noexcept;
+			
+			
+			/**
+			 *	Retrieves a pointer to the contents of the file.
+			 *
+			 *	\return
+			 *		A pointer, which is \em nullptr if the file is
+			 *		empty.
+			 */
+			const char * data () const noexcept;
+			/**
+			 *	Retrieves the size of the file.
+			 *
+			 *	\return
+			 *		A number of bytes.
+			 */
+			std::size_t size () const noexcept;
+		
+		
+	};
+	
+	
+}
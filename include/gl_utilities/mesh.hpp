@@ -0,0 +1,359 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	/**
+	 *	Contains utilities for reordering and compacting indexed
+	 *	triangle lists on the CPU before they are uploaded, so that
+	 *	the GPU transforms and fetches fewer vertices.
+	 *
+	 *	Every function is deterministic: the same input always
+	 *	produces the same output.  No function requires an OpenGL
+	 *	context.
+	 */
+	namespace mesh {
+		
+		
+		/**
+		 *	Marks vertices which a remap drops.
+		 */
+		constexpr std::uint32_t unused=0xFFFFFFFFU;
+		
+		
+		/**
+		 *	Measures how well a triangle list uses the post
+		 *	transform vertex cache.
+		 */
+		class statistics {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The number of times a vertex is transformed.
+				 */
+				std::size_t transformed;
+				/**
+				 *	Average cache miss ratio: vertices transformed per
+				 *	triangle.  Between 0.5 (for large regular grids)
+				 *	and 3.
+				 */
+				double acmr;
+				/**
+				 *	Average transform to vertex ratio: vertices
+				 *	transformed per distinct vertex referenced.  1 is
+				 *	optimal.
+				 */
+				double atvr;
+			
+			
+		};
+		
+		
+		/**
+		 *	Simulates a FIFO post transform vertex cache to measure
+		 *	a triangle list.
+		 *
+		 *	\param [in] indices
+		 *		The indices, three per triangle.
+		 *	\param [in] count
+		 *		The number of indices.
+		 *	\param [in] vertex_count
+		 *		The number of vertices, every index must be less
+		 *		than this.
+		 *	\param [in] cache_size
+		 *		The number of entries in the simulated cache.
+		 *		Defaults to 16.
+		 *
+		 *	\return
+		 *		The statistics.
+		 */
+		statistics analyze (const std::uint32_t * indices, std::size_t count, std::size_t vertex_count, std::size_t cache_size=16);
+		
+		
+		/**
+		 *	Reorders triangles so that consecutive triangles share
+		 *	vertices, using Tipsify (Sander, Nehab, and Barczak,
+		 *	"Fast Triangle Reordering for Vertex Locality and Reduced
+		 *	Overdraw", 2007), which runs in linear time.
+		 *
+		 *	\param [in] indices
+		 *		The indices, three per triangle.
+		 *	\param [in] count
+		 *		The number of indices.
+		 *	\param [in] vertex_count
+		 *		The number of vertices.
+		 *	\param [in] cache_size
+		 *		The number of entries in the cache to optimize for.
+		 *		Defaults to 16.
+		 *
+		 *	\return
+		 *		The reordered indices.
+		 */
+		std::vector<std::uint32_t> optimize_vertex_cache (const std::uint32_t * indices, std::size_t count, std::size_t vertex_count, std::size_t cache_size=16);
+		/**
+		 *	Reorders clusters of triangles which have been optimized
+		 *	for the vertex cache so that triangles facing outward
+		 *	from the centre of the mesh are drawn first and occlude
+		 *	those behind them, after the same paper as
+		 *	optimize_vertex_cache.
+		 *
+		 *	Clusters are split only where doing so keeps the cache
+		 *	miss ratio within \em threshold of what it was.
+		 *
+		 *	\param [in] indices
+		 *		The indices, three per triangle, as returned by
+		 *		optimize_vertex_cache.
+		 *	\param [in] count
+		 *		The number of indices.
+		 *	\param [in] vertices
+		 *		The vertices.
+		 *	\param [in] vertex_count
+		 *		The number of vertices.
+		 *	\param [in] vertex_size
+		 *		The number of bytes between consecutive vertices.
+		 *	\param [in] position_offset
+		 *		The offset within each vertex of its position, which
+		 *		must be three floats.
+		 *	\param [in] cache_size
+		 *		The number of entries in the cache which was
+		 *		optimized for.  Defaults to 16.
+		 *	\param [in] threshold
+		 *		The factor by which the cache miss ratio may worsen.
+		 *		Defaults to 1.05.
+		 *
+		 *	\return
+		 *		The reordered indices.
+		 */
+		std::vector<std::uint32_t> optimize_overdraw (const std::uint32_t * indices, std::size_t count, const void * vertices, std::size_t vertex_count, std::size_t vertex_size, std::size_t position_offset, std::size_t cache_size=16, float threshold=1.05f);
+		
+		
+		/**
+		 *	Maps old vertex indices to new vertex indices.
+		 */
+		class remap {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The new index of each old vertex, or unused.
+				 */
+				std::vector<std::uint32_t> table;
+				/**
+				 *	The number of vertices after remapping.
+				 */
+				std::size_t vertex_count;
+			
+			
+		};
+		
+		
+		/**
+		 *	Finds vertices which are bitwise identical so that they
+		 *	may be merged.  Each distinct vertex keeps the position
+		 *	of its first occurrence.
+		 *
+		 *	\param [in] vertices
+		 *		The vertices.
+		 *	\param [in] vertex_count
+		 *		The number of vertices.
+		 *	\param [in] vertex_size
+		 *		The number of bytes in each vertex, including any
+		 *		padding, which must therefore be initialized.
+		 *
+		 *	\return
+		 *		A remap which maps identical vertices to the same
+		 *		index.
+		 */
+		remap weld (const void * vertices, std::size_t vertex_count, std::size_t vertex_size);
+		/**
+		 *	Orders vertices by their first use so that vertices are
+		 *	fetched from memory sequentially.  Vertices which are
+		 *	never used are dropped.
+		 *
+		 *	\param [in] indices
+		 *		The indices.
+		 *	\param [in] count
+		 *		The number of indices.
+		 *	\param [in] vertex_count
+		 *		The number of vertices.
+		 *
+		 *	\return
+		 *		The remap.
+		 */
+		remap optimize_vertex_fetch (const std::uint32_t * indices, std::size_t count, std::size_t vertex_count);
+		/**
+		 *	Rewrites indices in place according to a remap.
+		 *
+		 *	\param [in,out] indices
+		 *		The indices, none of which may refer to a vertex
+		 *		which \em r drops.
+		 *	\param [in] count
+		 *		The number of indices.
+		 *	\param [in] r
+		 *		The remap.
+		 */
+		void remap_indices (std::uint32_t * indices, std::size_t count, const remap & r);
+		/**
+		 *	Moves vertices according to a remap.
+		 *
+		 *	\param [in] vertices
+		 *		The vertices.
+		 *	\param [in] vertex_size
+		 *		The number of bytes in each vertex.
+		 *	\param [in] r
+		 *		The remap, whose table has one entry for every
+		 *		vertex in \em vertices.
+		 *
+		 *	\return
+		 *		The remapped vertices.
+		 */
+		std::vector<std::uint8_t> remap_vertices (const void * vertices, std::size_t vertex_size, const remap & r);
+		
+		
+		/**
+		 *	Determines the narrowest type which may be used to index
+		 *	a certain number of vertices.  Byte indices are never
+		 *	chosen since many implementations handle them poorly.
+		 *
+		 *	\param [in] vertex_count
+		 *		The number of vertices.
+		 *	\param [in] restart
+		 *		Whether the largest index of the type is reserved
+		 *		for primitive restart.  Defaults to \em false.
+		 *
+		 *	\return
+		 *		GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+		 */
+		GLenum index_type (std::size_t vertex_count, bool restart=false) noexcept;
+		/**
+		 *	Converts indices to 16 bits.
+		 *
+		 *	\param [in] indices
+		 *		The indices, each of which must fit in 16 bits.
+		 *	\param [in] count
+		 *		The number of indices.
+		 *
+		 *	\return
+		 *		The narrowed indices.
+		 */
+		std::vector<std::uint16_t> narrow (const std::uint32_t * indices, std::size_t count);
+		
+		
+		/**
+		 *	Describes which passes optimize performs.
+		 */
+		class settings {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The offset within each vertex of its position,
+				 *	which must be three floats.  Defaults to 0.
+				 */
+				std::size_t position_offset=0;
+				/**
+				 *	The number of entries in the cache to optimize for.
+				 *	Defaults to 16.
+				 */
+				std::size_t cache_size=16;
+				/**
+				 *	Whether to merge identical vertices.  Defaults to
+				 *	\em true.
+				 */
+				bool weld=true;
+				/**
+				 *	Whether to reorder for overdraw after reordering
+				 *	for the vertex cache.  Defaults to \em true.
+				 */
+				bool overdraw=true;
+				/**
+				 *	See optimize_overdraw.  Defaults to 1.05.
+				 */
+				float overdraw_threshold=1.05f;
+				/**
+				 *	Whether to use 16 bit indices where possible.
+				 *	Defaults to \em true.
+				 */
+				bool narrow=true;
+			
+			
+		};
+		
+		
+		/**
+		 *	A mesh ready to be uploaded.
+		 */
+		class result {
+			
+			
+			public:
+			
+			
+				std::vector<std::uint8_t> vertices;
+				std::size_t vertex_count;
+				/**
+				 *	The indices, packed as \em index_type.
+				 */
+				std::vector<std::uint8_t> indices;
+				std::size_t index_count;
+				/**
+				 *	GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+				 */
+				GLenum index_type;
+				/**
+				 *	Measured on the input with settings::cache_size.
+				 */
+				statistics before;
+				statistics after;
+			
+			
+		};
+		
+		
+		/**
+		 *	Runs every pass in turn: welding, vertex cache
+		 *	optimization, overdraw optimization, vertex fetch
+		 *	optimization, and index narrowing.
+		 *
+		 *	\param [in] indices
+		 *		The indices, three per triangle.
+		 *	\param [in] count
+		 *		The number of indices.
+		 *	\param [in] vertices
+		 *		The vertices.
+		 *	\param [in] vertex_count
+		 *		The number of vertices.
+		 *	\param [in] vertex_size
+		 *		The number of bytes in each vertex.
+		 *	\param [in] s
+		 *		Settings which control which passes run.
+		 *
+		 *	\return
+		 *		The optimized mesh.
+		 */
+		result optimize (const std::uint32_t * indices, std::size_t count, const void * vertices, std::size_t vertex_count, std::size_t vertex_size, const settings & s=settings{});
+		
+		
+	}
+	
+	
+}
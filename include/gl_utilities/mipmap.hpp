@@ -0,0 +1,193 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include "thread_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	/**
+	 *	Contains utilities for generating mipmap chains on
+	 *	the CPU.
+	 *
+	 *	Unlike glGenerateMipmap the quality of the results
+	 *	does not depend on the driver and generation may be
+	 *	performed on any thread, which means that only the
+	 *	uploads must be performed on the thread to which
+	 *	the OpenGL context is bound.
+	 */
+	namespace mipmap {
+		
+		
+		/**
+		 *	The filters which may be used to downsample
+		 *	each level.
+		 */
+		enum class filter {
+			
+			/**
+			 *	Averages each 2x2 block.  Fastest but
+			 *	blurriest and prone to aliasing.
+			 */
+			box,
+			/**
+			 *	A Kaiser windowed sinc.  Sharper than
+			 *	box with very little ringing.
+			 */
+			kaiser,
+			/**
+			 *	A three lobe Lanczos windowed sinc.  The
+			 *	sharpest, at the cost of some ringing.
+			 */
+			lanczos
+			
+		};
+		
+		
+		/**
+		 *	Describes how a mipmap chain is to be generated.
+		 */
+		class settings {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The filter with which to downsample.  Defaults
+				 *	to filter::box.
+				 */
+				filter f=filter::box;
+				/**
+				 *	The number of 8 bit channels in each pixel.  Must
+				 *	be between 1 and 4 inclusive.  Defaults to 4.
+				 */
+				std::size_t channels=4;
+				/**
+				 *	Whether the last channel is alpha.  Alpha is never
+				 *	considered sRGB encoded.  Defaults to \em true.
+				 */
+				bool alpha=true;
+				/**
+				 *	Whether the color channels are sRGB encoded.  If so
+				 *	they are decoded before filtering and encoded after
+				 *	filtering so that filtering is gamma correct.
+				 *	Defaults to \em false.
+				 */
+				bool srgb=false;
+				/**
+				 *	The alpha parameter of the Kaiser window.  Higher values
+				 *	trade sharpness for less ringing.  Only meaningful when
+				 *	\em f is filter::kaiser.  Defaults to 4.
+				 */
+				float kaiser_alpha=4.0f;
+			
+			
+		};
+		
+		
+		/**
+		 *	A single level of a mipmap chain.
+		 */
+		class level {
+			
+			
+			public:
+			
+			
+				std::size_t width;
+				std::size_t height;
+				/**
+				 *	Tightly packed rows of pixels in the same order
+				 *	and format as the rows of the base image.
+				 */
+				std::vector<std::uint8_t> data;
+			
+			
+		};
+		
+		
+		/**
+		 *	Generates all levels of a mipmap chain below a
+		 *	base image.
+		 *
+		 *	Each level is filtered from the previous level
+		 *	at full floating point precision and is only
+		 *	quantized for output.
+		 *
+		 *	\param [in] data
+		 *		Tightly packed pixels of the base image.
+		 *	\param [in] width
+		 *		The width of the base image.
+		 *	\param [in] height
+		 *		The height of the base image.
+		 *	\param [in] s
+		 *		Settings which control generation.
+		 *	\param [in] pool
+		 *		A thread pool across which rows of each level
+		 *		will be distributed.
+		 *
+		 *	\return
+		 *		The levels below the base image in order, i.e.
+		 *		element \em i is mipmap level \em i+1.  The last
+		 *		element is 1x1.
+		 */
+		std::vector<level> generate (const std::uint8_t * data, std::size_t width, std::size_t height, const settings & s, thread_pool & pool);
+		/**
+		 *	Generates all levels of a mipmap chain below a
+		 *	base image on the calling thread.
+		 *
+		 *	\param [in] data
+		 *		Tightly packed pixels of the base image.
+		 *	\param [in] width
+		 *		The width of the base image.
+		 *	\param [in] height
+		 *		The height of the base image.
+		 *	\param [in] s
+		 *		Settings which control generation.
+		 *
+		 *	\return
+		 *		The levels below the base image in order.
+		 */
+		std::vector<level> generate (const std::uint8_t * data, std::size_t width, std::size_t height, const settings & s);
+		
+		
+		/**
+		 *	Uploads generated levels to a two dimensional texture
+		 *	by calling glTexSubImage2D once per level.
+		 *
+		 *	Storage for every level must already have been allocated
+		 *	(for example by glTexStorage2D).  This function must be
+		 *	called on the thread to which the OpenGL context is bound.
+		 *
+		 *	\param [in] levels
+		 *		The levels to upload, as returned by generate.
+		 *	\param [in] tex
+		 *		The texture to upload to.
+		 *	\param [in] target
+		 *		The target to which \em tex shall be bound while
+		 *		uploading.
+		 *	\param [in] format
+		 *		The \em format parameter to glTexSubImage2D, which
+		 *		must have as many components as there are channels.
+		 *	\param [in] first
+		 *		The mipmap level to which the first element of
+		 *		\em levels shall be uploaded.  Defaults to 1.
+		 */
+		void upload (const std::vector<level> & levels, const opengl::texture & tex, GLenum target, GLenum format, GLint first=1);
+		
+		
+	}
+	
+	
+}
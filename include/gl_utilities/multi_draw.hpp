@@ -0,0 +1,191 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	The state shared by every draw in a bucket of a
+		 *	multi_draw.
+		 */
+		class multi_draw_state {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The vertex array to draw with, which must outlive
+				 *	the next flush.
+				 */
+				const vertex_array * vao;
+				/**
+				 *	The buffer to bind to GL_ELEMENT_ARRAY_BUFFER, which
+				 *	must outlive the next flush.
+				 */
+				const buffer * elements;
+				/**
+				 *	The primitive type, for example GL_TRIANGLES.
+				 */
+				GLenum mode;
+				/**
+				 *	GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, or
+				 *	GL_UNSIGNED_INT.
+				 */
+				GLenum index_type;
+				
+				
+				bool operator == (const multi_draw_state & other) const noexcept;
+			
+			
+		};
+		
+		
+		/**
+		 *	Accumulates indexed draws of meshes which share vertex
+		 *	and index buffers and issues them with one call to
+		 *	glMultiDrawElementsBaseVertex per distinct
+		 *	multi_draw_state.
+		 *
+		 *	This suits geometry which cannot use indirect draws.
+		 *	Buckets are flushed in the order in which their first
+		 *	draw was added, draws within a bucket are issued in the
+		 *	order they were added.
+		 *
+		 *	Where ARB_draw_elements_base_vertex is not supported
+		 *	glMultiDrawElements is used instead, in which case add
+		 *	throws if given a base vertex other than zero.
+		 *
+		 *	All member functions must be called on the thread to
+		 *	which the OpenGL context is bound.
+		 */
+		class multi_draw {
+			
+			
+			private:
+			
+			
+				class hasher {
+					
+					
+					public:
+					
+					
+						std::size_t operator () (const multi_draw_state & s) const noexcept;
+					
+					
+				};
+				
+				
+				class bucket {
+					
+					
+					public:
+					
+					
+						multi_draw_state state;
+						std::vector<GLsizei> counts;
+						std::vector<const void *> offsets;
+						std::vector<GLint> base_vertices;
+					
+					
+				};
+				
+				
+				std::vector<bucket> buckets_;
+				std::unordered_map<multi_draw_state,std::size_t,hasher> map_;
+				std::size_t draws_;
+				std::size_t calls_;
+			
+			
+			public:
+			
+			
+				multi_draw () noexcept;
+				
+				
+				/**
+				 *	Adds a draw.
+				 *
+				 *	\param [in] state
+				 *		The state to draw with.
+				 *	\param [in] count
+				 *		The number of indices.  Draws with no indices
+				 *		are ignored.
+				 *	\param [in] first
+				 *		The position of the mesh's first index within
+				 *		the element buffer, in indices rather than
+				 *		bytes.
+				 *	\param [in] base_vertex
+				 *		The value added to each index, i.e. the
+				 *		position of the mesh's first vertex within the
+				 *		vertex buffers.
+				 */
+				void add (const multi_draw_state & state, GLsizei count, std::size_t first, GLint base_vertex=0);
+				/**
+				 *	Issues every draw which has been added and then
+				 *	removes them.
+				 *
+				 *	The vertex array and element buffer bindings are
+				 *	restored afterwards.  The program and any other
+				 *	state must already be set.
+				 */
+				void flush ();
+				/**
+				 *	Removes every draw which has been added without
+				 *	issuing them.
+				 */
+				void clear () noexcept;
+				
+				
+				/**
+				 *	Retrieves the number of draws which have been
+				 *	added but not flushed.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t pending () const noexcept;
+				/**
+				 *	Retrieves the number of draws which have been
+				 *	issued by flush.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t draws () const noexcept;
+				/**
+				 *	Retrieves the number of OpenGL draw calls which
+				 *	flush has made to issue those draws.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t calls () const noexcept;
+				/**
+				 *	Resets draws and calls to zero.
+				 */
+				void reset_statistics () noexcept;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
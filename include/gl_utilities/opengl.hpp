@@ -6,12 +6,21 @@
 #pragma once
 
 
+#include "embedded.hpp"
+#include "hash.hpp"
 #include "optional.hpp"
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <istream>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
 #else
@@ -153,6 +162,23 @@ namespace gl_utilities {
 		void raise ();
 		
 		
+		/**
+		 *	A contiguous piece of shader source which is not owned
+		 *	(e.g. part of a mapped file).
+		 */
+		class source_fragment {
+			
+			
+			public:
+			
+			
+				const char * data;
+				std::size_t size;
+			
+			
+		};
+		
+		
 		/**
 		 *	Encapsulates an OpenGL shader.
 		 */
@@ -199,6 +225,9 @@ namespace gl_utilities {
 				inner handle_;
 				
 				
+				explicit shader (inner handle) noexcept;
+				
+				
 			public:
 			
 			
@@ -214,6 +243,84 @@ namespace gl_utilities {
 				 *		A shader object.
 				 */
 				static shader from_file (GLenum type, const std::string & filename);
+				/**
+				 *	Compiles a shader from a file, preceded by header
+				 *	strings (e.g. a \#version directive and definitions).
+				 *
+				 *	The file is mapped into memory and passed to OpenGL
+				 *	along with the headers without being copied.
+				 *
+				 *	\param [in] type
+				 *		The type of shader to compile.
+				 *	\param [in] filename
+				 *		The name of the file.
+				 *	\param [in] headers
+				 *		Strings which precede the contents of the file.
+				 *
+				 *	\return
+				 *		A shader object.
+				 */
+				static shader from_file (GLenum type, const std::string & filename, const std::vector<std::string> & headers);
+				/**
+				 *	Compiles a shader from a source embedded into the
+				 *	executable, which requires no file system access.
+				 *
+				 *	\param [in] type
+				 *		The type of shader to compile.
+				 *	\param [in] source
+				 *		The embedded source.
+				 *
+				 *	\return
+				 *		A shader object.
+				 */
+				static shader from_embedded (GLenum type, const embedded_source & source);
+				/**
+				 *	Compiles a shader from a source embedded into the
+				 *	executable, looked up by name.
+				 *
+				 *	\param [in] type
+				 *		The type of shader to compile.
+				 *	\param [in] table
+				 *		The table of embedded sources.
+				 *	\param [in] name
+				 *		The name of the source.
+				 *
+				 *	\return
+				 *		A shader object.
+				 */
+				static shader from_embedded (GLenum type, const embedded_table & table, const std::string & name);
+				/**
+				 *	Creates a shader and begins compiling it without
+				 *	waiting for the result.
+				 *
+				 *	Compilation errors are not reported until check
+				 *	is called (or a program to which the shader is
+				 *	attached is linked), which allows the implementation
+				 *	to compile many shaders concurrently.
+				 *
+				 *	\param [in] type
+				 *		The type of shader to create.
+				 *	\param [in] src
+				 *		The source of the shader.
+				 *
+				 *	\return
+				 *		A shader object.
+				 */
+				static shader deferred (GLenum type, const std::string & src);
+				/**
+				 *	Creates a shader from the concatenation of several
+				 *	fragments of source and begins compiling it without
+				 *	waiting for the result.
+				 *
+				 *	\param [in] type
+				 *		The type of shader to create.
+				 *	\param [in] fragments
+				 *		The fragments of source, in order.
+				 *
+				 *	\return
+				 *		A shader object.
+				 */
+				static shader deferred (GLenum type, const std::vector<source_fragment> & fragments);
 				
 				
 				shader () = default;
@@ -234,6 +341,47 @@ namespace gl_utilities {
 				 *		shader.
 				 */
 				shader (GLenum type, std::istream & is);
+				/**
+				 *	Creates and compiles a shader.
+				 *
+				 *	\param [in] type
+				 *		The type of shader to create.  The acceptable
+				 *		values for this parameter are defined by OpenGL.
+				 *	\param [in] src
+				 *		The source of the shader.
+				 */
+				shader (GLenum type, const std::string & src);
+				/**
+				 *	Creates and compiles a shader from the concatenation
+				 *	of several fragments of source.
+				 *
+				 *	\param [in] type
+				 *		The type of shader to create.  The acceptable
+				 *		values for this parameter are defined by OpenGL.
+				 *	\param [in] fragments
+				 *		The fragments of source, in order.
+				 */
+				shader (GLenum type, const std::vector<source_fragment> & fragments);
+				
+				
+				/**
+				 *	Determines whether the implementation has finished
+				 *	compiling this shader, i.e. whether check may be
+				 *	called without blocking.
+				 *
+				 *	Without KHR_parallel_shader_compile there is no
+				 *	way to ask and this always returns \em true.
+				 *
+				 *	\return
+				 *		\em true if compilation has finished, \em false
+				 *		otherwise.
+				 */
+				bool completed () const;
+				/**
+				 *	Waits for compilation to finish and throws if it
+				 *	failed.
+				 */
+				void check () const;
 				
 				
 				/**
@@ -250,105 +398,1271 @@ namespace gl_utilities {
 		
 		
 		/**
-		 *	Encapsulates an OpenGL shader program.
+		 *	The source of a single shader stage.
 		 */
-		class program {
+		class shader_source {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The type of shader.
+				 */
+				GLenum type;
+				std::string source;
+			
+			
+		};
+		
+		
+		/**
+		 *	The name of a resource (e.g. a uniform) of a program
+		 *	together with its hash.
+		 *
+		 *	All constructors are constexpr so names which are
+		 *	constants may be hashed at compile time, for example
+		 *	by using the _name literal.
+		 */
+		class resource_name {
 			
 			
 			private:
 			
 			
-				GLuint handle_;
+				static constexpr std::size_t length (const char * str) noexcept {
+					
+					std::size_t retr=0;
+					while (str[retr]!='\0') ++retr;
+					
+					return retr;
+					
+				}
+			
+			
+			public:
+			
+			
+				const char * str;
+				std::size_t len;
+				std::uint64_t hash;
 				
 				
-				void destroy () noexcept;
+				constexpr resource_name (const char * s, std::size_t l) noexcept : str(s), len(l), hash(fnv1a(s,l)) {	}
+				constexpr resource_name (const char * s) noexcept : resource_name(s,length(s)) {	}
+				resource_name (const std::string & s) noexcept : resource_name(s.c_str(),s.size()) {	}
+			
+			
+		};
+		
+		
+		/**
+		 *	Contains user defined literals.
+		 */
+		namespace literals {
+			
+			
+			/**
+			 *	Creates a resource_name, hashing it at compile time
+			 *	when used in a constant expression.
+			 *
+			 *	\param [in] str
+			 *		The name.
+			 *	\param [in] len
+			 *		The length of \em str.
+			 *
+			 *	\return
+			 *		A resource_name.
+			 */
+			constexpr resource_name operator "" _name (const char * str, std::size_t len) noexcept {
 				
+				return resource_name(str,len);
 				
+			}
+			
+			
+		}
+		
+		
+		/**
+		 *	Describes an active resource of a linked program.
+		 */
+		class program_resource {
+			
+			
 			public:
 			
 			
-				program (const program &) = delete;
-				program & operator = (const program &) = delete;
+				/**
+				 *	The index of the resource within its interface.
+				 *	For blocks this is the block index.
+				 */
+				GLuint index;
+				/**
+				 *	The location of a uniform or attribute, -1 for
+				 *	uniforms within blocks and for other resources.
+				 */
+				GLint location;
+				/**
+				 *	The type of a variable, 0 for blocks.
+				 */
+				GLenum type;
+				/**
+				 *	The number of elements of an array variable, 1
+				 *	otherwise.
+				 */
+				GLint array_size;
+				/**
+				 *	The index of the block which contains a variable,
+				 *	-1 if the variable is not in a block.
+				 */
+				GLint block_index;
+				/**
+				 *	The offset in bytes of a variable within its
+				 *	block, -1 if the variable is not in a block.
+				 */
+				GLint offset;
+				/**
+				 *	The buffer binding point of a block, -1 otherwise.
+				 */
+				GLint binding;
+				/**
+				 *	The minimum size in bytes of the buffer backing a
+				 *	block, 0 otherwise.
+				 */
+				GLint data_size;
+			
+			
+		};
+		
+		
+		/**
+		 *	The active resources of a linked program, stored in
+		 *	flat hash tables so that looking them up requires no
+		 *	calls into OpenGL.
+		 *
+		 *	Arrays may be looked up both as "name" and as "name[0]".
+		 *
+		 *	Storage blocks and buffer variables are only reflected
+		 *	when ARB_program_interface_query is supported.
+		 */
+		class program_reflection {
+			
+			
+			private:
+			
+			
+				class table {
+					
+					
+					private:
+					
+					
+						class slot {
+							
+							
+							public:
+							
+							
+								std::uint64_t hash;
+								std::uint32_t name;
+								std::uint32_t length;
+								bool used;
+								program_resource resource;
+							
+							
+						};
+						
+						
+						std::vector<slot> slots_;
+						std::string names_;
+						std::size_t size_;
+						
+						
+						void place (const slot &) noexcept;
+					
+					
+					public:
+					
+					
+						table () noexcept;
+						
+						
+						void insert (const resource_name & name, const program_resource & resource);
+						const program_resource * find (const resource_name & name) const noexcept;
+						void for_each (const std::function<void (const resource_name &, const program_resource &)> & func) const;
+						std::size_t size () const noexcept;
+						void clear () noexcept;
+					
+					
+				};
 				
 				
-				program ();
-				program (program && other) noexcept;
-				program & operator = (program && other) noexcept;
+				table uniforms_;
+				table attributes_;
+				table uniform_blocks_;
+				table storage_blocks_;
+				table buffer_variables_;
+			
+			
+			public:
+			
+			
+				/**
+				 *	Replaces the contents of this object with the
+				 *	active resources of a program.
+				 *
+				 *	\param [in] p
+				 *		The handle of a successfully linked program.
+				 */
+				void reflect (GLuint p);
+				/**
+				 *	Removes all resources.
+				 */
+				void clear () noexcept;
 				
 				
-				~program () noexcept;
+				/**
+				 *	Looks up an active resource.
+				 *
+				 *	\param [in] name
+				 *		The name of the resource.
+				 *
+				 *	\return
+				 *		A pointer to a description of the resource if
+				 *		it is active, \em nullptr otherwise.
+				 */
+				const program_resource * uniform (const resource_name & name) const noexcept;
+				const program_resource * attribute (const resource_name & name) const noexcept;
+				const program_resource * uniform_block (const resource_name & name) const noexcept;
+				const program_resource * storage_block (const resource_name & name) const noexcept;
+				const program_resource * buffer_variable (const resource_name & name) const noexcept;
 				
 				
 				/**
-				 *	Retrieves a handle which may be passed to OpenGL
-				 *	C functions to reference this program.
+				 *	Invokes a function for each active uniform.
 				 *
-				 *	\return
-				 *		An integer.
+				 *	Since arrays are available under two names the
+				 *	function is invoked twice for each array.
+				 *
+				 *	\param [in] func
+				 *		The function to invoke with the name and the
+				 *		description of each uniform.
 				 */
-				operator GLuint () const noexcept;
+				void for_each_uniform (const std::function<void (const resource_name &, const program_resource &)> & func) const;
+				/**
+				 *	Invokes a function for each active attribute.
+				 *
+				 *	Since arrays are available under two names the
+				 *	function is invoked twice for each array.
+				 *
+				 *	\param [in] func
+				 *		The function to invoke with the name and the
+				 *		description of each attribute.
+				 */
+				void for_each_attribute (const std::function<void (const resource_name &, const program_resource &)> & func) const;
+			
+			
+		};
+		
+		
+		/**
+		 *	A CPU side copy of the values of the uniforms in the
+		 *	default block of a program, used to skip uploads which
+		 *	would not change anything.
+		 *
+		 *	Values which were set other than through the shadow
+		 *	(e.g. by calling glUniform directly) are not tracked,
+		 *	invalidate must be called after doing so.
+		 */
+		class uniform_shadow {
+			
+			
+			private:
+			
+			
+				class slot {
+					
+					
+					public:
+					
+					
+						std::uint32_t offset;
+						std::uint32_t element;
+						std::uint32_t size;
+						std::uint32_t remaining;
+					
+					
+				};
+				
+				
+				std::vector<slot> slots_;
+				std::vector<unsigned char> data_;
+				std::vector<unsigned char> valid_;
+				std::size_t issued_;
+				std::size_t skipped_;
+			
+			
+			public:
+			
+			
+				uniform_shadow () noexcept;
 				
 				
 				/**
-				 *	Attaches a shader to this program.
+				 *	Sizes the shadow for a program.  All values start
+				 *	out unknown, so the first upload to each uniform is
+				 *	always issued.
 				 *
-				 *	\param [in] s
-				 *		The s to attach.
+				 *	\param [in] p
+				 *		The handle of a linked program.
+				 *	\param [in] reflection
+				 *		The reflection of \em p.
 				 */
-				void attach (const shader & s);
+				void reset (GLuint p, const program_reflection & reflection);
+				/**
+				 *	Forgets every value so that the next upload to each
+				 *	uniform is issued.
+				 */
+				void invalidate () noexcept;
+				/**
+				 *	Records an upload.
+				 *
+				 *	\param [in] location
+				 *		The location being uploaded to.
+				 *	\param [in] data
+				 *		The values being uploaded.
+				 *	\param [in] bytes
+				 *		The size of \em data in bytes.
+				 *
+				 *	\return
+				 *		\em true if the upload must be issued, \em false
+				 *		if it would not change anything.
+				 */
+				bool update (GLint location, const void * data, std::size_t bytes) noexcept;
 				
 				
 				/**
-				 *	Links the program.
+				 *	Retrieves the number of uploads which were issued.
+				 *
+				 *	\return
+				 *		An integer.
 				 */
-				void link ();
+				std::size_t issued () const noexcept;
+				/**
+				 *	Retrieves the number of uploads which were skipped.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t skipped () const noexcept;
+			
+			
+		};
+		
+		
+		/**
+		 *	Encapsulates an OpenGL shader program.
+		 */
+		class program {
+			
+			
+			private:
+			
+			
+				GLuint handle_;
+				program_reflection reflection_;
+				uniform_shadow shadow_;
+				
+				
+				void destroy () noexcept;
+				template <typename Separate, typename Current>
+				void upload (GLint, const void *, std::size_t, Separate, Current);
+				
+				
+				explicit program (GLuint handle) noexcept;
+				
+				
+			public:
+			
+			
+				program (const program &) = delete;
+				program & operator = (const program &) = delete;
+				
+				
+				program ();
+				program (program && other) noexcept;
+				program & operator = (program && other) noexcept;
+				
+				
+				~program () noexcept;
+				
+				
+				/**
+				 *	Compiles a single stage and links it into a
+				 *	separable program in one step, in the manner of
+				 *	glCreateShaderProgramv.
+				 *
+				 *	Separable programs may be combined with separable
+				 *	programs for other stages through a program_pipeline
+				 *	without being linked together.  Requires
+				 *	ARB_separate_shader_objects.
+				 *
+				 *	\param [in] type
+				 *		The type of shader (e.g. GL_VERTEX_SHADER).
+				 *	\param [in] src
+				 *		The source code of the shader.
+				 *
+				 *	
+eturn
+				 *		A linked program.
+				 */
+				static program separable (GLenum type, const std::string & src);
+				
+				
+				/**
+				 *	Sets whether this program may be bound to individual
+				 *	stages of a program_pipeline.  Takes effect the next
+				 *	time the program is linked.
+				 *
+				 *	\param [in] separable
+				 *		\em true if the program is separable, \em false
+				 *		otherwise.
+				 */
+				void set_separable (bool separable);
+				
+				
+				/**
+				 *	Retrieves a handle which may be passed to OpenGL
+				 *	C functions to reference this program.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				operator GLuint () const noexcept;
+				
+				
+				/**
+				 *	Attaches a shader to this program.
+				 *
+				 *	\param [in] s
+				 *		The s to attach.
+				 */
+				void attach (const shader & s);
+				
+				
+				/**
+				 *	Links the program.
+				 */
+				void link ();
+				/**
+				 *	Begins linking the program without waiting for the
+				 *	result.  Link errors are not reported until check is
+				 *	called.
+				 */
+				void link_async ();
+				/**
+				 *	Determines whether the implementation has finished
+				 *	linking this program, i.e. whether check may be
+				 *	called without blocking.
+				 *
+				 *	Without KHR_parallel_shader_compile there is no
+				 *	way to ask and this always returns \em true.
+				 *
+				 *	\return
+				 *		\em true if linking has finished, \em false
+				 *		otherwise.
+				 */
+				bool completed () const;
+				/**
+				 *	Waits for linking to finish and throws if it
+				 *	failed.  On success the active resources of the
+				 *	program are reflected.
+				 */
+				void check ();
+				/**
+				 *	Retrieves the active resources of this program as
+				 *	reflected when it was linked.
+				 *
+				 *	\return
+				 *		A reference to the reflection.
+				 */
+				const program_reflection & reflection () const noexcept;
+				
+				
+				/**
+				 *	A scope guard which uninstalls the current program
+				 *	when destroyed.
+				 */
+				class guard {
+					
+					
+					private:
+					
+					
+						optional<GLuint> old_;
+						
+						
+						void destroy () noexcept;
+						void move (guard &&) noexcept;
+						
+						
+					public:
+					
+					
+						guard (const guard &) = delete;
+						guard & operator = (const guard &) = delete;
+						guard & operator = (guard &&) = delete;
+						
+						
+						/**
+						 *	Saves the current program.
+						 */
+						guard ();
+						/**
+						 *	Moves from a guard object.  After this constructor
+						 *	completes the newly constructed guard will guard the
+						 *	current scope and the moved from guard will no longer
+						 *	be engaged (i.e. the moved from scope will no longer
+						 *	be guarded).
+						 *
+						 *	\param [in] other
+						 *		The guard to move from.
+						 */
+						guard (guard && other) noexcept;
+						
+						
+						/**
+						 *	Restores the saved program.
+						 */
+						~guard () noexcept;
+					
+					
+				};
+				
+				
+				/**
+				 *	Sets this program to be the current program.
+				 *
+				 *	The program which was current when this function
+				 *	was invoked will be saved and a guard which will
+				 *	restore it when it goes out of scope is returned.
+				 *
+				 *	Be sure to save the return value of this function
+				 *	in a local variable or the program which was current
+				 *	when this function was invoked will be restored
+				 *	immediately.
+				 *
+				 *	\return
+				 *		A guard which will restore the previously
+				 *		current program when it goes out of scope.
+				 */
+				guard use () const;
+				
+				
+				/**
+				 *	Obtains a handle which may be passed to OpenGL to
+				 *	refer to the location of an attribute within this
+				 *	program.
+				 *
+				 *	Names are looked up in the reflection gathered when
+				 *	the program was linked, OpenGL is only queried for
+				 *	names which are not found there.
+				 *
+				 *	\param [in] name
+				 *		A string giving the name of the attribute.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				GLint attribute_location (const char * name) const;
+				GLint attribute_location (const std::string & name) const;
+				GLint attribute_location (const resource_name & name) const;
+				
+				
+				/**
+				 *	Obtains a handle which may be passed to OpenGL to refer
+				 *	to the location of a uniform variable within this
+				 *	program.
+				 *
+				 *	Names are looked up in the reflection gathered when
+				 *	the program was linked, OpenGL is only queried for
+				 *	names which are not found there (e.g. elements of
+				 *	arrays other than the first).
+				 *
+				 *	\param [in] name
+				 *		A string giving the name of the uniform variable.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				GLint uniform_location (const char * name) const;
+				GLint uniform_location (const std::string & name) const;
+				GLint uniform_location (const resource_name & name) const;
+				
+				
+				/**
+				 *	Sets the value of a uniform variable in the default
+				 *	block of this program.
+				 *
+				 *	The value is compared against the uniform's shadow
+				 *	and is only uploaded if it changed.  Uploads use
+				 *	ARB_separate_shader_objects where available and
+				 *	therefore do not require the program to be current.
+				 *
+				 *	\param [in] location
+				 *		The location of the uniform.
+				 *	\param [in] x
+				 *		The value.
+				 */
+				void set_uniform (GLint location, GLfloat x);
+				void set_uniform (GLint location, GLint x);
+				void set_uniform (GLint location, GLuint x);
+				/**
+				 *	Sets the values of a uniform variable in the default
+				 *	block of this program which is a vector or an array.
+				 *
+				 *	See set_uniform.
+				 *
+				 *	\param [in] location
+				 *		The location of the uniform.
+				 *	\param [in] components
+				 *		The number of components in each vector, between
+				 *		1 and 4.
+				 *	\param [in] count
+				 *		The number of vectors.
+				 *	\param [in] v
+				 *		The values.
+				 */
+				void set_uniform_vector (GLint location, GLsizei components, GLsizei count, const GLfloat * v);
+				void set_uniform_vector (GLint location, GLsizei components, GLsizei count, const GLint * v);
+				void set_uniform_vector (GLint location, GLsizei components, GLsizei count, const GLuint * v);
+				/**
+				 *	Sets the values of a uniform variable in the default
+				 *	block of this program which is a matrix or an array
+				 *	of matrices.
+				 *
+				 *	See set_uniform.
+				 *
+				 *	\param [in] location
+				 *		The location of the uniform.
+				 *	\param [in] columns
+				 *		The number of columns in each matrix, between 2
+				 *		and 4.
+				 *	\param [in] rows
+				 *		The number of rows in each matrix, between 2 and
+				 *		4.
+				 *	\param [in] count
+				 *		The number of matrices.
+				 *	\param [in] transpose
+				 *		Whether \em v is in row major order.
+				 *	\param [in] v
+				 *		The values.
+				 */
+				void set_uniform_matrix (GLint location, GLsizei columns, GLsizei rows, GLsizei count, GLboolean transpose, const GLfloat * v);
+				
+				
+				/**
+				 *	Retrieves the shadow of the uniform values of this
+				 *	program, which counts the uploads which were issued
+				 *	and skipped.
+				 *
+				 *	\return
+				 *		A reference to the shadow.
+				 */
+				const uniform_shadow & shadow () const noexcept;
+				uniform_shadow & shadow () noexcept;
+			
+			
+		};
+		
+		
+		/**
+		 *	Encapsulates an OpenGL program pipeline object, which
+		 *	combines the stages of separable programs.
+		 *
+		 *	Requires ARB_separate_shader_objects.
+		 */
+		class program_pipeline {
+			
+			
+			private:
+			
+			
+				GLuint handle_;
+				
+				
+				void destroy () noexcept;
+				
+				
+			public:
+			
+			
+				program_pipeline (const program_pipeline &) = delete;
+				program_pipeline & operator = (const program_pipeline &) = delete;
+				
+				
+				program_pipeline ();
+				program_pipeline (program_pipeline &&) noexcept;
+				program_pipeline & operator = (program_pipeline &&) noexcept;
+				
+				
+				~program_pipeline () noexcept;
+				
+				
+				/**
+				 *	Retrieves a handle which may be passed to OpenGL
+				 *	C functions to reference this pipeline.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				operator GLuint () const noexcept;
+				
+				
+				/**
+				 *	Uses the executables a separable program contains
+				 *	for certain stages of this pipeline.
+				 *
+				 *	\param [in] stages
+				 *		A bitmask of stages (e.g. GL_VERTEX_SHADER_BIT).
+				 *	\param [in] p
+				 *		The program, which must have been linked as
+				 *		separable.
+				 */
+				void use_stages (GLbitfield stages, const program & p);
+				/**
+				 *	Stops using any executable for certain stages of
+				 *	this pipeline.
+				 *
+				 *	\param [in] stages
+				 *		A bitmask of stages.
+				 */
+				void clear_stages (GLbitfield stages);
+				/**
+				 *	Sets the program which glUniform calls affect while
+				 *	this pipeline is bound.
+				 *
+				 *	\param [in] p
+				 *		The program.
+				 */
+				void active_program (const program & p);
+				
+				
+				/**
+				 *	Validates this pipeline against the current state
+				 *	and throws if it could not execute, e.g. because the
+				 *	interfaces between its stages do not match.
+				 */
+				void validate () const;
+				
+				
+				/**
+				 *	A scope guard which restores the current program
+				 *	and program pipeline when destroyed.
+				 */
+				class guard {
+					
+					
+					private:
+					
+					
+						class details {
+							
+							
+							public:
+							
+							
+								GLuint program;
+								GLuint pipeline;
+							
+							
+						};
+						
+						
+						optional<details> d_;
+						
+						
+						void destroy () noexcept;
+						
+						
+					public:
+					
+					
+						guard (const guard &) = delete;
+						guard & operator = (const guard &) = delete;
+						guard & operator = (guard &&) = delete;
+						
+						
+						/**
+						 *	Saves the current program and program pipeline.
+						 */
+						guard ();
+						guard (guard &&) noexcept;
+						
+						
+						/**
+						 *	Restores the saved program and program pipeline.
+						 */
+						~guard () noexcept;
+					
+					
+				};
+				
+				
+				/**
+				 *	Binds this pipeline so that it is used for
+				 *	rendering.
+				 *
+				 *	Since a program installed by glUseProgram takes
+				 *	precedence over the bound pipeline the current
+				 *	program is uninstalled.  Both are restored by the
+				 *	returned guard, so be sure to save it in a local
+				 *	variable.
+				 *
+				 *	\return
+				 *		A guard which will restore the previously
+				 *		current program and program pipeline when it
+				 *		goes out of scope.
+				 */
+				guard use () const;
+			
+			
+		};
+		
+		
+		/**
+		 *	A separable program and the stages of a pipeline
+		 *	it should be used for.
+		 */
+		class pipeline_stage {
+			
+			
+			public:
+			
+			
+				/**
+				 *	A bitmask of stages (e.g. GL_VERTEX_SHADER_BIT).
+				 */
+				GLbitfield stages;
+				std::shared_ptr<const program> p;
+			
+			
+		};
+		
+		
+		/**
+		 *	Creates program pipelines on demand such that every
+		 *	distinct combination of separable programs shares a
+		 *	single pipeline object.
+		 *
+		 *	This allows N vertex and M fragment programs to be
+		 *	compiled N+M times rather than linked N×M times.
+		 *
+		 *	Programs are only weakly referenced: a pipeline
+		 *	referring to a program which no longer exists is
+		 *	recreated if requested again and freed by prune.
+		 */
+		class pipeline_cache {
+			
+			
+			private:
+			
+			
+				using key_type=std::vector<std::pair<GLbitfield,GLuint>>;
+				
+				
+				class hasher {
+					
+					
+					public:
+					
+					
+						std::size_t operator () (const key_type & key) const noexcept;
+					
+					
+				};
+				
+				
+				class entry {
+					
+					
+					public:
+					
+					
+						program_pipeline pipeline;
+						std::vector<std::weak_ptr<const program>> programs;
+						
+						
+						bool expired () const noexcept;
+					
+					
+				};
+				
+				
+				std::unordered_map<key_type,entry,hasher> map_;
+				std::size_t created_;
+				
+				
+				static entry make_entry (const std::vector<pipeline_stage> & stages);
+			
+			
+			public:
+			
+			
+				pipeline_cache () noexcept;
+				
+				
+				/**
+				 *	Retrieves the pipeline for a combination of
+				 *	separable programs, creating it if necessary.
+				 *
+				 *	\param [in] stages
+				 *		The programs and the stages they should be
+				 *		used for.  Order is significant only insofar
+				 *		as later entries override the stages of
+				 *		earlier ones.
+				 *
+				 *	\return
+				 *		A reference to the pipeline, which remains
+				 *		valid until prune or clear is called, or until
+				 *		one of \em stages is destroyed.
+				 */
+				const program_pipeline & get (const std::vector<pipeline_stage> & stages);
+				
+				
+				/**
+				 *	Frees every pipeline which refers to a program
+				 *	which no longer exists.
+				 */
+				void prune () noexcept;
+				/**
+				 *	Frees every pipeline.
+				 */
+				void clear () noexcept;
+				
+				
+				/**
+				 *	Retrieves the number of pipelines held.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t size () const noexcept;
+				/**
+				 *	Retrieves the number of pipelines which have been
+				 *	created, which is the number of cache misses.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t created () const noexcept;
+			
+			
+		};
+		
+		
+		/**
+		 *	Encapsulates an OpenGL buffer object.
+		 */
+		class buffer {
+			
+			
+			private:
+			
+			
+				GLuint handle_;
+				
+				
+				void destroy () noexcept;
+				
+				
+			public:
+			
+			
+				buffer (const buffer &) = delete;
+				buffer & operator = (const buffer &) = delete;
+				
+				
+				buffer ();
+				buffer (buffer &&) noexcept;
+				buffer & operator = (buffer &&) noexcept;
+				
+				
+				~buffer () noexcept;
+				
+				
+				/**
+				 *	Retrieves a handle which may be used to refer
+				 *	to this buffer when calling OpenGL C functions.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				operator GLuint () const noexcept;
+				
+				
+				
+				/**
+				 *	Determines the parameter which may be passed to
+				 *	glGet* to retrieve the buffer bound to a certain
+				 *	target.
+				 *
+				 *	\param [in] type
+				 *		The target.
+				 *
+				 *	\return
+				 *		The binding parameter corresponding to \em type.
+				 */
+				static GLenum binding (GLenum type);
+				
+				
+				class guard {
+					
+					
+					private:
+					
+					
+						class details {
+							
+							
+							public:
+							
+							
+								GLuint handle;
+								GLenum type;
+							
+							
+						};
+						
+						
+						optional<details> d_;
+						
+						
+						void destroy () noexcept;
+						
+						
+					public:
+					
+					
+						guard () = delete;
+						guard (const guard &) = delete;
+						guard & operator = (const guard &) = delete;
+						guard & operator = (guard &&) = delete;
+						
+						
+						explicit guard (GLenum);
+						guard (guard &&) noexcept;
+						
+						
+						~guard () noexcept;
+					
+					
+				};
+				
+				
+				/**
+				 *	Binds this buffer object.
+				 *
+				 *	Care must be taken to store the return value of this
+				 *	function or the binding will be immediately reverted.
+				 *
+				 *	\param [in] type
+				 *		The target to which this buffer shall be
+				 *		bound.
+				 *
+				 *	\return
+				 *		An object which shall revert this binding (restoring
+				 *		the previous binding) when it goes out of scope.
+				 */
+				guard bind (GLenum type) const;
+				
+				
+				/**
+				 *	Represents the data store of a buffer object
+				 *	mapped into client memory.
+				 *
+				 *	While a mapping exists the buffer remains bound
+				 *	to the target through which it was mapped, when
+				 *	the mapping's lifetime ends the buffer is unmapped
+				 *	and the previous binding is restored.
+				 */
+				class mapping {
+					
+					
+					private:
+					
+					
+						guard guard_;
+						GLenum type_;
+						void * ptr_;
+						
+						
+						void destroy () noexcept;
+					
+					
+					public:
+					
+					
+						mapping () = delete;
+						mapping (const mapping &) = delete;
+						mapping & operator = (const mapping &) = delete;
+						mapping & operator = (mapping &&) = delete;
+						
+						
+						mapping (guard g, GLenum type, void * ptr) noexcept;
+						mapping (mapping &&) noexcept;
+						
+						
+						/**
+						 *	Calls glUnmapBuffer.
+						 *
+						 *	Any error glUnmapBuffer reports (for example
+						 *	the data store becoming corrupt while mapped)
+						 *	is ignored since this function cannot throw.
+						 */
+						~mapping () noexcept;
+						
+						
+						/**
+						 *	Retrieves a pointer to the mapped range.
+						 *
+						 *	\return
+						 *		A pointer.
+						 */
+						void * get () const noexcept;
+					
+					
+				};
+				
+				
+				/**
+				 *	Maps a range of this buffer's data store into client
+				 *	memory by calling glMapBufferRange.
+				 *
+				 *	This allows data to be produced directly into memory
+				 *	OpenGL will read from (for example converting pixels
+				 *	into a buffer bound to GL_PIXEL_UNPACK_BUFFER) rather
+				 *	than producing it in client memory and copying it.
+				 *
+				 *	Care must be taken to store the return value of this
+				 *	function or the buffer will immediately be unmapped.
+				 *
+				 *	\param [in] type
+				 *		The target to which this buffer shall be bound
+				 *		while mapped.
+				 *	\param [in] offset
+				 *		The offset in bytes of the range to map.
+				 *	\param [in] length
+				 *		The length in bytes of the range to map.
+				 *	\param [in] access
+				 *		The \em access parameter to glMapBufferRange.
+				 *
+				 *	\return
+				 *		An object which provides access to the mapped
+				 *		range and which will unmap it when it goes out
+				 *		of scope.
+				 */
+				mapping map (GLenum type, GLintptr offset, GLsizeiptr length, GLbitfield access) const;
+			
+			
+		};
+		
+		
+		/**
+		 *	Encapsulates an OpenGL texture name.
+		 */
+		class texture {
+			
+			
+			private:
+			
+			
+				GLuint handle_;
+				mutable std::uint64_t last_bound_;
+				
+				
+				void destroy () noexcept;
+				
+				
+			public:
+			
+			
+				texture (const texture &) = delete;
+				texture & operator = (const texture &) = delete;
+				
+				
+				texture ();
+				texture (texture &&) noexcept;
+				texture & operator = (texture &&) noexcept;
+				
+				
+				~texture () noexcept;
+				
+				
+				/**
+				 *	Returns a handle which may be used to refer
+				 *	to this texture when calling OpenGL C functions.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				operator GLuint () const noexcept;
+				
+				
+				
+				/**
+				 *	Determines the parameter which may be passed to
+				 *	glGet* to retrieve the texture bound to a certain
+				 *	target of the active texture unit.
+				 *
+				 *	\param [in] type
+				 *		The target.
+				 *
+				 *	\return
+				 *		The binding parameter corresponding to \em type.
+				 */
+				static GLenum binding (GLenum type);
 				
 				
-				/**
-				 *	A scope guard which uninstalls the current program
-				 *	when destroyed.
-				 */
 				class guard {
 					
 					
 					private:
 					
 					
-						optional<GLuint> old_;
+						class details {
+							
+							
+							public:
+							
+							
+								GLuint handle;
+								GLenum type;
+							
+							
+						};
+						
+						
+						optional<details> d_;
 						
 						
 						void destroy () noexcept;
-						void move (guard &&) noexcept;
 						
 						
 					public:
 					
 					
+						guard () = delete;
 						guard (const guard &) = delete;
 						guard & operator = (const guard &) = delete;
 						guard & operator = (guard &&) = delete;
 						
 						
-						/**
-						 *	Saves the current program.
-						 */
-						guard ();
-						/**
-						 *	Moves from a guard object.  After this constructor
-						 *	completes the newly constructed guard will guard the
-						 *	current scope and the moved from guard will no longer
-						 *	be engaged (i.e. the moved from scope will no longer
-						 *	be guarded).
-						 *
-						 *	\param [in] other
-						 *		The guard to move from.
-						 */
-						guard (guard && other) noexcept;
+						explicit guard (GLenum);
+						guard (guard &&) noexcept;
 						
 						
-						/**
-						 *	Restores the saved program.
-						 */
 						~guard () noexcept;
 					
 					
@@ -356,61 +1670,57 @@ namespace gl_utilities {
 				
 				
 				/**
-				 *	Sets this program to be the current program.
+				 *	Binds this texture.
 				 *
-				 *	The program which was current when this function
-				 *	was invoked will be saved and a guard which will
-				 *	restore it when it goes out of scope is returned.
+				 *	Care must be taken to store the return value of this
+				 *	function or the binding will immediately be reverted.
 				 *
-				 *	Be sure to save the return value of this function
-				 *	in a local variable or the program which was current
-				 *	when this function was invoked will be restored
-				 *	immediately.
+				 *	\param [in] type
+				 *		The type of texture as which to bind this texture.
 				 *
 				 *	\return
-				 *		A guard which will restore the previously
-				 *		current program when it goes out of scope.
+				 *		A guard object which will revert the binding of type
+				 *		\em type to its previous value when it goes out of scope.
 				 */
-				guard use () const;
+				guard bind (GLenum type) const;
 				
 				
 				/**
-				 *	Obtains a handle which may be passed to OpenGL to
-				 *	refer to the location of an attribute within this
-				 *	program.
+				 *	Retrieves a timestamp recording when this texture
+				 *	was last bound through bind.
 				 *
-				 *	\param [in] name
-				 *		A string giving the name of the attribute.
+				 *	Timestamps are drawn from a single counter shared by
+				 *	all textures, therefore they are only meaningful
+				 *	relative to one another.
 				 *
 				 *	\return
-				 *		An integer.
+				 *		An integer which is greater for more recently
+				 *		bound textures.  Zero if this texture has never
+				 *		been bound.
 				 */
-				GLint attribute_location (const char * name) const;
-				GLint attribute_location (const std::string & name) const;
-				
-				
+				std::uint64_t last_bound () const noexcept;
 				/**
-				 *	Obtains a handle which may be passed to OpenGL to refer
-				 *	to the location of a uniform variable within this
-				 *	program.
+				 *	Sets the timestamp returned by last_bound.
 				 *
-				 *	\param [in] name
-				 *		A string giving the name of the uniform variable.
+				 *	Intended for textures which replace another, so
+				 *	that the replacement inherits the place of the
+				 *	original in the order of use rather than appearing
+				 *	to have just been bound.
 				 *
-				 *	\return
-				 *		An integer.
+				 *	\param [in] stamp
+				 *		The timestamp, typically the return value of
+				 *		last_bound on the texture being replaced.
 				 */
-				GLint uniform_location (const char * name) const;
-				GLint uniform_location (const std::string & name) const;
+				void last_bound (std::uint64_t stamp) noexcept;
 			
 			
 		};
 		
 		
 		/**
-		 *	Encapsulates an OpenGL buffer object.
+		 *	Encapsulates an OpenGL vertex array name.
 		 */
-		class buffer {
+		class vertex_array {
 			
 			
 			private:
@@ -425,21 +1735,21 @@ namespace gl_utilities {
 			public:
 			
 			
-				buffer (const buffer &) = delete;
-				buffer & operator = (const buffer &) = delete;
+				vertex_array (const vertex_array &) = delete;
+				vertex_array & operator = (const vertex_array &) = delete;
 				
 				
-				buffer ();
-				buffer (buffer &&) noexcept;
-				buffer & operator = (buffer &&) noexcept;
+				vertex_array ();
+				vertex_array (vertex_array &&) noexcept;
+				vertex_array & operator = (vertex_array &&) noexcept;
 				
 				
-				~buffer () noexcept;
+				~vertex_array () noexcept;
 				
 				
 				/**
-				 *	Retrieves a handle which may be used to refer
-				 *	to this buffer when calling OpenGL C functions.
+				 *	Retrieves a handle which may be used to represent
+				 *	this vertex array when calling OpenGL C functions.
 				 *
 				 *	\return
 				 *		An integer.
@@ -453,20 +1763,7 @@ namespace gl_utilities {
 					private:
 					
 					
-						class details {
-							
-							
-							public:
-							
-							
-								GLuint handle;
-								GLenum type;
-							
-							
-						};
-						
-						
-						optional<details> d_;
+						optional<GLuint> handle_;
 						
 						
 						void destroy () noexcept;
@@ -475,13 +1772,12 @@ namespace gl_utilities {
 					public:
 					
 					
-						guard () = delete;
 						guard (const guard &) = delete;
 						guard & operator = (const guard &) = delete;
 						guard & operator = (guard &&) = delete;
 						
 						
-						explicit guard (GLenum);
+						guard ();
 						guard (guard &&) noexcept;
 						
 						
@@ -492,29 +1788,163 @@ namespace gl_utilities {
 				
 				
 				/**
-				 *	Binds this buffer object.
+				 *	Binds this vertex array.
 				 *
-				 *	Care must be taken to store the return value of this
-				 *	function or the binding will be immediately reverted.
+				 *	Be sure to save the return value of this method in
+				 *	a variable or the binding will be immediately undone.
+				 *
+				 *	\return
+				 *		An object which will reverse the binding (restoring
+				 *		the binding which was current when this method was
+				 *		invoked) when it goes out of scope.
+				 */
+				guard bind () const;
+				
+				
+				/**
+				 *	Specifies the format of an attribute independently
+				 *	of the buffer it is read from, which is given by
+				 *	the binding point the attribute is associated with.
+				 *
+				 *	This and the other functions which separate formats
+				 *	from buffers require ARB_vertex_attrib_binding.
+				 *	They bind this vertex array for the duration of
+				 *	the call.
 				 *
+				 *	\param [in] location
+				 *		The location of the attribute.
+				 *	\param [in] count
+				 *		The number of components, between 1 and 4.
 				 *	\param [in] type
-				 *		The target to which this buffer shall be
-				 *		bound.
+				 *		The type of each component.
+				 *	\param [in] normalized
+				 *		Whether integers are normalized when converted
+				 *		to floating point.
+				 *	\param [in] relative_offset
+				 *		The offset of the attribute within a vertex.
+				 */
+				void attribute_format (GLuint location, GLint count, GLenum type, GLboolean normalized, GLuint relative_offset);
+				/**
+				 *	Specifies the format of an attribute which is
+				 *	presented to the shader as integers.
 				 *
-				 *	\return
-				 *		An object which shall revert this binding (restoring
-				 *		the previous binding) when it goes out of scope.
+				 *	See attribute_format.
+				 *
+				 *	\param [in] location
+				 *		The location of the attribute.
+				 *	\param [in] count
+				 *		The number of components, between 1 and 4.
+				 *	\param [in] type
+				 *		The type of each component.
+				 *	\param [in] relative_offset
+				 *		The offset of the attribute within a vertex.
 				 */
-				guard bind (GLenum type) const;
+				void attribute_integer_format (GLuint location, GLint count, GLenum type, GLuint relative_offset);
+				/**
+				 *	Associates an attribute with a binding point.
+				 *
+				 *	\param [in] location
+				 *		The location of the attribute.
+				 *	\param [in] binding
+				 *		The index of the binding point.
+				 */
+				void attribute_binding (GLuint location, GLuint binding);
+				/**
+				 *	Enables an attribute so that it is read from a
+				 *	buffer rather than taking the current generic
+				 *	attribute value.
+				 *
+				 *	\param [in] location
+				 *		The location of the attribute.
+				 */
+				void enable_attribute (GLuint location);
+				/**
+				 *	Binds a buffer to a binding point, all attributes
+				 *	associated with the binding point are read from it.
+				 *
+				 *	\param [in] binding
+				 *		The index of the binding point.
+				 *	\param [in] b
+				 *		The buffer.
+				 *	\param [in] offset
+				 *		The offset of the first vertex within \em b.
+				 *	\param [in] stride
+				 *		The number of bytes between consecutive
+				 *		vertices.
+				 */
+				void vertex_buffer (GLuint binding, const buffer & b, GLintptr offset, GLsizei stride);
+				/**
+				 *	Sets the rate at which attributes associated with a
+				 *	binding point advance during instanced draws.
+				 *
+				 *	\param [in] binding
+				 *		The index of the binding point.
+				 *	\param [in] divisor
+				 *		The number of instances per element, or 0 to
+				 *		advance once per vertex.
+				 */
+				void binding_divisor (GLuint binding, GLuint divisor);
+				/**
+				 *	Sets the buffer indices are read from.
+				 *
+				 *	\param [in] b
+				 *		The buffer.
+				 */
+				void element_buffer (const buffer & b);
+			
+			
+		};
+		
+		
+		class active_texture_guard {
+			
+			
+			private:
+			
+			
+				optional<GLenum> handle_;
+				
+				
+				void destroy () noexcept;
+				
+				
+			public:
+			
+			
+				active_texture_guard (const active_texture_guard &) = delete;
+				active_texture_guard & operator = (const active_texture_guard &) = delete;
+				
+				
+				active_texture_guard ();
+				active_texture_guard (active_texture_guard &&) noexcept;
+				
+				
+				~active_texture_guard () noexcept;
 			
 			
 		};
 		
 		
 		/**
-		 *	Encapsulates an OpenGL texture name.
+		 *	Selects an active texture unit.
+		 *
+		 *	\param [in] num
+		 *		The number of the active texture unit to
+		 *		activate.  The number of such units is
+		 *		implementation defined.
+		 *
+		 *	\return
+		 *		An object which will restore the texture unit
+		 *		active when this function was called when it goes
+		 *		out of scope.
 		 */
-		class texture {
+		active_texture_guard active_texture (unsigned num);
+		
+		
+		/**
+		 *	Encapsulates an OpenGL frame buffer object name.
+		 */
+		class frame_buffer {
 			
 			
 			private:
@@ -529,21 +1959,21 @@ namespace gl_utilities {
 			public:
 			
 			
-				texture (const texture &) = delete;
-				texture & operator = (const texture &) = delete;
+				frame_buffer (const frame_buffer &) = delete;
+				frame_buffer & operator = (const frame_buffer &) = delete;
 				
 				
-				texture ();
-				texture (texture &&) noexcept;
-				texture & operator = (texture &&) noexcept;
+				frame_buffer ();
+				frame_buffer (frame_buffer &&) noexcept;
+				frame_buffer & operator = (frame_buffer &&) noexcept;
 				
 				
-				~texture () noexcept;
+				~frame_buffer () noexcept;
 				
 				
 				/**
-				 *	Returns a handle which may be used to refer
-				 *	to this texture when calling OpenGL C functions.
+				 *	Retrieves a handle which may be passed to OpenGL
+				 *	C functions to refer to this frame buffer.
 				 *
 				 *	\return
 				 *		An integer.
@@ -563,8 +1993,8 @@ namespace gl_utilities {
 							public:
 							
 							
-								GLuint handle;
-								GLenum type;
+								optional<GLuint> read;
+								optional<GLuint> draw;
 							
 							
 						};
@@ -596,17 +2026,20 @@ namespace gl_utilities {
 				
 				
 				/**
-				 *	Binds this texture.
+				 *	Makes this frame buffer the currently active
+				 *	frame buffer on a certain frame buffer binding.
 				 *
-				 *	Care must be taken to store the return value of this
-				 *	function or the binding will immediately be reverted.
+				 *	Be sure to store the returned object in a variable
+				 *	as the binding performed by this method will be
+				 *	reversed as soon as that object goes out of scope.
 				 *
 				 *	\param [in] type
-				 *		The type of texture as which to bind this texture.
+				 *		The frame buffer binding to which this frame
+				 *		buffer shall be bound.
 				 *
 				 *	\return
-				 *		A guard object which will revert the binding of type
-				 *		\em type to its previous value when it goes out of scope.
+				 *		An object which will revert the binding when it
+				 *		goes out of scope.
 				 */
 				guard bind (GLenum type) const;
 			
@@ -615,9 +2048,9 @@ namespace gl_utilities {
 		
 		
 		/**
-		 *	Encapsulates an OpenGL vertex array name.
+		 *	Encapsulates an OpenGL render buffer name.
 		 */
-		class vertex_array {
+		class render_buffer {
 			
 			
 			private:
@@ -632,21 +2065,22 @@ namespace gl_utilities {
 			public:
 			
 			
-				vertex_array (const vertex_array &) = delete;
-				vertex_array & operator = (const vertex_array &) = delete;
-				
-				
-				vertex_array ();
-				vertex_array (vertex_array &&) noexcept;
-				vertex_array & operator = (vertex_array &&) noexcept;
+				render_buffer (const render_buffer &) = delete;
+				render_buffer & operator = (const render_buffer &) = delete;
 				
 				
-				~vertex_array () noexcept;
+				render_buffer ();
+				render_buffer (render_buffer &&) noexcept;
+				render_buffer & operator = (render_buffer &&) noexcept;
+				
+				
+				~render_buffer () noexcept;
 				
 				
 				/**
-				 *	Retrieves a handle which may be used to represent
-				 *	this vertex array when calling OpenGL C functions.
+				 *	Retrieves a handle which may be pasesd to
+				 *	OpenGL C functions to refer to this render
+				 *	buffer.
 				 *
 				 *	\return
 				 *		An integer.
@@ -685,15 +2119,17 @@ namespace gl_utilities {
 				
 				
 				/**
-				 *	Binds this vertex array.
+				 *	Binds this render buffer.
 				 *
-				 *	Be sure to save the return value of this method in
-				 *	a variable or the binding will be immediately undone.
+				 *	Be careful to store the returned value in a variable otherwise
+				 *	it will immediately go out of scope thereby restoring the
+				 *	previous binding and undoing all of the work done by this
+				 *	method.
 				 *
 				 *	\return
-				 *		An object which will reverse the binding (restoring
-				 *		the binding which was current when this method was
-				 *		invoked) when it goes out of scope.
+				 *		An object which will restore the render buffer binding
+				 *		which was current when this method was invoked when
+				 *		it goes out of scope.
 				 */
 				guard bind () const;
 			
@@ -701,55 +2137,59 @@ namespace gl_utilities {
 		};
 		
 		
-		class active_texture_guard {
-			
-			
-			private:
+		/**
+		 *	Describes the state of a sampler object.
+		 *
+		 *	Default constructed descriptions represent the initial
+		 *	state OpenGL gives sampler objects.
+		 */
+		class sampler_description {
 			
 			
-				optional<GLenum> handle_;
-				
-				
-				void destroy () noexcept;
-				
-				
 			public:
 			
 			
-				active_texture_guard (const active_texture_guard &) = delete;
-				active_texture_guard & operator = (const active_texture_guard &) = delete;
+				GLenum min_filter=GL_NEAREST_MIPMAP_LINEAR;
+				GLenum mag_filter=GL_LINEAR;
+				GLenum wrap_s=GL_REPEAT;
+				GLenum wrap_t=GL_REPEAT;
+				GLenum wrap_r=GL_REPEAT;
+				/**
+				 *	The maximum degree of anisotropy.  Only applied if
+				 *	anisotropic filtering is supported, and clamped
+				 *	between one and the greatest value the
+				 *	implementation supports.
+				 */
+				GLfloat max_anisotropy=1.0f;
+				GLfloat lod_bias=0.0f;
+				GLfloat min_lod=-1000.0f;
+				GLfloat max_lod=1000.0f;
+				GLenum compare_mode=GL_NONE;
+				GLenum compare_func=GL_LEQUAL;
+				std::array<GLfloat,4> border_color={{0.0f,0.0f,0.0f,0.0f}};
 				
 				
-				active_texture_guard ();
-				active_texture_guard (active_texture_guard &&) noexcept;
+				bool operator == (const sampler_description & other) const noexcept;
+				bool operator != (const sampler_description & other) const noexcept;
 				
 				
-				~active_texture_guard () noexcept;
+				/**
+				 *	Computes a hash of this description.
+				 *
+				 *	\return
+				 *		A hash which is equal for descriptions
+				 *		which compare equal.
+				 */
+				std::size_t hash () const noexcept;
 			
 			
 		};
 		
 		
 		/**
-		 *	Selects an active texture unit.
-		 *
-		 *	\param [in] num
-		 *		The number of the active texture unit to
-		 *		activate.  The number of such units is
-		 *		implementation defined.
-		 *
-		 *	\return
-		 *		An object which will restore the texture unit
-		 *		active when this function was called when it goes
-		 *		out of scope.
-		 */
-		active_texture_guard active_texture (unsigned num);
-		
-		
-		/**
-		 *	Encapsulates an OpenGL frame buffer object name.
+		 *	Encapsulates an OpenGL sampler object name.
 		 */
-		class frame_buffer {
+		class sampler {
 			
 			
 			private:
@@ -759,26 +2199,36 @@ namespace gl_utilities {
 				
 				
 				void destroy () noexcept;
-				
-				
+			
+			
 			public:
 			
 			
-				frame_buffer (const frame_buffer &) = delete;
-				frame_buffer & operator = (const frame_buffer &) = delete;
+				sampler (const sampler &) = delete;
+				sampler & operator = (const sampler &) = delete;
 				
 				
-				frame_buffer ();
-				frame_buffer (frame_buffer &&) noexcept;
-				frame_buffer & operator = (frame_buffer &&) noexcept;
+				sampler ();
+				sampler (sampler &&) noexcept;
+				sampler & operator = (sampler &&) noexcept;
 				
 				
-				~frame_buffer () noexcept;
+				/**
+				 *	Creates a sampler object and sets all of its
+				 *	parameters.
+				 *
+				 *	\param [in] desc
+				 *		A description of the parameters.
+				 */
+				explicit sampler (const sampler_description & desc);
+				
+				
+				~sampler () noexcept;
 				
 				
 				/**
 				 *	Retrieves a handle which may be passed to OpenGL
-				 *	C functions to refer to this frame buffer.
+				 *	C functions to refer to this sampler.
 				 *
 				 *	\return
 				 *		An integer.
@@ -786,6 +2236,15 @@ namespace gl_utilities {
 				operator GLuint () const noexcept;
 				
 				
+				/**
+				 *	Sets all the parameters of this sampler object.
+				 *
+				 *	\param [in] desc
+				 *		A description of the parameters.
+				 */
+				void set (const sampler_description & desc);
+				
+				
 				class guard {
 					
 					
@@ -798,8 +2257,8 @@ namespace gl_utilities {
 							public:
 							
 							
-								optional<GLuint> read;
-								optional<GLuint> draw;
+								GLuint unit;
+								GLuint handle;
 							
 							
 						};
@@ -809,8 +2268,8 @@ namespace gl_utilities {
 						
 						
 						void destroy () noexcept;
-						
-						
+					
+					
 					public:
 					
 					
@@ -820,7 +2279,7 @@ namespace gl_utilities {
 						guard & operator = (guard &&) = delete;
 						
 						
-						explicit guard (GLenum);
+						explicit guard (GLuint unit);
 						guard (guard &&) noexcept;
 						
 						
@@ -831,89 +2290,214 @@ namespace gl_utilities {
 				
 				
 				/**
-				 *	Makes this frame buffer the currently active
-				 *	frame buffer on a certain frame buffer binding.
+				 *	Binds this sampler to a texture unit, thereby
+				 *	overriding the sampling parameters of whichever
+				 *	texture is bound to that unit.
 				 *
-				 *	Be sure to store the returned object in a variable
-				 *	as the binding performed by this method will be
-				 *	reversed as soon as that object goes out of scope.
+				 *	Care must be taken to store the return value of this
+				 *	function or the binding will immediately be reverted.
 				 *
-				 *	\param [in] type
-				 *		The frame buffer binding to which this frame
-				 *		buffer shall be bound.
+				 *	\param [in] unit
+				 *		The number of the texture unit.
 				 *
 				 *	\return
-				 *		An object which will revert the binding when it
-				 *		goes out of scope.
+				 *		A guard object which will restore the sampler
+				 *		which was bound to \em unit when it goes out of
+				 *		scope.
 				 */
-				guard bind (GLenum type) const;
+				guard bind (GLuint unit) const;
 			
 			
 		};
 		
 		
 		/**
-		 *	Encapsulates an OpenGL render buffer name.
+		 *	Interns sampler descriptions such that all equal
+		 *	descriptions share a single sampler object.
+		 *
+		 *	The cache only holds weak references: a sampler object
+		 *	is deleted once nothing outside the cache refers to it,
+		 *	and its entry is discarded when its description is next
+		 *	requested or by prune.
 		 */
-		class render_buffer {
+		class sampler_cache {
 			
 			
 			private:
 			
 			
-				GLuint handle_;
-				
-				
-				void destroy () noexcept;
+				class hasher {
+					
+					
+					public:
+					
+					
+						std::size_t operator () (const sampler_description & desc) const noexcept;
+					
+					
+				};
 				
 				
+				std::unordered_map<sampler_description,std::weak_ptr<const sampler>,hasher> map_;
+			
+			
 			public:
 			
 			
-				render_buffer (const render_buffer &) = delete;
-				render_buffer & operator = (const render_buffer &) = delete;
-				
-				
-				render_buffer ();
-				render_buffer (render_buffer &&) noexcept;
-				render_buffer & operator = (render_buffer &&) noexcept;
-				
-				
-				~render_buffer () noexcept;
+				/**
+				 *	Retrieves the sampler object for a description,
+				 *	creating it if necessary.
+				 *
+				 *	\param [in] desc
+				 *		The description.
+				 *
+				 *	\return
+				 *		A pointer to a sampler object with the state
+				 *		\em desc describes.
+				 */
+				std::shared_ptr<const sampler> get (const sampler_description & desc);
+				/**
+				 *	Discards the entries of every sampler object which
+				 *	has been deleted.
+				 */
+				void prune () noexcept;
 				
 				
 				/**
-				 *	Retrieves a handle which may be pasesd to
-				 *	OpenGL C functions to refer to this render
-				 *	buffer.
+				 *	Retrieves the number of distinct sampler objects
+				 *	which currently exist.
 				 *
 				 *	\return
 				 *		An integer.
 				 */
-				operator GLuint () const noexcept;
+				std::size_t size () const noexcept;
+			
+			
+		};
+		
+		
+		/**
+		 *	A table of texture unit, sampler, and indexed buffer
+		 *	bindings which may be applied all at once.
+		 *
+		 *	Where ARB_multi_bind is available bindings to consecutive
+		 *	texture units and consecutive buffer binding points are
+		 *	made with a single call to glBindTextures, glBindSamplers,
+		 *	glBindBuffersRange, or glBindBuffersBase.  Otherwise they
+		 *	are made in a loop which switches the active texture unit
+		 *	only as necessary and restores it once at the end.
+		 */
+		class binding_table {
+			
+			
+			private:
+			
+			
+				class texture_entry {
+					
+					
+					public:
+					
+					
+						GLuint unit;
+						GLenum target;
+						GLuint handle;
+					
+					
+				};
+				
+				
+				class sampler_entry {
+					
+					
+					public:
+					
+					
+						GLuint unit;
+						GLuint handle;
+					
+					
+				};
+				
+				
+				class buffer_entry {
+					
+					
+					public:
+					
+					
+						GLenum target;
+						GLuint index;
+						GLuint handle;
+						//	A size of zero means the entire buffer
+						//	is bound (i.e. glBindBufferBase)
+						GLintptr offset;
+						GLsizeiptr size;
+					
+					
+				};
+				
 				
+				std::vector<texture_entry> textures_;
+				std::vector<sampler_entry> samplers_;
+				std::vector<buffer_entry> buffers_;
 				
+				
+				static void apply_textures (const std::vector<texture_entry> &);
+				static void apply_samplers (const std::vector<sampler_entry> &);
+				static void apply_buffers (const std::vector<buffer_entry> &);
+			
+			
+			public:
+			
+			
+				/**
+				 *	A scope guard which restores every binding a
+				 *	binding_table replaced.
+				 */
 				class guard {
 					
 					
 					private:
 					
 					
-						optional<GLuint> handle_;
+						class details {
+							
+							
+							public:
+							
+							
+								std::vector<texture_entry> textures;
+								std::vector<sampler_entry> samplers;
+								std::vector<buffer_entry> buffers;
+							
+							
+						};
 						
 						
-						void destroy () noexcept;
+						optional<details> d_;
 						
 						
+						void destroy () noexcept;
+					
+					
 					public:
 					
 					
+						guard () = delete;
 						guard (const guard &) = delete;
 						guard & operator = (const guard &) = delete;
 						guard & operator = (guard &&) = delete;
 						
 						
-						guard ();
+						/**
+						 *	Saves every binding which a binding table
+						 *	would replace.
+						 *
+						 *	\param [in] table
+						 *		The binding table.
+						 */
+						explicit guard (const binding_table & table);
 						guard (guard &&) noexcept;
 						
 						
@@ -924,17 +2508,90 @@ namespace gl_utilities {
 				
 				
 				/**
-				 *	Binds this render buffer.
+				 *	Adds a texture to the table.
 				 *
-				 *	Be careful to store the returned value in a variable otherwise
-				 *	it will immediately go out of scope thereby restoring the
-				 *	previous binding and undoing all of the work done by this
-				 *	method.
+				 *	\param [in] unit
+				 *		The number of the texture unit.
+				 *	\param [in] target
+				 *		The target of the texture unit to which
+				 *		\em tex shall be bound.
+				 *	\param [in] tex
+				 *		The texture.
 				 *
 				 *	\return
-				 *		An object which will restore the render buffer binding
-				 *		which was current when this method was invoked when
-				 *		it goes out of scope.
+				 *		A reference to this object.
+				 */
+				binding_table & add_texture (GLuint unit, GLenum target, const texture & tex);
+				/**
+				 *	Adds a sampler to the table.
+				 *
+				 *	\param [in] unit
+				 *		The number of the texture unit.
+				 *	\param [in] s
+				 *		The sampler.
+				 *
+				 *	\return
+				 *		A reference to this object.
+				 */
+				binding_table & add_sampler (GLuint unit, const sampler & s);
+				/**
+				 *	Adds a range of a buffer to the table.
+				 *
+				 *	\param [in] target
+				 *		An indexed buffer target, for example
+				 *		GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+				 *	\param [in] index
+				 *		The binding point.
+				 *	\param [in] b
+				 *		The buffer.
+				 *	\param [in] offset
+				 *		The offset in bytes of the range.
+				 *	\param [in] size
+				 *		The size in bytes of the range, which must be
+				 *		greater than zero.
+				 *
+				 *	\return
+				 *		A reference to this object.
+				 */
+				binding_table & add_buffer_range (GLenum target, GLuint index, const buffer & b, GLintptr offset, GLsizeiptr size);
+				/**
+				 *	Adds an entire buffer to the table.
+				 *
+				 *	\param [in] target
+				 *		An indexed buffer target.
+				 *	\param [in] index
+				 *		The binding point.
+				 *	\param [in] b
+				 *		The buffer.
+				 *
+				 *	\return
+				 *		A reference to this object.
+				 */
+				binding_table & add_buffer_base (GLenum target, GLuint index, const buffer & b);
+				/**
+				 *	Removes all entries from the table.
+				 */
+				void clear () noexcept;
+				
+				
+				/**
+				 *	Makes every binding in the table without saving
+				 *	the bindings it replaces.
+				 *
+				 *	This is the fastest way to apply a table since it
+				 *	performs no queries.
+				 */
+				void apply () const;
+				/**
+				 *	Makes every binding in the table.
+				 *
+				 *	Be sure to save the return value of this function
+				 *	in a local variable or the bindings will be reverted
+				 *	immediately.
+				 *
+				 *	\return
+				 *		A guard which will restore every binding which
+				 *		was replaced when it goes out of scope.
 				 */
 				guard bind () const;
 			
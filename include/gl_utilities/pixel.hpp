@@ -0,0 +1,209 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace gl_utilities {
+	
+	
+	/**
+	 *	Contains kernels which convert pixel data from
+	 *	the formats image sources produce to the formats
+	 *	textures are stored in.
+	 *
+	 *	Every kernel operates on raw memory and never calls
+	 *	OpenGL, which means the destination may be a pointer
+	 *	obtained by mapping a buffer bound to GL_PIXEL_UNPACK_BUFFER
+	 *	(see opengl::buffer::map) so that converted pixels are
+	 *	written directly into memory OpenGL will upload from.
+	 *
+	 *	The implementation of each kernel is selected the
+	 *	first time any kernel is invoked based on the
+	 *	instruction sets supported by the CPU.  The results
+	 *	are identical to those of the functions in the
+	 *	reference namespace regardless of which implementation
+	 *	is selected.
+	 */
+	namespace pixel {
+		
+		
+		/**
+		 *	Expands tightly packed RGB8 pixels to RGBA8 pixels.
+		 *
+		 *	\param [in] src
+		 *		A pointer to 3*\em count bytes.
+		 *	\param [out] dst
+		 *		A pointer to 4*\em count bytes.  Must not
+		 *		overlap \em src.
+		 *	\param [in] count
+		 *		The number of pixels to convert.
+		 *	\param [in] alpha
+		 *		The value which will be stored as the alpha
+		 *		component of each pixel.  Defaults to 255.
+		 */
+		void rgb_to_rgba (const std::uint8_t * src, std::uint8_t * dst, std::size_t count, std::uint8_t alpha=255) noexcept;
+		/**
+		 *	Swaps the red and blue components of four component
+		 *	eight bit pixels, thereby converting BGRA8 to RGBA8
+		 *	(or vice versa).
+		 *
+		 *	\param [in] src
+		 *		A pointer to 4*\em count bytes.
+		 *	\param [out] dst
+		 *		A pointer to 4*\em count bytes.  May be equal to
+		 *		\em src but must not otherwise overlap it.
+		 *	\param [in] count
+		 *		The number of pixels to convert.
+		 */
+		void swizzle_bgra (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept;
+		/**
+		 *	Converts single precision floating point values to
+		 *	half precision floating point values suitable for
+		 *	upload with GL_HALF_FLOAT.
+		 *
+		 *	Values are rounded to nearest (ties to even), values
+		 *	too large to be represented become infinity, and NaNs
+		 *	remain NaNs.
+		 *
+		 *	\param [in] src
+		 *		A pointer to \em count floats.
+		 *	\param [out] dst
+		 *		A pointer to \em count half precision values.
+		 *		Must not overlap \em src.
+		 *	\param [in] count
+		 *		The number of values (not pixels) to convert.
+		 */
+		void float_to_half (const float * src, std::uint16_t * dst, std::size_t count) noexcept;
+		/**
+		 *	Converts 16 bit normalized values to 8 bit normalized
+		 *	values with rounding.
+		 *
+		 *	\param [in] src
+		 *		A pointer to \em count values.
+		 *	\param [out] dst
+		 *		A pointer to \em count bytes.  Must not overlap
+		 *		\em src.
+		 *	\param [in] count
+		 *		The number of values (not pixels) to convert.
+		 */
+		void unorm16_to_unorm8 (const std::uint16_t * src, std::uint8_t * dst, std::size_t count) noexcept;
+		/**
+		 *	Multiplies the color components of RGBA8 pixels by
+		 *	their alpha component, rounding to nearest.
+		 *
+		 *	\param [in] src
+		 *		A pointer to 4*\em count bytes.
+		 *	\param [out] dst
+		 *		A pointer to 4*\em count bytes.  May be equal to
+		 *		\em src but must not otherwise overlap it.
+		 *	\param [in] count
+		 *		The number of pixels to convert.
+		 */
+		void premultiply (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept;
+		/**
+		 *	Encodes linear values as 8 bit sRGB values.
+		 *
+		 *	Each result is the correctly rounded sRGB encoding of
+		 *	the corresponding input clamped to [0,1].  NaNs encode
+		 *	as zero.
+		 *
+		 *	\param [in] src
+		 *		A pointer to \em count floats.
+		 *	\param [out] dst
+		 *		A pointer to \em count bytes.  Must not overlap
+		 *		\em src.
+		 *	\param [in] count
+		 *		The number of values (not pixels) to convert.  Note
+		 *		that alpha is never sRGB encoded so callers converting
+		 *		RGBA data must handle the alpha channel separately.
+		 */
+		void srgb_encode (const float * src, std::uint8_t * dst, std::size_t count) noexcept;
+		/**
+		 *	Decodes 8 bit sRGB values to linear values.
+		 *
+		 *	\param [in] src
+		 *		A pointer to \em count bytes.
+		 *	\param [out] dst
+		 *		A pointer to \em count floats.  Must not overlap
+		 *		\em src.
+		 *	\param [in] count
+		 *		The number of values (not pixels) to convert.
+		 */
+		void srgb_decode (const std::uint8_t * src, float * dst, std::size_t count) noexcept;
+		
+		
+		/**
+		 *	Retrieves the name of the instruction set the kernels
+		 *	in this namespace were dispatched to on this CPU.
+		 *
+		 *	\return
+		 *		A string such as "scalar", "sse2", or "avx2".
+		 */
+		const char * implementation () noexcept;
+		
+		
+		/**
+		 *	Contains portable, unvectorized implementations of the
+		 *	kernels in the enclosing namespace.  The dispatched
+		 *	kernels are required to produce results identical to
+		 *	these functions.
+		 */
+		namespace reference {
+			
+			
+			void rgb_to_rgba (const std::uint8_t * src, std::uint8_t * dst, std::size_t count, std::uint8_t alpha=255) noexcept;
+			void swizzle_bgra (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept;
+			void float_to_half (const float * src, std::uint16_t * dst, std::size_t count) noexcept;
+			void unorm16_to_unorm8 (const std::uint16_t * src, std::uint8_t * dst, std::size_t count) noexcept;
+			void premultiply (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept;
+			void srgb_encode (const float * src, std::uint8_t * dst, std::size_t count) noexcept;
+			void srgb_decode (const std::uint8_t * src, float * dst, std::size_t count) noexcept;
+			
+			
+			/**
+			 *	Converts a single precision floating point value to
+			 *	a half precision floating point value.
+			 *
+			 *	\param [in] f
+			 *		The value to convert.
+			 *
+			 *	\return
+			 *		The bits of the half precision value.
+			 */
+			std::uint16_t float_to_half (float f) noexcept;
+			/**
+			 *	Encodes a single linear value as sRGB.
+			 *
+			 *	\param [in] f
+			 *		The value to encode.
+			 *
+			 *	\return
+			 *		The sRGB encoding of \em f.
+			 */
+			std::uint8_t srgb_encode (float f) noexcept;
+			/**
+			 *	Decodes a single sRGB value.
+			 *
+			 *	\param [in] c
+			 *		The value to decode.
+			 *
+			 *	\return
+			 *		The linear value \em c represents.
+			 */
+			float srgb_decode (std::uint8_t c) noexcept;
+			
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,233 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	Inserts preprocessor definitions into the source of
+		 *	a shader.
+		 *
+		 *	The definitions are inserted immediately after the
+		 *	\#version directive (which must be the first directive
+		 *	in a shader) or, if there is no such directive, at the
+		 *	beginning of the source.  They are followed by a \#line
+		 *	directive so that the lines which follow keep their
+		 *	numbers.
+		 *
+		 *	\param [in] source
+		 *		The source of the shader.
+		 *	\param [in] defines
+		 *		The definitions, each of which is either a name or
+		 *		a name followed by a space and the replacement.
+		 *
+		 *	\return
+		 *		The source with the definitions inserted.
+		 */
+		std::string inject_defines (const std::string & source, const std::vector<std::string> & defines);
+		
+		
+		/**
+		 *	Puts a set of preprocessor definitions into canonical
+		 *	form so that sets which differ only in order or
+		 *	repetition compare (and hash) equal.
+		 *
+		 *	\param [in] defines
+		 *		The definitions, see inject_defines.  Defining the
+		 *		same name more than once with different replacements
+		 *		is an error.
+		 *
+		 *	\return
+		 *		The definitions sorted by name without duplicates.
+		 */
+		std::vector<std::string> canonical_defines (std::vector<std::string> defines);
+		/**
+		 *	Resolves a path to an absolute path without symbolic
+		 *	links or "." and ".." components, so that the same file
+		 *	reached through different paths is recognized as the
+		 *	same file.
+		 *
+		 *	\param [in] path
+		 *		The path.
+		 *
+		 *	\return
+		 *		The canonical path, or \em path itself if it does
+		 *		not name an existing file (for example a file
+		 *		defined in memory).
+		 */
+		std::string canonical_path (const std::string & path);
+		
+		
+		/**
+		 *	Expands \#include directives in shader sources.
+		 *
+		 *	Included files are searched for relative to the
+		 *	including file and then in each include directory in
+		 *	turn.  Each file is included at most once per expansion,
+		 *	as though it were guarded, which also breaks include
+		 *	cycles, and "\#pragma once" directives are removed.
+		 *
+		 *	"\#line" directives are written at the beginning of each
+		 *	included file and wherever the including file resumes so
+		 *	that compiler messages give the line numbers of the files
+		 *	as written.  Each file is given its own source string
+		 *	number, see source_strings.
+		 *
+		 *	The contents of every file read and the expansion of
+		 *	every file loaded are cached, call clear after files
+		 *	change on disk.
+		 */
+		class shader_preprocessor {
+			
+			
+			private:
+			
+			
+				class expansion {
+					
+					
+					public:
+					
+					
+						std::string out;
+						std::unordered_set<std::string> included;
+						/**
+						 *	In the order in which they were first
+						 *	included, which gives their source string
+						 *	numbers.
+						 */
+						std::vector<std::string> files;
+						/**
+						 *	Whether "\#line n" numbers the next line n
+						 *	(rather than n+1), which depends on the
+						 *	\#version directive.
+						 */
+						bool next_line;
+					
+					
+				};
+				
+				
+				std::vector<std::string> include_paths_;
+				std::unordered_map<std::string,std::string> files_;
+				std::unordered_map<std::string,std::string> generated_;
+				std::unordered_map<std::string,std::string> expanded_;
+				std::unordered_map<std::string,std::vector<std::string>> dependencies_;
+				std::unordered_map<std::string,std::vector<std::string>> source_strings_;
+				
+				
+				const std::string & read (const std::string & path);
+				std::string resolve (const std::string & from, const std::string & name) const;
+				bool expand (const std::string & path, expansion & e);
+			
+			
+			public:
+			
+			
+				/**
+				 *	Creates a preprocessor.
+				 *
+				 *	\param [in] include_paths
+				 *		Directories in which to search for included
+				 *		files.
+				 */
+				explicit shader_preprocessor (std::vector<std::string> include_paths=std::vector<std::string>{});
+				
+				
+				/**
+				 *	Loads a shader source file and expands all the
+				 *	files it includes.
+				 *
+				 *	Throws shader_compilation_error if a file cannot be
+				 *	found or read.
+				 *
+				 *	\param [in] filename
+				 *		The name of the file.
+				 *
+				 *	\return
+				 *		A reference to the expanded source, which remains
+				 *		valid until clear is called.
+				 */
+				const std::string & load (const std::string & filename);
+				/**
+				 *	Retrieves the files which make up the expansion of
+				 *	a file, loading it if necessary.
+				 *
+				 *	\param [in] filename
+				 *		The name of the file.
+				 *
+				 *	\return
+				 *		A reference to the canonical paths of the file and
+				 *		every file it includes, directly or indirectly.
+				 */
+				const std::vector<std::string> & dependencies (const std::string & filename);
+				/**
+				 *	Retrieves the files which make up the expansion of
+				 *	a file by source string number, loading it if
+				 *	necessary.
+				 *
+				 *	Compiler messages which refer to source string
+				 *	\em i refer to element \em i, the file itself is
+				 *	always element 0.
+				 *
+				 *	\param [in] filename
+				 *		The name of the file.
+				 *
+				 *	\return
+				 *		A reference to the canonical paths (or for files
+				 *		defined in memory the names) of the file and
+				 *		every file it includes.
+				 */
+				const std::vector<std::string> & source_strings (const std::string & filename);
+				/**
+				 *	Discards the cached contents of a file and every
+				 *	cached expansion which includes it.
+				 *
+				 *	\param [in] path
+				 *		The canonical path of the file.
+				 */
+				void invalidate (const std::string & path);
+				/**
+				 *	Defines a file which exists only in memory, for
+				 *	example source generated at runtime.
+				 *
+				 *	"\#include" directives naming the file exactly
+				 *	resolve to it before the file system is searched.
+				 *	Defined files are not reported by dependencies and
+				 *	survive clear.  Redefining a file discards every
+				 *	cached expansion.
+				 *
+				 *	\param [in] name
+				 *		The name by which the file is included.
+				 *	\param [in] source
+				 *		The contents of the file.
+				 */
+				void define (const std::string & name, std::string source);
+				/**
+				 *	Discards all cached files and expansions.
+				 */
+				void clear () noexcept;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
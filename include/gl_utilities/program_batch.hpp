@@ -0,0 +1,139 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include "optional.hpp"
+#include <cstddef>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	Builds many programs without waiting for each one.
+		 *
+		 *	Querying the result of a compile or a link forces the
+		 *	implementation to finish it, so building programs one by
+		 *	one serializes all the work.  A batch instead issues every
+		 *	compile and link up front and only queries results when a
+		 *	program is taken, giving the implementation the chance to
+		 *	build programs concurrently.
+		 *
+		 *	Where KHR_parallel_shader_compile is supported completed
+		 *	may be used to find out which programs may be taken without
+		 *	blocking.
+		 *
+		 *	All member functions must be called on the thread to which
+		 *	the OpenGL context is bound.
+		 */
+		class program_batch {
+			
+			
+			private:
+			
+			
+				class entry {
+					
+					
+					public:
+					
+					
+						std::vector<shader> shaders;
+						optional<program> p;
+					
+					
+				};
+				
+				
+				std::vector<entry> entries_;
+				
+				
+				entry & get_entry (std::size_t);
+				const entry & get_entry (std::size_t) const;
+			
+			
+			public:
+			
+			
+				program_batch () = default;
+				program_batch (const program_batch &) = delete;
+				program_batch (program_batch &&) = default;
+				program_batch & operator = (const program_batch &) = delete;
+				program_batch & operator = (program_batch &&) = default;
+				
+				
+				/**
+				 *	Issues the compiles and the link for a program.
+				 *
+				 *	\param [in] sources
+				 *		The shaders which make up the program.
+				 *
+				 *	\return
+				 *		The index of the program within the batch.
+				 */
+				std::size_t add (const std::vector<shader_source> & sources);
+				
+				
+				/**
+				 *	Retrieves the number of programs which have been
+				 *	added to the batch.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t size () const noexcept;
+				/**
+				 *	Determines whether a program has finished building.
+				 *
+				 *	\param [in] i
+				 *		The index of a program which has not been taken.
+				 *
+				 *	\return
+				 *		\em true if the program may be taken without
+				 *		blocking, \em false otherwise.
+				 */
+				bool completed (std::size_t i) const;
+				/**
+				 *	Retrieves the number of programs which have neither
+				 *	finished building nor been taken.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t pending () const;
+				
+				
+				/**
+				 *	Removes a program from the batch, waiting for it to
+				 *	finish building if necessary.
+				 *
+				 *	Errors are reported here rather than when the program
+				 *	is added.  A shader_compilation_error is thrown if any
+				 *	shader failed to compile, a program_linking_error is
+				 *	thrown if linking failed.
+				 *
+				 *	\param [in] i
+				 *		The index of a program which has not been taken.
+				 *
+				 *	\return
+				 *		The linked program.
+				 */
+				program take (std::size_t i);
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,245 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "embedded.hpp"
+#include "opengl.hpp"
+#include "optional.hpp"
+#include "preprocessor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	A shader stage whose source is embedded into the
+		 *	executable.
+		 */
+		class embedded_shader {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The type of shader.
+				 */
+				GLenum type;
+				const embedded_source * source;
+			
+			
+		};
+		
+		
+		/**
+		 *	Caches linked programs on disk using
+		 *	ARB_get_program_binary.
+		 *
+		 *	Programs are keyed by a hash of the source and type of
+		 *	each shader, the preprocessor definitions, and the vendor,
+		 *	renderer, and version strings of the implementation so
+		 *	that a driver update invalidates the cache.  When a
+		 *	cached binary is missing, stale, or rejected by the
+		 *	implementation the program is compiled and linked as
+		 *	usual and the result is written back to the cache.
+		 *
+		 *	Each binary is written to a temporary file which is then
+		 *	renamed over the final file so that a crash or a concurrent
+		 *	process never observes a partially written binary.  The
+		 *	directory is scanned once on construction and the size
+		 *	of the cache is tracked from then on, when a write takes
+		 *	it over its size limit the directory is scanned again and
+		 *	the least recently used binaries are deleted until the
+		 *	cache fills no more than seven eighths of the limit.
+		 *
+		 *	If the implementation does not support any binary formats
+		 *	the cache simply compiles and links every program.
+		 *
+		 *	All member functions must be called on the thread to which
+		 *	the OpenGL context is bound.
+		 */
+		class program_cache {
+			
+			
+			private:
+			
+			
+				std::string directory_;
+				std::size_t max_size_;
+				//	The bytes of binaries on disk as of the last
+				//	scan plus those written since, binaries
+				//	written by other processes are only noticed
+				//	by the next scan
+				std::size_t used_;
+				std::uint64_t driver_;
+				bool supported_;
+				std::size_t hits_;
+				std::size_t misses_;
+				std::size_t rejections_;
+				
+				
+				class stage {
+					
+					
+					public:
+					
+					
+						GLenum type;
+						std::uint64_t hash;
+						source_fragment source;
+					
+					
+				};
+				
+				
+				std::string path (std::uint64_t key) const;
+				optional<program> load (std::uint64_t key);
+				void save (std::uint64_t key, const program & p);
+				void prune ();
+				std::uint64_t key (const std::vector<stage> &, const std::vector<std::string> &) const;
+				program build (const std::vector<stage> &, const std::vector<std::string> &);
+			
+			
+			public:
+			
+			
+				program_cache (const program_cache &) = delete;
+				program_cache & operator = (const program_cache &) = delete;
+				
+				
+				/**
+				 *	Creates a program cache.
+				 *
+				 *	\param [in] directory
+				 *		The directory in which binaries are stored, it
+				 *		is created if it does not exist.
+				 *	\param [in] max_size
+				 *		The maximum number of bytes of binaries to keep
+				 *		on disk.
+				 */
+				program_cache (std::string directory, std::size_t max_size);
+				
+				
+				/**
+				 *	Computes the key under which a program is cached.
+				 *
+				 *	\param [in] sources
+				 *		The shaders which make up the program.
+				 *	\param [in] defines
+				 *		The preprocessor definitions.
+				 *
+				 *	\return
+				 *		The key.
+				 */
+				std::uint64_t key (const std::vector<shader_source> & sources, const std::vector<std::string> & defines) const;
+				/**
+				 *	Retrieves a program from the cache or, if it is not
+				 *	cached, compiles, links, and caches it.
+				 *
+				 *	\param [in] sources
+				 *		The shaders which make up the program.
+				 *	\param [in] defines
+				 *		Preprocessor definitions to inject into every
+				 *		shader, see inject_defines.  Defaults to none.
+				 *
+				 *	\return
+				 *		A linked program.
+				 */
+				program get (const std::vector<shader_source> & sources, const std::vector<std::string> & defines=std::vector<std::string>{});
+				/**
+				 *	Retrieves a program made up of embedded sources from
+				 *	the cache or, if it is not cached, compiles, links,
+				 *	and caches it.
+				 *
+				 *	The hashes computed when the sources were embedded
+				 *	are used to compute the key, so the sources are not
+				 *	hashed at runtime.  The key is the same as if the
+				 *	sources had been passed as shader_source objects.
+				 *
+				 *	\param [in] stages
+				 *		The shaders which make up the program.
+				 *	\param [in] defines
+				 *		Preprocessor definitions to inject into every
+				 *		shader, see inject_defines.  Defaults to none.
+				 *
+				 *	\return
+				 *		A linked program.
+				 */
+				program get (const std::vector<embedded_shader> & stages, const std::vector<std::string> & defines=std::vector<std::string>{});
+				/**
+				 *	Stores a program which was linked elsewhere under
+				 *	the key get would use for the same sources and
+				 *	definitions, replacing any binary already cached.
+				 *
+				 *	Implementations are only required to provide
+				 *	binaries of programs which had
+				 *	GL_PROGRAM_BINARY_RETRIEVABLE_HINT set when they
+				 *	were linked.
+				 *
+				 *	\param [in] sources
+				 *		The shaders which make up the program, without
+				 *		\em defines injected.
+				 *	\param [in] defines
+				 *		The preprocessor definitions which were
+				 *		injected into every shader.
+				 *	\param [in] p
+				 *		The linked program.
+				 */
+				void store (const std::vector<shader_source> & sources, const std::vector<std::string> & defines, const program & p);
+				
+				
+				/**
+				 *	Determines whether the implementation supports any
+				 *	program binary formats, if not nothing is cached.
+				 *
+				 *	\return
+				 *		\em true if binaries are cached, \em false
+				 *		otherwise.
+				 */
+				bool supported () const noexcept;
+				
+				
+				/**
+				 *	Retrieves the number of programs which were loaded
+				 *	from the cache.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t hits () const noexcept;
+				/**
+				 *	Retrieves the number of programs which were not
+				 *	cached, including those which were rejected.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t misses () const noexcept;
+				/**
+				 *	Retrieves the number of cached binaries which were
+				 *	stale, corrupt, or rejected by the implementation.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t rejections () const noexcept;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
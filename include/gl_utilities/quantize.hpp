@@ -0,0 +1,140 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace gl_utilities {
+	
+	
+	/**
+	 *	Contains kernels which pack floating point vertex
+	 *	attributes into narrower formats OpenGL can read
+	 *	directly, reducing the bandwidth spent fetching
+	 *	vertices.
+	 *
+	 *	Half floats are produced by pixel::float_to_half.
+	 *	The component types to describe packed attributes in
+	 *	a vertex format are opengl::half,
+	 *	opengl::packed_2_10_10_10, and GLshort with
+	 *	opengl::conversion::normalized.
+	 *
+	 *	As in the pixel namespace the implementation of each
+	 *	kernel is selected the first time any kernel is invoked
+	 *	based on the instruction sets supported by the CPU, and
+	 *	the results are identical to those of the functions in
+	 *	the reference namespace.  Values are rounded to nearest,
+	 *	ties to even, values outside [-1,1] are clamped, and NaN
+	 *	becomes -1.
+	 */
+	namespace quantize {
+		
+		
+		/**
+		 *	Converts floats to signed normalized 16 bit integers,
+		 *	to be read as GL_SHORT with normalization.
+		 *
+		 *	\param [in] src
+		 *		The values.
+		 *	\param [out] dst
+		 *		The converted values.
+		 *	\param [in] count
+		 *		The number of values.
+		 */
+		void float_to_snorm16 (const float * src, std::int16_t * dst, std::size_t count) noexcept;
+		/**
+		 *	Packs four component vectors into 32 bit integers, to
+		 *	be read as four components of
+		 *	GL_INT_2_10_10_10_REV with normalization.
+		 *
+		 *	The first three components receive 10 bits each and
+		 *	the last 2 bits, which suits normals (with a last
+		 *	component of 0) and tangents (with the sign of the
+		 *	bitangent as the last component).
+		 *
+		 *	\param [in] src
+		 *		The vectors, four floats each.
+		 *	\param [out] dst
+		 *		The packed vectors.
+		 *	\param [in] count
+		 *		The number of vectors.
+		 */
+		void pack_snorm_2_10_10_10 (const float * src, std::uint32_t * dst, std::size_t count) noexcept;
+		/**
+		 *	Encodes three component direction vectors as two signed
+		 *	normalized 16 bit integers by projecting them onto an
+		 *	octahedron and unfolding it onto a square.
+		 *
+		 *	The result is read as two components of GL_SHORT with
+		 *	normalization and decoded in the vertex shader by:
+		 *
+		 *	\code
+		 *	vec3 n=vec3(e.xy,1.0-abs(e.x)-abs(e.y));
+		 *	float t=max(-n.z,0.0);
+		 *	n.xy+=mix(vec2(t),vec2(-t),greaterThanEqual(n.xy,vec2(0.0)));
+		 *	n=normalize(n);
+		 *	\endcode
+		 *
+		 *	\param [in] src
+		 *		The vectors, three floats each, which need not be
+		 *		normalized.  Zero vectors encode as (0,0).
+		 *	\param [out] dst
+		 *		The encoded vectors, two integers each.
+		 *	\param [in] count
+		 *		The number of vectors.
+		 */
+		void octahedral_encode (const float * src, std::int16_t * dst, std::size_t count) noexcept;
+		
+		
+		/**
+		 *	Retrieves the name of the instruction set the kernels
+		 *	in this namespace were dispatched to on this CPU.
+		 *
+		 *	\return
+		 *		A string such as "scalar" or "sse4.1".
+		 */
+		const char * implementation () noexcept;
+		
+		
+		/**
+		 *	Contains portable, unvectorized implementations of the
+		 *	kernels, and the inverse of each conversion so that
+		 *	the error it introduces may be measured.
+		 */
+		namespace reference {
+			
+			
+			void float_to_snorm16 (const float * src, std::int16_t * dst, std::size_t count) noexcept;
+			void pack_snorm_2_10_10_10 (const float * src, std::uint32_t * dst, std::size_t count) noexcept;
+			void octahedral_encode (const float * src, std::int16_t * dst, std::size_t count) noexcept;
+			
+			
+			std::int16_t float_to_snorm16 (float f) noexcept;
+			float snorm16_to_float (std::int16_t i) noexcept;
+			/**
+			 *	\param [out] dst
+			 *		Four floats.
+			 */
+			void unpack_snorm_2_10_10_10 (std::uint32_t p, float * dst) noexcept;
+			/**
+			 *	\param [in] src
+			 *		Two integers.
+			 *	\param [out] dst
+			 *		Three floats, normalized.
+			 */
+			void octahedral_decode (const std::int16_t * src, float * dst) noexcept;
+			
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,381 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include "optional.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	Describes one attachment of a render target.
+		 */
+		class render_target_attachment {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The attachment point, for example
+				 *	GL_COLOR_ATTACHMENT0 or GL_DEPTH_ATTACHMENT.
+				 */
+				GLenum attachment;
+				/**
+				 *	The sized internal format.
+				 */
+				GLenum internal_format;
+				/**
+				 *	\em true if the attachment is a texture which may
+				 *	be sampled, \em false if it is a render buffer.
+				 */
+				bool sampled;
+				
+				
+				bool operator == (const render_target_attachment & other) const noexcept;
+			
+			
+		};
+		
+		
+		/**
+		 *	Describes a render target, two render targets with equal
+		 *	descriptions are interchangeable.
+		 */
+		class render_target_description {
+			
+			
+			public:
+			
+			
+				GLsizei width;
+				GLsizei height;
+				/**
+				 *	The number of samples per pixel, zero for a target
+				 *	which is not multisampled.
+				 */
+				GLsizei samples;
+				/**
+				 *	The attachments.  Color attachments become draw
+				 *	buffers in the order in which they appear.
+				 */
+				std::vector<render_target_attachment> attachments;
+				
+				
+				bool operator == (const render_target_description & other) const noexcept;
+				/**
+				 *	Estimates the number of bytes the attachments of a
+				 *	render target with this description occupy, see
+				 *	estimate_size.
+				 *
+				 *	\return
+				 *		A number of bytes.
+				 */
+				std::size_t size () const;
+			
+			
+		};
+		
+		
+		/**
+		 *	A frame buffer complete with its attachments.
+		 */
+		class render_target {
+			
+			
+			public:
+			
+			
+				render_target_description description;
+				frame_buffer fb;
+				/**
+				 *	One element per attachment of \em description,
+				 *	engaged for sampled attachments.
+				 */
+				std::vector<optional<texture>> textures;
+				/**
+				 *	One element per attachment of \em description,
+				 *	engaged for attachments which are not sampled.
+				 */
+				std::vector<optional<render_buffer>> render_buffers;
+				
+				
+				/**
+				 *	Creates the objects a description describes and
+				 *	attaches them.
+				 *
+				 *	Sampled attachments which are not multisampled
+				 *	require ARB_texture_storage.  Throws error if the
+				 *	resulting frame buffer is incomplete.
+				 *
+				 *	\param [in] desc
+				 *		The description.
+				 */
+				explicit render_target (render_target_description desc);
+				
+				
+				/**
+				 *	Retrieves the texture attached at an attachment
+				 *	point.
+				 *
+				 *	\param [in] attachment
+				 *		The attachment point, which must be sampled.
+				 *
+				 *	\return
+				 *		A reference to the texture.
+				 */
+				const texture & get_texture (GLenum attachment) const;
+			
+			
+		};
+		
+		
+		/**
+		 *	Recycles transient render targets, such as those used
+		 *	by post processing, across frames.
+		 *
+		 *	A render target which is released is kept on a free list
+		 *	for its description, stamped with the current frame, and
+		 *	handed out again by the next acquire with an equal
+		 *	description.  Since render targets keep their frame
+		 *	buffer and attachments the frame buffer is ready to use
+		 *	immediately.  Render targets which go unused for a number
+		 *	of frames are deleted by end_frame, except that those
+		 *	created by reserve are kept until they are first used.
+		 *
+		 *	The pool must outlive every lease it hands out.  All
+		 *	member functions must be called on the thread to which
+		 *	the OpenGL context is bound.
+		 */
+		class render_target_pool {
+			
+			
+			public:
+			
+			
+				/**
+				 *	Grants exclusive use of a render target until the
+				 *	lifetime of this object ends, at which point the
+				 *	render target is returned to the pool.
+				 */
+				class lease {
+					
+					
+					private:
+					
+					
+						render_target_pool * pool_;
+						optional<render_target> t_;
+						std::size_t bytes_;
+						
+						
+						void destroy () noexcept;
+					
+					
+					public:
+					
+					
+						lease (const lease &) = delete;
+						lease & operator = (const lease &) = delete;
+						
+						
+						lease () noexcept;
+						lease (render_target_pool & pool, render_target t, std::size_t bytes) noexcept;
+						lease (lease &&) noexcept;
+						lease & operator = (lease &&) noexcept;
+						
+						
+						~lease () noexcept;
+						
+						
+						const render_target & operator * () const noexcept;
+						const render_target * operator -> () const noexcept;
+					
+					
+				};
+			
+			
+			private:
+			
+			
+				class hasher {
+					
+					
+					public:
+					
+					
+						std::size_t operator () (const render_target_description & desc) const noexcept;
+					
+					
+				};
+				
+				
+				class entry {
+					
+					
+					public:
+					
+					
+						render_target t;
+						std::size_t bytes;
+						std::uint64_t frame;
+						/**
+						 *	\em true if created by reserve and never
+						 *	acquired, such render targets are not idle.
+						 */
+						bool reserved;
+					
+					
+				};
+				
+				
+				std::size_t max_idle_;
+				std::uint64_t frame_;
+				std::unordered_map<render_target_description,std::vector<entry>,hasher> free_;
+				std::size_t size_;
+				std::size_t peak_;
+				std::size_t frame_peak_;
+				std::size_t steady_;
+				std::size_t created_;
+				std::size_t reused_;
+				
+				
+				entry create (const render_target_description & desc);
+				void release (render_target t, std::size_t bytes) noexcept;
+			
+			
+			public:
+			
+			
+				render_target_pool (const render_target_pool &) = delete;
+				render_target_pool (render_target_pool &&) = delete;
+				render_target_pool & operator = (const render_target_pool &) = delete;
+				render_target_pool & operator = (render_target_pool &&) = delete;
+				
+				
+				/**
+				 *	Creates a render target pool.
+				 *
+				 *	\param [in] max_idle_frames
+				 *		The number of consecutive frames a render target
+				 *		may go unused before it is deleted.  Defaults
+				 *		to 2, which tolerates a target being skipped
+				 *		for a frame.
+				 */
+				explicit render_target_pool (std::size_t max_idle_frames=2) noexcept;
+				
+				
+				/**
+				 *	Acquires a render target, reusing a free one if
+				 *	possible.
+				 *
+				 *	The contents of a reused render target are
+				 *	undefined.
+				 *
+				 *	\param [in] desc
+				 *		The description of the render target.
+				 *
+				 *	\return
+				 *		A lease on the render target.
+				 */
+				lease acquire (const render_target_description & desc);
+				/**
+				 *	Creates render targets ahead of time so that the
+				 *	first frames which use them do not stall.
+				 *
+				 *	end_frame does not delete these render targets
+				 *	until each has been acquired and released, so
+				 *	they survive however many frames pass before they
+				 *	are first needed.
+				 *
+				 *	\param [in] desc
+				 *		The description of the render targets.
+				 *	\param [in] count
+				 *		The number of free render targets with this
+				 *		description which should exist.
+				 */
+				void reserve (const render_target_description & desc, std::size_t count);
+				/**
+				 *	Ends the current frame, deleting free render
+				 *	targets which have not been used for the maximum
+				 *	number of idle frames, other than those reserved
+				 *	and not yet acquired.
+				 */
+				void end_frame ();
+				/**
+				 *	Deletes every free render target.
+				 */
+				void clear () noexcept;
+				
+				
+				/**
+				 *	Retrieves the number of frames which have ended.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::uint64_t frame () const noexcept;
+				/**
+				 *	Estimates the number of bytes occupied by every
+				 *	render target which exists, whether leased or
+				 *	free.
+				 *
+				 *	\return
+				 *		A number of bytes.
+				 */
+				std::size_t size () const noexcept;
+				/**
+				 *	Retrieves the greatest value size has ever had.
+				 *
+				 *	\return
+				 *		A number of bytes.
+				 */
+				std::size_t peak () const noexcept;
+				/**
+				 *	Retrieves the steady state memory use: the greatest
+				 *	value size had during the last frame which ended,
+				 *	which once the set of render targets a frame uses
+				 *	stops changing is all the pool retains.
+				 *
+				 *	\return
+				 *		A number of bytes.
+				 */
+				std::size_t steady () const noexcept;
+				/**
+				 *	Retrieves the number of render targets which have
+				 *	been created.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t created () const noexcept;
+				/**
+				 *	Retrieves the number of times acquire has reused a
+				 *	free render target.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t reused () const noexcept;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,420 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include "optional.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	Estimates the number of bytes an implementation uses
+		 *	to store a single image.
+		 *
+		 *	Implementations are free to pad and align storage
+		 *	however they like so this is only an estimate, formats
+		 *	with three components are assumed to be padded to four.
+		 *
+		 *	\param [in] internal_format
+		 *		The sized internal format of the image.
+		 *	\param [in] width
+		 *		The width of the image.
+		 *	\param [in] height
+		 *		The height of the image.
+		 *	\param [in] depth
+		 *		The depth of the image, or 1 for images with fewer
+		 *		than three dimensions.
+		 *	\param [in] samples
+		 *		The number of samples per pixel, zero and one
+		 *		both represent a single sample.
+		 *
+		 *	\return
+		 *		A number of bytes.
+		 */
+		std::size_t estimate_size (GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth=1, GLsizei samples=0);
+		
+		
+		/**
+		 *	Describes the storage allocated for a texture.
+		 */
+		class texture_storage {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The target the texture is bound to.
+				 */
+				GLenum target;
+				/**
+				 *	The sized internal format of the texture.
+				 */
+				GLenum internal_format;
+				GLsizei width;
+				GLsizei height;
+				/**
+				 *	The depth of a three dimensional texture or the
+				 *	number of layers of an array texture, which for
+				 *	cube map array textures counts layer-faces (six
+				 *	per cube).  1 otherwise.
+				 */
+				GLsizei depth;
+				/**
+				 *	The number of mipmap levels.
+				 */
+				GLsizei levels;
+				/**
+				 *	The number of samples of a multisample texture.
+				 *	0 otherwise.
+				 */
+				GLsizei samples;
+				
+				
+				/**
+				 *	Estimates the number of bytes the texture occupies,
+				 *	summed over every level (and every face of a cube
+				 *	map).
+				 *
+				 *	\return
+				 *		A number of bytes.
+				 */
+				std::size_t size () const;
+			
+			
+		};
+		
+		
+		/**
+		 *	Accounts for the memory used by textures and render
+		 *	buffers against a budget and, when the budget is
+		 *	exceeded, evicts streamable textures in least recently
+		 *	bound order.
+		 *
+		 *	Streamable textures are owned by the manager and are
+		 *	evicted first by dropping their top mipmap levels and
+		 *	then, if that does not suffice, by freeing them
+		 *	entirely.  Whether a texture was recently used is
+		 *	determined by texture::last_bound, therefore streamable
+		 *	textures must be bound through texture::bind.
+		 *
+		 *	Dropping levels requires ARB_texture_storage and
+		 *	ARB_copy_image, without them streamable textures may
+		 *	only be freed.  The replacement texture keeps the
+		 *	sampling parameters and the place in the order of use
+		 *	of the original, with the base and maximum levels
+		 *	renumbered.
+		 *
+		 *	All member functions must be called on the thread to
+		 *	which the OpenGL context is bound.
+		 */
+		class residency_manager {
+			
+			
+			public:
+			
+			
+				/**
+				 *	Identifies a streamable texture.
+				 */
+				using id=std::uint64_t;
+				/**
+				 *	The type of callback invoked when a streamable
+				 *	texture has levels dropped or is freed.
+				 */
+				using evict_type=std::function<void (id)>;
+				
+				
+				/**
+				 *	Represents memory accounted against the budget
+				 *	which is not eligible for eviction.  The memory
+				 *	ceases to be accounted when the lifetime of this
+				 *	object ends.
+				 */
+				class allocation {
+					
+					
+					private:
+					
+					
+						residency_manager * m_;
+						std::size_t bytes_;
+						
+						
+						void destroy () noexcept;
+					
+					
+					public:
+					
+					
+						allocation (const allocation &) = delete;
+						allocation & operator = (const allocation &) = delete;
+						
+						
+						allocation () noexcept;
+						allocation (residency_manager & m, std::size_t bytes) noexcept;
+						allocation (allocation &&) noexcept;
+						allocation & operator = (allocation &&) noexcept;
+						
+						
+						~allocation () noexcept;
+						
+						
+						/**
+						 *	Retrieves the number of bytes this object
+						 *	accounts for.
+						 *
+						 *	\return
+						 *		A number of bytes.
+						 */
+						std::size_t size () const noexcept;
+					
+					
+				};
+			
+			
+			private:
+			
+			
+				class entry {
+					
+					
+					public:
+					
+					
+						optional<texture> tex;
+						texture_storage storage;
+						GLsizei min_levels;
+						evict_type evicted;
+					
+					
+				};
+				
+				
+				std::size_t budget_;
+				std::size_t used_;
+				std::size_t peak_;
+				std::size_t evictions_;
+				id next_;
+				std::unordered_map<id,entry> entries_;
+				
+				
+				entry & get_entry (id);
+				const entry & get_entry (id) const;
+				void add_bytes (std::size_t) noexcept;
+				void remove_bytes (std::size_t) noexcept;
+				GLsizei drop_levels (entry &);
+			
+			
+			public:
+			
+			
+				residency_manager (const residency_manager &) = delete;
+				residency_manager (residency_manager &&) = delete;
+				residency_manager & operator = (const residency_manager &) = delete;
+				residency_manager & operator = (residency_manager &&) = delete;
+				
+				
+				/**
+				 *	Creates a residency manager.
+				 *
+				 *	\param [in] budget
+				 *		The number of bytes of texture and render
+				 *		buffer memory which may be in use before
+				 *		streamable textures are evicted.
+				 */
+				explicit residency_manager (std::size_t budget) noexcept;
+				
+				
+				/**
+				 *	Retrieves the budget.
+				 *
+				 *	\return
+				 *		A number of bytes.
+				 */
+				std::size_t budget () const noexcept;
+				/**
+				 *	Changes the budget.  This does not evict anything
+				 *	until enforce is called.
+				 *
+				 *	\param [in] bytes
+				 *		The new budget.
+				 */
+				void budget (std::size_t bytes) noexcept;
+				/**
+				 *	Retrieves the number of bytes currently accounted.
+				 *
+				 *	\return
+				 *		A number of bytes.
+				 */
+				std::size_t used () const noexcept;
+				/**
+				 *	Retrieves the greatest number of bytes which have
+				 *	ever been accounted at once.
+				 *
+				 *	\return
+				 *		A number of bytes.
+				 */
+				std::size_t peak () const noexcept;
+				/**
+				 *	Retrieves the number of times a level has been
+				 *	dropped from or a streamable texture has been freed.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t evictions () const noexcept;
+				
+				
+				/**
+				 *	Accounts for a texture which may not be evicted.
+				 *
+				 *	\param [in] storage
+				 *		The storage of the texture.
+				 *
+				 *	\return
+				 *		An object which should be kept alive as long as
+				 *		the texture exists.
+				 */
+				allocation account (const texture_storage & storage);
+				/**
+				 *	Accounts for a render buffer.
+				 *
+				 *	\param [in] internal_format
+				 *		The internal format of the render buffer.
+				 *	\param [in] width
+				 *		The width of the render buffer.
+				 *	\param [in] height
+				 *		The height of the render buffer.
+				 *	\param [in] samples
+				 *		The number of samples of the render buffer.
+				 *
+				 *	\return
+				 *		An object which should be kept alive as long as
+				 *		the render buffer exists.
+				 */
+				allocation account (GLenum internal_format, GLsizei width, GLsizei height, GLsizei samples=0);
+				
+				
+				/**
+				 *	Transfers ownership of a streamable texture to
+				 *	the manager.
+				 *
+				 *	\param [in] tex
+				 *		The texture.
+				 *	\param [in] storage
+				 *		The storage which has been allocated for
+				 *		\em tex.
+				 *	\param [in] evicted
+				 *		A callback which will be invoked after levels
+				 *		are dropped from \em tex or after \em tex is
+				 *		freed, so that they may be streamed in again
+				 *		later.  May be empty.
+				 *	\param [in] min_levels
+				 *		Levels will not be dropped below this number,
+				 *		instead the texture will be freed entirely.
+				 *		Defaults to 1.
+				 *
+				 *	\return
+				 *		An identifier for the texture.
+				 */
+				id add (texture tex, const texture_storage & storage, evict_type evicted=evict_type{}, GLsizei min_levels=1);
+				/**
+				 *	Replaces a streamable texture, for example after
+				 *	the levels which were dropped have been streamed
+				 *	in again.
+				 *
+				 *	\param [in] i
+				 *		The identifier of the texture to replace.
+				 *	\param [in] tex
+				 *		The new texture.
+				 *	\param [in] storage
+				 *		The storage which has been allocated for
+				 *		\em tex.
+				 */
+				void replace (id i, texture tex, const texture_storage & storage);
+				/**
+				 *	Relinquishes ownership of a streamable texture.
+				 *
+				 *	\param [in] i
+				 *		The identifier of the texture.
+				 *
+				 *	\return
+				 *		The texture, if it had not been freed.
+				 */
+				optional<texture> remove (id i);
+				
+				
+				/**
+				 *	Determines whether a streamable texture is resident
+				 *	(i.e. has not been freed).
+				 *
+				 *	\param [in] i
+				 *		The identifier of the texture.
+				 *
+				 *	\return
+				 *		\em true if the texture is resident, \em false
+				 *		otherwise.
+				 */
+				bool resident (id i) const;
+				/**
+				 *	Retrieves a streamable texture.
+				 *
+				 *	Since levels may be dropped by creating a new
+				 *	texture the returned reference is only valid until
+				 *	the next call to enforce.
+				 *
+				 *	\param [in] i
+				 *		The identifier of the texture, which must be
+				 *		resident.
+				 *
+				 *	\return
+				 *		A reference to the texture.
+				 */
+				const texture & get (id i) const;
+				/**
+				 *	Retrieves the current storage of a streamable
+				 *	texture, which reflects any dropped levels.
+				 *
+				 *	\param [in] i
+				 *		The identifier of the texture.
+				 *
+				 *	\return
+				 *		A reference to the storage.
+				 */
+				const texture_storage & storage (id i) const;
+				
+				
+				/**
+				 *	Evicts streamable textures until the memory in use
+				 *	does not exceed the budget or there is nothing left
+				 *	to evict.
+				 *
+				 *	Streamable textures are visited in least recently
+				 *	bound order and have their top levels dropped down to
+				 *	their minimum number of levels.  If the budget is
+				 *	still exceeded they are then freed in the same order.
+				 */
+				void enforce ();
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
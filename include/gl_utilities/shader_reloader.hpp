@@ -0,0 +1,222 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "compile_service.hpp"
+#include "opengl.hpp"
+#include "optional.hpp"
+#include "preprocessor.hpp"
+#include "program_batch.hpp"
+#include "variant_cache.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	Rebuilds programs when the files they were built from
+		 *	change on disk.
+		 *
+		 *	A background thread uses inotify to watch the directories
+		 *	containing every file which makes up a watched program,
+		 *	including included files.  poll, which should be called
+		 *	once per frame, only checks an atomic flag unless a file
+		 *	has changed.  When one has, the affected programs are
+		 *	rebuilt without waiting for the results (through a
+		 *	compile_service if one was supplied, otherwise through a
+		 *	program_batch) and each new program replaces the old one
+		 *	in its owner once it has linked successfully.  If a
+		 *	rebuild fails the old program remains in place and the
+		 *	error is reported through a callback.
+		 *
+		 *	All member functions must be called on the thread to which
+		 *	the OpenGL context is bound.
+		 */
+		class shader_reloader {
+			
+			
+			public:
+			
+			
+				/**
+				 *	Identifies a watched program.
+				 */
+				using id=std::size_t;
+				/**
+				 *	The type of callback invoked when a program fails
+				 *	to rebuild.
+				 */
+				using error_type=std::function<void (id, const std::string &)>;
+			
+			
+			private:
+			
+			
+				class watched {
+					
+					
+					public:
+					
+					
+						program * owner;
+						std::vector<shader_file> stages;
+						std::vector<std::string> defines;
+						std::vector<std::string> dependencies;
+					
+					
+				};
+				
+				
+				class flight {
+					
+					
+					public:
+					
+					
+						id which;
+						std::size_t index;
+						std::future<program> future;
+					
+					
+				};
+				
+				
+				shader_preprocessor & pre_;
+				compile_service * service_;
+				error_type error_;
+				int fd_;
+				int wake_ [2];
+				id next_;
+				std::unordered_map<id,watched> watched_;
+				optional<program_batch> batch_;
+				std::vector<flight> flights_;
+				std::size_t reloads_;
+				std::size_t failures_;
+				//	Shared with the background thread
+				std::mutex m_;
+				std::unordered_map<int,std::string> directories_;
+				std::unordered_set<std::string> changed_;
+				std::atomic<bool> dirty_;
+				std::thread thread_;
+				
+				
+				void run ();
+				void watch_dependencies (watched &);
+				void unwatch_directories () noexcept;
+				void rebuild (id, watched &);
+				void land ();
+				void fail (id, const std::string &);
+			
+			
+			public:
+			
+			
+				shader_reloader (const shader_reloader &) = delete;
+				shader_reloader (shader_reloader &&) = delete;
+				shader_reloader & operator = (const shader_reloader &) = delete;
+				shader_reloader & operator = (shader_reloader &&) = delete;
+				
+				
+				/**
+				 *	Creates a reloader and starts its background
+				 *	thread.
+				 *
+				 *	\param [in] pre
+				 *		The preprocessor used to load files, which must
+				 *		outlive the reloader.
+				 *	\param [in] error
+				 *		Invoked with the identifier of the program and a
+				 *		description of the error when a program fails to
+				 *		rebuild.  May be empty.
+				 *	\param [in] service
+				 *		A compile service used to rebuild programs, or
+				 *		\em nullptr to rebuild them with program_batch.
+				 *		If not \em nullptr must outlive the reloader.
+				 */
+				explicit shader_reloader (shader_preprocessor & pre, error_type error=error_type{}, compile_service * service=nullptr);
+				
+				
+				/**
+				 *	Stops the background thread.  Rebuilds which are in
+				 *	progress are discarded.
+				 */
+				~shader_reloader () noexcept;
+				
+				
+				/**
+				 *	Starts watching the files behind a program.
+				 *
+				 *	\param [in] owner
+				 *		The program which is replaced when it is rebuilt.
+				 *		Must remain at the same address until it is no
+				 *		longer watched.
+				 *	\param [in] stages
+				 *		The files from which \em owner was built.
+				 *	\param [in] defines
+				 *		The definitions with which \em owner was built,
+				 *		see inject_defines.
+				 *
+				 *	\return
+				 *		An identifier for the watched program.
+				 */
+				id watch (program & owner, std::vector<shader_file> stages, std::vector<std::string> defines=std::vector<std::string>{});
+				/**
+				 *	Stops watching a program.
+				 *
+				 *	\param [in] i
+				 *		The identifier of the program.
+				 */
+				void unwatch (id i) noexcept;
+				
+				
+				/**
+				 *	Installs programs which have finished rebuilding and
+				 *	starts rebuilding programs whose files changed.
+				 *
+				 *	When nothing has changed and nothing is being rebuilt
+				 *	this only loads an atomic flag.
+				 */
+				void poll ();
+				
+				
+				/**
+				 *	Retrieves the number of programs which have been
+				 *	replaced.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t reloads () const noexcept;
+				/**
+				 *	Retrieves the number of rebuilds which failed.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t failures () const noexcept;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,175 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	Merges many small strips, fans, or loops into a single
+		 *	index stream in which consecutive primitives are
+		 *	separated by the primitive restart index, so that they
+		 *	may all be submitted with a single draw call.
+		 *
+		 *	Each primitive's indices are rebased by the offset of
+		 *	its vertices within a vertex buffer shared by every
+		 *	primitive in the batch.
+		 *
+		 *	The restart index is always the greatest value of
+		 *	index_type, which is the index
+		 *	GL_PRIMITIVE_RESTART_FIXED_INDEX uses, therefore that
+		 *	vertex may not be referenced.
+		 */
+		class strip_batch {
+			
+			
+			private:
+			
+			
+				GLenum mode_;
+				std::vector<std::uint32_t> indices_;
+				std::size_t primitives_;
+				std::uint32_t max_;
+				
+				
+				void begin_primitive ();
+			
+			
+			public:
+			
+			
+				/**
+				 *	Creates an empty batch.
+				 *
+				 *	\param [in] mode
+				 *		GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN,
+				 *		GL_LINE_STRIP, or GL_LINE_LOOP.
+				 */
+				explicit strip_batch (GLenum mode);
+				
+				
+				/**
+				 *	Appends an indexed primitive.
+				 *
+				 *	\param [in] indices
+				 *		The indices of the primitive, relative to
+				 *		\em base_vertex.
+				 *	\param [in] count
+				 *		The number of indices.  Primitives with no
+				 *		indices are ignored.
+				 *	\param [in] base_vertex
+				 *		The index of the primitive's first vertex in
+				 *		the shared vertex buffer.
+				 */
+				void add (const std::uint32_t * indices, std::size_t count, std::uint32_t base_vertex=0);
+				/**
+				 *	Appends a primitive made of consecutive vertices,
+				 *	as would be drawn by glDrawArrays.
+				 *
+				 *	\param [in] first
+				 *		The index of the first vertex in the shared
+				 *		vertex buffer.
+				 *	\param [in] count
+				 *		The number of vertices.  Primitives with no
+				 *		vertices are ignored.
+				 */
+				void add (std::uint32_t first, std::size_t count);
+				/**
+				 *	Removes every primitive.
+				 */
+				void clear () noexcept;
+				
+				
+				GLenum mode () const noexcept;
+				/**
+				 *	Retrieves the number of primitives which have been
+				 *	added.
+				 *
+				 *	\return
+				 *		The number of draw calls the batch replaces.
+				 */
+				std::size_t primitives () const noexcept;
+				/**
+				 *	Retrieves the number of indices in the merged
+				 *	stream, including restart indices.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t index_count () const noexcept;
+				/**
+				 *	Determines the narrowest index type which can
+				 *	represent every index and the restart index.
+				 *
+				 *	\return
+				 *		GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+				 */
+				GLenum index_type () const noexcept;
+				/**
+				 *	Retrieves the index which separates primitives.
+				 *
+				 *	\return
+				 *		0xFFFF or 0xFFFFFFFF depending on index_type.
+				 */
+				GLuint restart_index () const noexcept;
+				
+				
+				/**
+				 *	Packs the merged stream as index_type.
+				 *
+				 *	\return
+				 *		The bytes of the indices.
+				 */
+				std::vector<std::uint8_t> indices () const;
+				/**
+				 *	Replaces the data store of a buffer with the merged
+				 *	stream.
+				 *
+				 *	\param [in] b
+				 *		The buffer, which is bound to
+				 *		GL_COPY_WRITE_BUFFER so that the element
+				 *		buffer of the current vertex array is not
+				 *		disturbed.
+				 *	\param [in] usage
+				 *		The usage hint passed to glBufferData.
+				 */
+				void upload (const buffer & b, GLenum usage=GL_STATIC_DRAW) const;
+				/**
+				 *	Draws every primitive with a single call to
+				 *	glDrawElements.
+				 *
+				 *	The merged stream must be in the element buffer
+				 *	of the current vertex array, as placed by upload.
+				 *	GL_PRIMITIVE_RESTART_FIXED_INDEX is enabled when
+				 *	ARB_ES3_compatibility is available, otherwise
+				 *	GL_PRIMITIVE_RESTART is enabled with the restart
+				 *	index set through primitive_restart_index.  Either
+				 *	way the previous state is restored.
+				 *
+				 *	\param [in] offset
+				 *		The offset of the stream within the element
+				 *		buffer.
+				 */
+				void draw (std::size_t offset=0) const;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
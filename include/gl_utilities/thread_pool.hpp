@@ -0,0 +1,133 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	/**
+	 *	A fixed size pool of worker threads which execute
+	 *	tasks in the order they were enqueued.
+	 */
+	class thread_pool {
+		
+		
+		private:
+		
+		
+			std::mutex m_;
+			std::condition_variable cv_;
+			std::deque<std::function<void ()>> queue_;
+			bool stop_;
+			std::vector<std::thread> threads_;
+			
+			
+			void worker ();
+			void push (std::function<void ()> task);
+		
+		
+		public:
+		
+		
+			thread_pool (const thread_pool &) = delete;
+			thread_pool (thread_pool &&) = delete;
+			thread_pool & operator = (const thread_pool &) = delete;
+			thread_pool & operator = (thread_pool &&) = delete;
+			
+			
+			/**
+			 *	Starts worker threads.
+			 *
+			 *	\param [in] threads
+			 *		The number of worker threads to start.  If
+			 *		zero one thread per hardware thread is started.
+			 *		Defaults to zero.
+			 */
+			explicit thread_pool (std::size_t threads=0);
+			
+			
+			/**
+			 *	Executes all tasks which have already been enqueued
+			 *	and then joins all worker threads.
+			 */
+			~thread_pool () noexcept;
+			
+			
+			/**
+			 *	Retrieves the number of worker threads.
+			 *
+			 *	\return
+			 *		An integer.
+			 */
+			std::size_t size () const noexcept;
+			
+			
+			/**
+			 *	Enqueues a task.
+			 *
+			 *	\param [in] f
+			 *		A callable object which will be invoked with
+			 *		no arguments on a worker thread.
+			 *
+			 *	\return
+			 *		A future which will become ready when \em f
+			 *		returns or throws.
+			 */
+			template <typename F>
+			std::future<typename std::result_of<F ()>::type> enqueue (F && f) {
+				
+				using type=typename std::result_of<F ()>::type;
+				auto task=std::make_shared<std::packaged_task<type ()>>(std::forward<F>(f));
+				auto retr=task->get_future();
+				push([task] () {	(*task)();	});
+				
+				return retr;
+				
+			}
+			
+			
+			/**
+			 *	Divides a range into contiguous chunks and executes
+			 *	a function on each chunk in parallel, returning once
+			 *	all chunks are done.
+			 *
+			 *	The calling thread executes chunks as well, therefore
+			 *	this function must not be called from a worker thread
+			 *	of the same pool.
+			 *
+			 *	If any invocation throws the exception thrown by the
+			 *	invocation on the earliest chunk is rethrown after all
+			 *	chunks have completed.
+			 *
+			 *	\param [in] begin
+			 *		The first index in the range.
+			 *	\param [in] end
+			 *		One past the last index in the range.
+			 *	\param [in] func
+			 *		A function which will be invoked with the bounds
+			 *		of each chunk.
+			 */
+			void parallel_for (std::size_t begin, std::size_t end, const std::function<void (std::size_t, std::size_t)> & func);
+		
+		
+	};
+	
+	
+}
@@ -0,0 +1,262 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "hash.hpp"
+#include "opengl.hpp"
+#include "preprocessor.hpp"
+#include "program_cache.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	A shader stage loaded from a file.
+		 */
+		class shader_file {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The type of shader.
+				 */
+				GLenum type;
+				std::string filename;
+			
+			
+		};
+		
+		
+		/**
+		 *	Describes one permutation of a program: the files which
+		 *	make up its stages and the preprocessor definitions
+		 *	injected into each of them.
+		 */
+		class shader_variant {
+			
+			
+			public:
+			
+			
+				std::vector<shader_file> stages;
+				/**
+				 *	See inject_defines.  Order and repetition do not
+				 *	matter.
+				 */
+				std::vector<std::string> defines;
+			
+			
+		};
+		
+		
+		/**
+		 *	The canonical key of a shader_variant, as computed by
+		 *	variant_cache::key.
+		 *
+		 *	Computing a key canonicalizes the path of every stage,
+		 *	which requires the file system, so code which requests
+		 *	the same variant repeatedly (e.g. once per draw) should
+		 *	compute its key once and pass it to variant_cache::get.
+		 */
+		class variant_key {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The 64 bit FNV-1a hash of \em text.
+				 */
+				std::uint64_t hash;
+				/**
+				 *	The stages sorted by type with canonical paths
+				 *	followed by the canonical definitions.
+				 */
+				std::string text;
+				
+				
+				bool operator == (const variant_key & other) const noexcept {
+					
+					return (hash==other.hash) && (text==other.text);
+					
+				}
+				bool operator != (const variant_key & other) const noexcept {
+					
+					return !(*this==other);
+					
+				}
+			
+			
+		};
+		
+		
+		/**
+		 *	Creates programs for shader variants on demand, building
+		 *	each distinct variant exactly once.
+		 *
+		 *	Variants are identified by a canonical key (the stages
+		 *	sorted by type with canonical paths and the canonical
+		 *	definitions) so that variants which differ only in the
+		 *	order of their definitions or in how their files are
+		 *	reached share a program.
+		 *
+		 *	All member functions must be called on the thread to which
+		 *	the OpenGL context is bound.
+		 */
+		class variant_cache {
+			
+			
+			private:
+			
+			
+				class hasher {
+					
+					
+					public:
+					
+					
+						std::size_t operator () (const variant_key & key) const noexcept {
+							
+							return std::size_t(key.hash);
+							
+						}
+					
+					
+				};
+				
+				
+				shader_preprocessor & pre_;
+				program_cache * binaries_;
+				std::unordered_map<variant_key,program,hasher> programs_;
+				std::size_t builds_;
+				
+				
+				std::vector<shader_source> sources (const shader_variant &, const std::vector<std::string> &);
+			
+			
+			public:
+			
+			
+				variant_cache (const variant_cache &) = delete;
+				variant_cache & operator = (const variant_cache &) = delete;
+				
+				
+				/**
+				 *	Creates a variant cache.
+				 *
+				 *	\param [in] pre
+				 *		The preprocessor used to load stages, which must
+				 *		outlive the cache.
+				 *	\param [in] binaries
+				 *		A program cache through which programs are built,
+				 *		or \em nullptr to always compile.  If not
+				 *		\em nullptr must outlive the cache.
+				 */
+				explicit variant_cache (shader_preprocessor & pre, program_cache * binaries=nullptr) noexcept;
+				
+				
+				/**
+				 *	Computes the canonical key of a variant.
+				 *
+				 *	\param [in] v
+				 *		The variant.
+				 *
+				 *	\return
+				 *		The key.
+				 */
+				static variant_key key (const shader_variant & v);
+				
+				
+				/**
+				 *	Retrieves the program for a variant, building it if
+				 *	this is the first time it has been requested.
+				 *
+				 *	Computes the key of the variant on every call, see
+				 *	variant_key.
+				 *
+				 *	\param [in] v
+				 *		The variant.
+				 *
+				 *	\return
+				 *		A reference to the program, which remains valid
+				 *		until the cache is cleared or destroyed.
+				 */
+				const program & get (const shader_variant & v);
+				/**
+				 *	Retrieves the program for a variant whose key has
+				 *	already been computed, building it if this is the
+				 *	first time it has been requested.
+				 *
+				 *	When the program has already been built this
+				 *	performs a single hash table lookup.
+				 *
+				 *	\param [in] k
+				 *		The key of \em v as returned by key.
+				 *	\param [in] v
+				 *		The variant.
+				 *
+				 *	\return
+				 *		A reference to the program, which remains valid
+				 *		until the cache is cleared or destroyed.
+				 */
+				const program & get (const variant_key & k, const shader_variant & v);
+				/**
+				 *	Builds the programs for many variants at once.
+				 *
+				 *	Variants which have already been built are skipped.
+				 *	Without a program cache the remaining variants are
+				 *	built as a program_batch, so the implementation may
+				 *	compile them concurrently.
+				 *
+				 *	\param [in] variants
+				 *		The variants.
+				 */
+				void prewarm (const std::vector<shader_variant> & variants);
+				
+				
+				/**
+				 *	Retrieves the number of distinct variants which have
+				 *	been built.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t size () const noexcept;
+				/**
+				 *	Retrieves the number of programs which have been
+				 *	built (or loaded from the program cache).  Since each
+				 *	variant is built once this never exceeds size unless
+				 *	the cache has been cleared.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t builds () const noexcept;
+				/**
+				 *	Destroys every program.
+				 */
+				void clear () noexcept;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
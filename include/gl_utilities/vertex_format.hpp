@@ -0,0 +1,728 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include <unordered_map>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	Encapsulates a mismatch between the attributes a
+		 *	vertex format provides and those a program consumes.
+		 */
+		class vertex_format_error : public error {
+			
+			
+			public:
+			
+			
+				using error::error;
+			
+			
+		};
+		
+		
+		/**
+		 *	Conventional attribute locations.  Formats and shaders
+		 *	which agree on these need not agree on names.
+		 */
+		namespace semantic {
+			
+			
+			constexpr GLuint position=0;
+			constexpr GLuint normal=1;
+			constexpr GLuint tangent=2;
+			constexpr GLuint color=3;
+			constexpr GLuint texcoord0=4;
+			constexpr GLuint texcoord1=5;
+			constexpr GLuint joints=6;
+			constexpr GLuint weights=7;
+			
+			
+		}
+		
+		
+		/**
+		 *	How the components of an attribute are presented to
+		 *	the vertex shader.
+		 */
+		enum class conversion {
+			
+			/**
+			 *	Converted to floating point as is (i.e. 255 becomes
+			 *	255.0).
+			 */
+			floating,
+			/**
+			 *	Converted to floating point and normalized to [0,1]
+			 *	or [-1,1] (i.e. 255 becomes 1.0 for unsigned bytes).
+			 */
+			normalized,
+			/**
+			 *	Left as integers, for int and uint shader inputs.
+			 */
+			integer
+			
+		};
+		
+		
+		/**
+		 *	Maps C++ types to the OpenGL enumeration for the
+		 *	corresponding component type.
+		 *
+		 *	\tparam T
+		 *		The type of a single component.
+		 */
+		template <typename T>
+		class component_traits;
+		
+		
+		template <GLenum Type, bool Integer, bool Packed=false>
+		class basic_component_traits {
+			
+			
+			public:
+			
+			
+				static constexpr GLenum type=Type;
+				/**
+				 *	Whether the type may be used with
+				 *	conversion::integer.
+				 */
+				static constexpr bool integer=Integer;
+				/**
+				 *	Whether a single value of the type holds all four
+				 *	components of an attribute.
+				 */
+				static constexpr bool packed=Packed;
+			
+			
+		};
+		
+		
+		/**
+		 *	A half precision float, as produced by
+		 *	pixel::float_to_half.
+		 */
+		class half {
+			
+			
+			public:
+			
+			
+				std::uint16_t bits;
+			
+			
+		};
+		
+		
+		/**
+		 *	Four signed components packed into 10, 10, 10, and 2
+		 *	bits, as produced by quantize::pack_snorm_2_10_10_10.
+		 */
+		class packed_2_10_10_10 {
+			
+			
+			public:
+			
+			
+				std::uint32_t bits;
+			
+			
+		};
+		
+		
+		/**
+		 *	Four unsigned components packed into 10, 10, 10, and
+		 *	2 bits.
+		 */
+		class packed_unsigned_2_10_10_10 {
+			
+			
+			public:
+			
+			
+				std::uint32_t bits;
+			
+			
+		};
+		
+		
+		template <>
+		class component_traits<GLbyte> : public basic_component_traits<GL_BYTE,true> {	};
+		template <>
+		class component_traits<GLubyte> : public basic_component_traits<GL_UNSIGNED_BYTE,true> {	};
+		template <>
+		class component_traits<GLshort> : public basic_component_traits<GL_SHORT,true> {	};
+		template <>
+		class component_traits<GLushort> : public basic_component_traits<GL_UNSIGNED_SHORT,true> {	};
+		template <>
+		class component_traits<GLint> : public basic_component_traits<GL_INT,true> {	};
+		template <>
+		class component_traits<GLuint> : public basic_component_traits<GL_UNSIGNED_INT,true> {	};
+		template <>
+		class component_traits<GLfloat> : public basic_component_traits<GL_FLOAT,false> {	};
+		template <>
+		class component_traits<GLdouble> : public basic_component_traits<GL_DOUBLE,false> {	};
+		template <>
+		class component_traits<half> : public basic_component_traits<GL_HALF_FLOAT,false> {	};
+		template <>
+		class component_traits<packed_2_10_10_10> : public basic_component_traits<GL_INT_2_10_10_10_REV,false,true> {	};
+		template <>
+		class component_traits<packed_unsigned_2_10_10_10> : public basic_component_traits<GL_UNSIGNED_INT_2_10_10_10_REV,false,true> {	};
+		
+		
+		/**
+		 *	Describes a single attribute at runtime, see
+		 *	vertex_attribute.
+		 */
+		class vertex_attribute_description {
+			
+			
+			public:
+			
+			
+				GLuint location;
+				GLint count;
+				GLenum type;
+				conversion convert;
+				std::size_t offset;
+			
+			
+		};
+		
+		
+		/**
+		 *	Describes a vertex format at runtime, see
+		 *	vertex_format::layout.
+		 */
+		class vertex_layout {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The attributes.  Every vertex_format has a single
+				 *	array of attributes so this pointer identifies
+				 *	the format.
+				 */
+				const vertex_attribute_description * attributes;
+				std::size_t count;
+				GLsizei stride;
+			
+			
+		};
+		
+		
+		/**
+		 *	Describes one attribute of a vertex format at compile
+		 *	time.
+		 *
+		 *	\tparam Location
+		 *		The location of the attribute, see semantic.
+		 *	\tparam Component
+		 *		The type of each component, or of all four
+		 *		components for packed types such as
+		 *		packed_2_10_10_10.
+		 *	\tparam Count
+		 *		The number of components, between 1 and 4.
+		 *	\tparam Offset
+		 *		The offset of the attribute within a vertex,
+		 *		typically given by offsetof.
+		 *	\tparam Conversion
+		 *		How components are presented to the shader.
+		 */
+		template <GLuint Location, typename Component, GLint Count, std::size_t Offset, conversion Conversion=conversion::floating>
+		class vertex_attribute {
+			
+			
+			static_assert((Count>=1) && (Count<=4),"Attributes must have between 1 and 4 components");
+			static_assert((Conversion!=conversion::integer) || component_traits<Component>::integer,"Only integer components may be presented as integers");
+			static_assert(!component_traits<Component>::packed || (Count==4),"Packed attributes must have 4 components");
+			
+			
+			public:
+			
+			
+				static constexpr GLuint location=Location;
+				static constexpr GLint count=Count;
+				static constexpr GLenum type=component_traits<Component>::type;
+				static constexpr std::size_t offset=Offset;
+				static constexpr std::size_t size=component_traits<Component>::packed ? sizeof(Component) : (sizeof(Component)*std::size_t(Count));
+				
+				
+				static constexpr vertex_attribute_description description () noexcept {
+					
+					return vertex_attribute_description{Location,Count,type,Conversion,Offset};
+					
+				}
+			
+			
+		};
+		
+		
+		/**
+		 *	Makes an attribute of the vertex array which is
+		 *	currently bound read from the buffer which is currently
+		 *	bound to GL_ARRAY_BUFFER, and enables it.
+		 *
+		 *	\param [in] d
+		 *		The attribute.
+		 *	\param [in] stride
+		 *		The number of bytes between consecutive vertices.
+		 *	\param [in] base
+		 *		The offset of the first vertex within the buffer.
+		 */
+		void set_vertex_attribute (const vertex_attribute_description & d, GLsizei stride, std::size_t base);
+		/**
+		 *	Specifies the format of an attribute of the vertex array
+		 *	which is currently bound, associates it with a binding
+		 *	point, and enables it.  Requires ARB_vertex_attrib_binding.
+		 *
+		 *	\param [in] d
+		 *		The attribute.
+		 *	\param [in] binding
+		 *		The index of the binding point.
+		 */
+		void set_vertex_attribute_format (const vertex_attribute_description & d, GLuint binding);
+		/**
+		 *	Checks that every active attribute of a program is
+		 *	provided by a set of attributes with a compatible type.
+		 *
+		 *	Attributes consumed by the program but not provided
+		 *	would read the current generic attribute value, and
+		 *	integer inputs fed floating point data (or vice versa)
+		 *	read undefined values.
+		 *
+		 *	\param [in] p
+		 *		The program.
+		 *	\param [in] begin
+		 *		The first attribute provided.
+		 *	\param [in] count
+		 *		The number of attributes provided.
+		 */
+		void validate_vertex_attributes (const program & p, const vertex_attribute_description * begin, std::size_t count);
+		
+		
+		/**
+		 *	Describes the layout of a vertex type at compile time.
+		 *
+		 *	\tparam Vertex
+		 *		The vertex type, which must be standard layout.
+		 *	\tparam Attributes
+		 *		vertex_attribute instantiations describing its
+		 *		fields.
+		 */
+		template <typename Vertex, typename... Attributes>
+		class vertex_format {
+			
+			
+			private:
+			
+			
+				static constexpr bool fits (std::size_t offset, std::size_t size) noexcept {
+					
+					return (offset+size)<=sizeof(Vertex);
+					
+				}
+				
+				
+				static constexpr bool all (std::initializer_list<bool> bs) noexcept {
+					
+					for (auto b : bs) if (!b) return false;
+					
+					return true;
+					
+				}
+				
+				
+				static_assert(sizeof...(Attributes)!=0,"Vertex formats must have at least one attribute");
+				static_assert(std::is_standard_layout<Vertex>::value,"Vertex types must be standard layout");
+				static_assert(all({fits(Attributes::offset,Attributes::size)...}),"Attributes must lie within the vertex");
+			
+			
+			public:
+			
+			
+				using vertex_type=Vertex;
+				
+				
+				/**
+				 *	The number of bytes between consecutive vertices.
+				 */
+				static constexpr GLsizei stride=GLsizei(sizeof(Vertex));
+				/**
+				 *	The number of attributes.
+				 */
+				static constexpr std::size_t count=sizeof...(Attributes);
+				
+				
+				/**
+				 *	Sets up a vertex array to read vertices of this
+				 *	format from a buffer.
+				 *
+				 *	Expands to one call per attribute with every
+				 *	argument a constant.
+				 *
+				 *	\param [in] vao
+				 *		The vertex array.
+				 *	\param [in] vertices
+				 *		The buffer containing the vertices.
+				 *	\param [in] base
+				 *		The offset of the first vertex within
+				 *		\em vertices.  Defaults to 0.
+				 */
+				static void apply (const vertex_array & vao, const buffer & vertices, std::size_t base=0) {
+					
+					auto vg=vao.bind();
+					auto bg=vertices.bind(GL_ARRAY_BUFFER);
+					const int expand []={(set_vertex_attribute(Attributes::description(),stride,base),0)...};
+					(void)expand;
+					
+				}
+				
+				
+				/**
+				 *	Checks that this format provides every attribute
+				 *	a program consumes, see validate_vertex_attributes.
+				 *
+				 *	\param [in] p
+				 *		The program.
+				 */
+				static void validate (const program & p) {
+					
+					auto l=layout();
+					validate_vertex_attributes(p,l.attributes,l.count);
+					
+				}
+				
+				
+				/**
+				 *	Sets up a vertex array to read vertices of this
+				 *	format from whichever buffer is bound to a binding
+				 *	point, so that the vertex array may be reused for
+				 *	any buffer.  Requires ARB_vertex_attrib_binding.
+				 *
+				 *	\param [in] vao
+				 *		The vertex array.
+				 *	\param [in] binding
+				 *		The index of the binding point.  Defaults to 0.
+				 */
+				static void apply_format (const vertex_array & vao, GLuint binding=0) {
+					
+					auto vg=vao.bind();
+					const int expand []={(set_vertex_attribute_format(Attributes::description(),binding),0)...};
+					(void)expand;
+					
+				}
+				
+				
+				/**
+				 *	Retrieves a runtime description of this format.
+				 *
+				 *	\return
+				 *		The layout.
+				 */
+				static vertex_layout layout () noexcept {
+					
+					static const vertex_attribute_description descriptions []={Attributes::description()...};
+					
+					return vertex_layout{descriptions,count,stride};
+					
+				}
+			
+			
+		};
+		
+		
+		/**
+		 *	Hands out vertex arrays which are ready to draw vertices
+		 *	of a certain format from certain buffers.
+		 *
+		 *	Where ARB_vertex_attrib_binding is supported a single
+		 *	vertex array is kept for each format and only its buffer
+		 *	bindings are changed when different buffers are requested.
+		 *	Otherwise a vertex array is kept for each distinct
+		 *	combination of format and buffers.
+		 *
+		 *	Since vertex arrays keep the buffers they refer to alive
+		 *	and buffer names may be reused, forget must be called
+		 *	before a buffer passed to get is destroyed.
+		 *
+		 *	All member functions must be called on the thread to which
+		 *	the OpenGL context is bound.
+		 */
+		class vertex_array_cache {
+			
+			
+			private:
+			
+			
+				class key {
+					
+					
+					public:
+					
+					
+						const vertex_attribute_description * attributes;
+						GLuint vertices;
+						GLintptr base;
+						GLuint elements;
+						
+						
+						bool operator == (const key & other) const noexcept;
+					
+					
+				};
+				
+				
+				class hasher {
+					
+					
+					public:
+					
+					
+						std::size_t operator () (const key & k) const noexcept;
+					
+					
+				};
+				
+				
+				class entry {
+					
+					
+					public:
+					
+					
+						vertex_array vao;
+						GLuint vertices;
+						GLintptr base;
+						GLuint elements;
+					
+					
+				};
+				
+				
+				bool shared_;
+				std::unordered_map<key,entry,hasher> map_;
+				std::size_t rebinds_;
+				
+				
+				entry & get_entry (const vertex_layout &, const buffer &, GLintptr, GLuint);
+				bool stale (const entry &, const buffer &, GLintptr, GLuint) const noexcept;
+				void rebind (entry &, const vertex_layout &, const buffer &, GLintptr, GLuint);
+			
+			
+			public:
+			
+			
+				vertex_array_cache (const vertex_array_cache &) = delete;
+				vertex_array_cache & operator = (const vertex_array_cache &) = delete;
+				
+				
+				vertex_array_cache ();
+				
+				
+				/**
+				 *	Retrieves a vertex array which reads vertices of a
+				 *	certain format from certain buffers.
+				 *
+				 *	\param [in] layout
+				 *		The format, see vertex_format::layout.
+				 *	\param [in] vertices
+				 *		The buffer containing the vertices.
+				 *	\param [in] base
+				 *		The offset of the first vertex within
+				 *		\em vertices.
+				 *	\param [in] elements
+				 *		The buffer containing indices, or \em nullptr.
+				 *
+				 *	\return
+				 *		A reference to a vertex array, which remains
+				 *		valid until the next call to get, forget, or
+				 *		clear.
+				 */
+				const vertex_array & get (const vertex_layout & layout, const buffer & vertices, GLintptr base=0, const buffer * elements=nullptr);
+				template <typename Format>
+				const vertex_array & get (const buffer & vertices, GLintptr base=0, const buffer * elements=nullptr) {
+					
+					return get(Format::layout(),vertices,base,elements);
+					
+				}
+				
+				
+				/**
+				 *	Binds a vertex array which reads vertices of a
+				 *	certain format from certain buffers.
+				 *
+				 *	Equivalent to binding the vertex array returned by
+				 *	get but, when buffer bindings must be changed, only
+				 *	binds the vertex array once.
+				 *
+				 *	\param [in] layout
+				 *		The format, see vertex_format::layout.
+				 *	\param [in] vertices
+				 *		The buffer containing the vertices.
+				 *	\param [in] base
+				 *		The offset of the first vertex within
+				 *		\em vertices.
+				 *	\param [in] elements
+				 *		The buffer containing indices, or \em nullptr.
+				 *
+				 *	\return
+				 *		A guard which restores the previously bound
+				 *		vertex array.
+				 */
+				vertex_array::guard bind (const vertex_layout & layout, const buffer & vertices, GLintptr base=0, const buffer * elements=nullptr);
+				template <typename Format>
+				vertex_array::guard bind (const buffer & vertices, GLintptr base=0, const buffer * elements=nullptr) {
+					
+					return bind(Format::layout(),vertices,base,elements);
+					
+				}
+				
+				
+				/**
+				 *	Releases every vertex array which refers to a
+				 *	buffer.
+				 *
+				 *	\param [in] b
+				 *		The buffer.
+				 */
+				void forget (const buffer & b) noexcept;
+				/**
+				 *	Releases every vertex array.
+				 */
+				void clear () noexcept;
+				
+				
+				/**
+				 *	Determines whether vertex arrays are shared between
+				 *	buffers of the same format.
+				 *
+				 *	\return
+				 *		\em true if ARB_vertex_attrib_binding is
+				 *		supported, \em false otherwise.
+				 */
+				bool shared () const noexcept;
+				/**
+				 *	Retrieves the number of vertex arrays held.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t size () const noexcept;
+				/**
+				 *	Retrieves the number of times the buffer bindings of
+				 *	a shared vertex array were changed.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t rebinds () const noexcept;
+			
+			
+		};
+		
+		
+		/**
+		 *	A vertex array set up for a vertex format which
+		 *	validates the format against each program it is bound
+		 *	for only when the program changes, so that mismatches
+		 *	are reported once rather than checked on every draw.
+		 *
+		 *	\tparam Format
+		 *		A vertex_format instantiation.
+		 */
+		template <typename Format>
+		class vertex_binding {
+			
+			
+			private:
+			
+			
+				vertex_array vao_;
+				GLuint validated_;
+			
+			
+			public:
+			
+			
+				/**
+				 *	Creates a vertex array and sets it up to read
+				 *	from a buffer.
+				 *
+				 *	\param [in] vertices
+				 *		The buffer containing the vertices.
+				 *	\param [in] base
+				 *		The offset of the first vertex within
+				 *		\em vertices.  Defaults to 0.
+				 */
+				explicit vertex_binding (const buffer & vertices, std::size_t base=0) : validated_(0) {
+					
+					Format::apply(vao_,vertices,base);
+					
+				}
+				
+				
+				/**
+				 *	Binds the vertex array to draw with a certain
+				 *	program, validating the format against the
+				 *	program if it was not the last one bound for.
+				 *
+				 *	\param [in] p
+				 *		The program.
+				 *
+				 *	\return
+				 *		A guard which restores the previously bound
+				 *		vertex array.
+				 */
+				vertex_array::guard bind (const program & p) {
+					
+					if (GLuint(p)!=validated_) {
+						
+						Format::validate(p);
+						validated_=p;
+						
+					}
+					
+					return vao_.bind();
+					
+				}
+				
+				
+				/**
+				 *	Retrieves the vertex array.
+				 *
+				 *	\return
+				 *		A reference to the vertex array.
+				 */
+				const vertex_array & array () const noexcept {
+					
+					return vao_;
+					
+				}
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,200 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include "vertex_format.hpp"
+#include <string>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	Where the vertex shader fetches pulled vertices from.
+		 */
+		enum class vertex_pulling_storage {
+			
+			/**
+			 *	A shader storage buffer, bound by binding point.
+			 *	Requires GLSL 4.30 or ARB_shader_storage_buffer_object.
+			 */
+			shader_storage,
+			/**
+			 *	A buffer texture with the internal format GL_R32UI,
+			 *	read through a usamplerBuffer uniform which must be
+			 *	set to the texture unit.
+			 */
+			texture_buffer
+			
+		};
+		
+		
+		/**
+		 *	Generates GLSL which fetches the attributes of a vertex
+		 *	layout from a buffer by vertex index, so that a vertex
+		 *	shader may read vertices without any attributes being
+		 *	set up.
+		 *
+		 *	For each attribute a function named
+		 *	<prefix>_attribute<location> is generated which accepts
+		 *	a vertex index (typically gl_VertexID, which includes
+		 *	the base vertex) and returns the attribute converted
+		 *	exactly as the attribute would be converted by the fixed
+		 *	function vertex fetch.  Half float attributes require
+		 *	GLSL 4.20 or ARB_shading_language_packing.
+		 *
+		 *	The source is meant to be registered with
+		 *	shader_preprocessor::define and included.
+		 *
+		 *	Throws vertex_format_error if the stride is not a
+		 *	multiple of four, if a component straddles four byte
+		 *	words, or if an attribute has double components.
+		 *
+		 *	\param [in] layout
+		 *		The layout.
+		 *	\param [in] prefix
+		 *		A prefix for every identifier in the source, which
+		 *		must be a valid GLSL identifier.
+		 *	\param [in] binding
+		 *		The shader storage binding point, ignored for
+		 *		vertex_pulling_storage::texture_buffer.
+		 *	\param [in] storage
+		 *		Where the vertices are stored.
+		 *
+		 *	\return
+		 *		GLSL source.
+		 */
+		std::string vertex_pulling_source (const vertex_layout & layout, const std::string & prefix, GLuint binding, vertex_pulling_storage storage=vertex_pulling_storage::shader_storage);
+		/**
+		 *	Generates GLSL which fetches the attributes of a
+		 *	vertex_format, see vertex_pulling_source.
+		 *
+		 *	\tparam Format
+		 *		A vertex_format.
+		 */
+		template <typename Format>
+		std::string vertex_pulling_source (const std::string & prefix, GLuint binding, vertex_pulling_storage storage=vertex_pulling_storage::shader_storage) {
+			
+			return vertex_pulling_source(Format::layout(),prefix,binding,storage);
+			
+		}
+		
+		
+		/**
+		 *	Binds the buffers vertices are pulled from together
+		 *	with an empty vertex array, so that all geometry stored
+		 *	in those buffers may be drawn after binding once rather
+		 *	than once per mesh.
+		 *
+		 *	Indexed draws may still be made by giving the vertex
+		 *	array an element buffer (see vertex_array::element_buffer),
+		 *	since gl_VertexID is the index fetched from the element
+		 *	buffer plus the base vertex.
+		 */
+		class vertex_pulling {
+			
+			
+			private:
+			
+			
+				vertex_array vao_;
+				binding_table table_;
+			
+			
+			public:
+			
+			
+				/**
+				 *	Restores every binding vertex_pulling::bind
+				 *	replaced.
+				 */
+				class guard {
+					
+					
+					private:
+					
+					
+						vertex_array::guard vao_;
+						binding_table::guard table_;
+					
+					
+					public:
+					
+					
+						guard (vertex_array::guard vao, binding_table::guard table) noexcept;
+					
+					
+				};
+				
+				
+				/**
+				 *	Adds a shader storage buffer to bind.
+				 *
+				 *	\param [in] binding
+				 *		The binding point passed to
+				 *		vertex_pulling_source.
+				 *	\param [in] b
+				 *		The buffer.
+				 *	\param [in] offset
+				 *		The offset in bytes of the range to bind.
+				 *	\param [in] size
+				 *		The size in bytes of the range to bind, or
+				 *		zero to bind the entire buffer.
+				 *
+				 *	\return
+				 *		A reference to this object.
+				 */
+				vertex_pulling & add_storage (GLuint binding, const buffer & b, GLintptr offset=0, GLsizeiptr size=0);
+				/**
+				 *	Attaches a buffer to a buffer texture as GL_R32UI
+				 *	and adds the texture to bind.
+				 *
+				 *	\param [in] unit
+				 *		The texture unit the sampler uniform is set to.
+				 *	\param [in] tex
+				 *		The texture, which must outlive this object.
+				 *	\param [in] b
+				 *		The buffer.
+				 *
+				 *	\return
+				 *		A reference to this object.
+				 */
+				vertex_pulling & add_texture (GLuint unit, const texture & tex, const buffer & b);
+				
+				
+				/**
+				 *	Retrieves the empty vertex array, for example to
+				 *	give it an element buffer or to draw with
+				 *	multi_draw.
+				 *
+				 *	\return
+				 *		A reference to the vertex array.
+				 */
+				const vertex_array & vao () const noexcept;
+				
+				
+				/**
+				 *	Binds the empty vertex array and every buffer.
+				 *
+				 *	\return
+				 *		A guard which restores the previous bindings
+				 *		when it goes out of scope.
+				 */
+				guard bind () const;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
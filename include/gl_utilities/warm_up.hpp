@@ -0,0 +1,196 @@
+/**
+ *	\file
+ */
+
+
+#pragma once
+
+
+#include "opengl.hpp"
+#include "optional.hpp"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		/**
+		 *	A combination of a program and the pipeline state it
+		 *	will be drawn with.
+		 */
+		class warm_up_state {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The program to draw with.  Exactly one of this
+				 *	and \em pipeline must be set.
+				 */
+				const program * p=nullptr;
+				const program_pipeline * pipeline=nullptr;
+				/**
+				 *	The primitive mode (e.g. GL_TRIANGLES).
+				 */
+				GLenum mode=GL_TRIANGLES;
+				GLenum polygon_mode=GL_FILL;
+				/**
+				 *	Capabilities to enable (e.g. GL_BLEND), all
+				 *	others are left as they are.
+				 */
+				std::vector<GLenum> capabilities;
+				/**
+				 *	The internal format of the color attachment, or
+				 *	GL_NONE for none.
+				 */
+				GLenum color_format=GL_RGBA8;
+				/**
+				 *	The internal format of the depth and/or stencil
+				 *	attachment, or GL_NONE for none.
+				 */
+				GLenum depth_stencil_format=GL_NONE;
+			
+			
+		};
+		
+		
+		/**
+		 *	Forces the implementation to finish compiling programs
+		 *	before they are first used.
+		 *
+		 *	Implementations often defer the final stage of
+		 *	compilation until a program is first drawn with, since
+		 *	it depends on state such as the format of the render
+		 *	target and whether blending is enabled, and so the first
+		 *	frame to use a program hitches.  A warm up instead issues
+		 *	a tiny draw with each combination of program and state
+		 *	into a 1x1 offscreen frame buffer, spreading the draws
+		 *	across frames under a time budget.
+		 *
+		 *	All state changed to issue draws is restored.
+		 *
+		 *	All member functions must be called on the thread to which
+		 *	the OpenGL context is bound.
+		 */
+		class warm_up {
+			
+			
+			public:
+			
+			
+				/**
+				 *	The type of callback invoked after each draw with
+				 *	the number of states which have been drawn with and
+				 *	the total number of states.
+				 */
+				using progress_type=std::function<void (std::size_t, std::size_t)>;
+			
+			
+			private:
+			
+			
+				class target {
+					
+					
+					public:
+					
+					
+						frame_buffer fb;
+						optional<render_buffer> color;
+						optional<render_buffer> depth_stencil;
+					
+					
+				};
+				
+				
+				std::vector<warm_up_state> states_;
+				std::size_t done_;
+				progress_type progress_;
+				optional<vertex_array> vao_;
+				std::map<std::pair<GLenum,GLenum>,target> targets_;
+				
+				
+				target & get_target (GLenum, GLenum);
+				void draw (const warm_up_state &);
+			
+			
+			public:
+			
+			
+				warm_up (const warm_up &) = delete;
+				warm_up & operator = (const warm_up &) = delete;
+				
+				
+				/**
+				 *	Creates a warm up.
+				 *
+				 *	\param [in] progress
+				 *		A callback invoked after each draw.  May be
+				 *		empty.
+				 */
+				explicit warm_up (progress_type progress=progress_type{});
+				
+				
+				/**
+				 *	Adds a combination of program and state to draw
+				 *	with.
+				 *
+				 *	\param [in] state
+				 *		The state.  The program or pipeline it refers to
+				 *		must live until it has been drawn with.
+				 */
+				void add (warm_up_state state);
+				
+				
+				/**
+				 *	Issues draws until every state has been drawn with
+				 *	or the time budget is exhausted.  At least one draw
+				 *	is issued if any remain.
+				 *
+				 *	Once every state has been drawn with the offscreen
+				 *	frame buffers are freed.
+				 *
+				 *	\param [in] budget
+				 *		The time which may be spent.
+				 *
+				 *	\return
+				 *		\em true if every state has been drawn with,
+				 *		\em false otherwise.
+				 */
+				bool run (std::chrono::steady_clock::duration budget);
+				
+				
+				/**
+				 *	Retrieves the number of states which have been
+				 *	drawn with.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t done () const noexcept;
+				/**
+				 *	Retrieves the number of states which have been
+				 *	added.
+				 *
+				 *	\return
+				 *		An integer.
+				 */
+				std::size_t total () const noexcept;
+			
+			
+		};
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,6 @@
+#version 330
+#include "include/common.glsl"
+layout(location=0) in vec3 position;
+void main () {
+	gl_Position=vec4(position*scale(),1.0);
+}
@@ -0,0 +1,3 @@
+//	Quotes "like this", a backslash \ and a trigraph ??= must survive
+//	as must non-ASCII text: été →
+//	and a carriage return, and no final newline
\ No newline at end of file
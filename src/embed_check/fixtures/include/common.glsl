@@ -0,0 +1,3 @@
+float scale () {
+	return 2.0;
+}
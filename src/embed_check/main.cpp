@@ -0,0 +1,117 @@
+//	Checks that gl_utilities_embed_shaders embeds a set of fixture
+//	files byte for byte: that each can be found by name, and that
+//	its size, contents, and hash match the file on disk
+//
+//	Usage: embed_check <directory the fixtures were embedded from>
+//
+//	Exits with 1 if any check fails and 2 on any other error.
+
+
+#include <gl_utilities/embedded.hpp>
+#include <gl_utilities/hash.hpp>
+#include "embed_check_fixtures.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+	
+	
+	using namespace gl_utilities;
+	
+	
+	std::size_t failures=0;
+	
+	
+	void fail (const std::string & name, const char * what) {
+		
+		std::cout << "FAILED: " << name << ": " << what << '\n';
+		++failures;
+		
+	}
+	
+	
+	std::string read (const std::string & path) {
+		
+		std::ifstream is(path.c_str(),std::ios::binary);
+		if (!is) throw std::runtime_error("Could not open "+path);
+		
+		typedef std::istreambuf_iterator<char> iterator;
+		
+		return std::string(iterator(is),iterator{});
+		
+	}
+	
+	
+	//	Quotes, backslashes, trigraphs, carriage returns, bytes
+	//	outside ASCII, a file without a final newline, an empty
+	//	file, and a file in a subdirectory
+	const char * const names []={
+		"src/embed_check/fixtures/basic.vert",
+		"src/embed_check/fixtures/empty.glsl",
+		"src/embed_check/fixtures/escapes.frag",
+		"src/embed_check/fixtures/include/common.glsl"
+	};
+	
+	
+}
+
+
+int main (int argc, char ** argv) {
+	
+	try {
+		
+		if (argc!=2) throw std::runtime_error("Usage: embed_check <directory the fixtures were embedded from>");
+		std::string base(argv[1]);
+		
+		const auto & table=embed_check_fixtures;
+		if (table.count!=(sizeof(names)/sizeof(*names))) fail("table","wrong number of sources");
+		for (std::size_t i=1;i<table.count;++i) if (std::strcmp(table.sources[i-1].name,table.sources[i].name)>=0) fail(table.sources[i].name,"table is not sorted by name");
+		
+		for (auto name : names) {
+			
+			auto s=table.find(name);
+			if (s==nullptr) {
+				
+				fail(name,"not found");
+				continue;
+				
+			}
+			
+			auto contents=read(base+'/'+name);
+			if (s->size!=contents.size()) fail(name,"wrong size");
+			else if (std::memcmp(s->data,contents.data(),contents.size())!=0) fail(name,"wrong contents");
+			if (s->hash!=fnv1a(contents)) fail(name,"hash does not match the file");
+			if (s->hash!=fnv1a(s->data,s->size)) fail(name,"hash does not match the embedded contents");
+			
+		}
+		
+		if (table.find("src/embed_check/fixtures/missing.glsl")!=nullptr) fail("missing.glsl","found although it was not embedded");
+		if (table.find(std::string("src/embed_check/fixtures/basic.vert"))==nullptr) fail("basic.vert","not found by std::string");
+		
+		if (failures!=0) {
+			
+			std::cout << failures << " checks failed\n";
+			return EXIT_FAILURE;
+			
+		}
+		
+		std::cout << "All checks passed\n";
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		return 2;
+		
+	}
+	
+	return EXIT_SUCCESS;
+	
+}
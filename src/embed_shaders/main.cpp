@@ -0,0 +1,179 @@
+//	Converts shader source files into a table of embedded_source
+//	objects, see gl_utilities_embed_shaders in CMakeLists.txt
+//
+//	Usage: embed_shaders <name> <header> <source> <base directory> <files...>
+
+
+#include <gl_utilities/hash.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+	
+	
+	class file {
+		
+		
+		public:
+		
+		
+			std::string name;
+			std::string contents;
+		
+		
+	};
+	
+	
+	std::string read (const std::string & path) {
+		
+		std::ifstream is(path.c_str(),std::ios::binary);
+		if (!is) throw std::runtime_error("Could not open "+path);
+		
+		typedef std::istreambuf_iterator<char> iterator;
+		
+		return std::string(iterator(is),iterator{});
+		
+	}
+	
+	
+	void write (const std::string & path, const std::string & contents) {
+		
+		//	Leave the file untouched if it would not change
+		//	so that dependents are not rebuilt needlessly
+		{
+			
+			std::ifstream is(path.c_str(),std::ios::binary);
+			if (is) {
+				
+				typedef std::istreambuf_iterator<char> iterator;
+				if (std::string(iterator(is),iterator{})==contents) return;
+				
+			}
+			
+		}
+		
+		std::ofstream os(path.c_str(),std::ios::binary|std::ios::trunc);
+		os << contents;
+		os.flush();
+		if (!os) throw std::runtime_error("Could not write "+path);
+		
+	}
+	
+	
+	//	Every byte which is not printable is written as an
+	//	octal escape, and lines are broken after each newline
+	//	so that no single literal grows too long
+	void literal (std::ostream & os, const std::string & str) {
+		
+		os << '"';
+		for (std::size_t i=0;i<str.size();++i) {
+			
+			auto c=static_cast<unsigned char>(str[i]);
+			switch (c) {
+				
+				case '\n':
+					os << "\\n\"";
+					if ((i+1)<str.size()) os << "\n\t\t\"";
+					else return;
+					break;
+				case '"':
+				case '\\':
+				case '?':
+					os << '\\' << char(c);
+					break;
+				default:
+					if ((c<0x20) || (c>=0x7F)) {
+						
+						char buffer [5];
+						std::snprintf(buffer,sizeof(buffer),"\\%03o",unsigned(c));
+						os << buffer;
+						
+					} else {
+						
+						os << char(c);
+						
+					}
+					break;
+				
+			}
+			
+		}
+		os << '"';
+		
+	}
+	
+	
+	std::string relative (const std::string & path, const std::string & base) {
+		
+		auto prefix=base+'/';
+		if (path.compare(0,prefix.size(),prefix)==0) return path.substr(prefix.size());
+		
+		return path;
+		
+	}
+	
+	
+}
+
+
+int main (int argc, char ** argv) {
+	
+	try {
+		
+		if (argc<6) throw std::runtime_error("Usage: embed_shaders <name> <header> <source> <base directory> <files...>");
+		
+		std::string name(argv[1]);
+		std::string base(argv[4]);
+		std::vector<file> files;
+		for (int i=5;i<argc;++i) files.push_back(file{relative(argv[i],base),read(argv[i])});
+		//	Sorted so that embedded_table::find may binary search
+		std::sort(files.begin(),files.end(),[] (const file & a, const file & b) {	return a.name<b.name;	});
+		
+		std::ostringstream header;
+		header << "#pragma once\n\n\n#include <gl_utilities/embedded.hpp>\n\n\n"
+			<< "extern const gl_utilities::opengl::embedded_table " << name << ";\n";
+		write(argv[2],header.str());
+		
+		std::ostringstream source;
+		source << "#include \"" << name << ".hpp\"\n\n\nnamespace {\n\n\n";
+		for (std::size_t i=0;i<files.size();++i) {
+			
+			source << "\tconstexpr char data" << i << " []=";
+			if (files[i].contents.empty()) source << "\"\"";
+			else literal(source,files[i].contents);
+			source << ";\n";
+			
+		}
+		source << "\n\n\tconstexpr gl_utilities::opengl::embedded_source sources []={\n";
+		for (std::size_t i=0;i<files.size();++i) {
+			
+			source << "\t\t{";
+			literal(source,files[i].name);
+			source << ",data" << i << ',' << files[i].contents.size() << "U,0x"
+				<< std::hex << gl_utilities::fnv1a(files[i].contents) << std::dec << "ULL},\n";
+			
+		}
+		source << "\t};\n\n\n}\n\n\n"
+			<< "const gl_utilities::opengl::embedded_table " << name << "{sources," << files.size() << "U};\n";
+		write(argv[3],source.str());
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		
+		return 1;
+		
+	}
+	
+	return 0;
+	
+}
@@ -0,0 +1,102 @@
+#include <gl_utilities/mapped_file.hpp>
+#include <gl_utilities/system_error.hpp>
+#include <utility>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace gl_utilities {
+	
+	
+	void mapped_file::destroy () noexcept {
+		
+		if (data_==nullptr) return;
+		
+		munmap(data_,size_);
+		data_=nullptr;
+		size_=0;
+		
+	}
+	
+	
+	mapped_file::mapped_file () noexcept : data_(nullptr), size_(0) {	}
+	
+	
+	mapped_file::mapped_file (const std::string & filename) : data_(nullptr), size_(0) {
+		
+		auto fd=open(filename.c_str(),O_RDONLY|O_CLOEXEC);
+		if (fd==-1) raise();
+		
+		//	The mapping outlives the descriptor, which must be
+		//	closed without losing the error (if any)
+		auto fail=[&] () {
+			
+			auto e=errno;
+			close(fd);
+			errno=e;
+			raise();
+			
+		};
+		
+		struct stat s;
+		if (fstat(fd,&s)!=0) fail();
+		//	Empty files cannot be mapped
+		if (s.st_size!=0) {
+			
+			auto ptr=mmap(nullptr,std::size_t(s.st_size),PROT_READ,MAP_PRIVATE,fd,0);
+			if (ptr==MAP_FAILED) fail();
+			data_=ptr;
+			size_=std::size_t(s.st_size);
+			
+		}
+		
+		close(fd);
+		
+	}
+	
+	
+	mapped_file::mapped_file (mapped_file && other) noexcept : data_(other.data_), size_(other.size_) {
+		
+		other.data_=nullptr;
+		other.size_=0;
+		
+	}
+	
+	
+	mapped_file & mapped_file::operator = (mapped_file && other) noexcept {
+		
+		destroy();
+		
+		std::swap(other.data_,data_);
+		std::swap(other.size_,size_);
+		
+		return *this;
+		
+	}
+	
+	
+	mapped_file::~mapped_file () noexcept {
+		
+		destroy();
+		
+	}
+	
+	
+	const char * mapped_file::data () const noexcept {
+		
+		return static_cast<const char *>(data_);
+		
+	}
+	
+	
+	std::size_t mapped_file::size () const noexcept {
+		
+		return size_;
+		
+	}
+	
+	
+}
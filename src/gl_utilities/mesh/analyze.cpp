@@ -0,0 +1,54 @@
+#include <gl_utilities/mesh.hpp>
+#include <stdexcept>
+
+
+namespace gl_utilities {
+	
+	
+	namespace mesh {
+		
+		
+		statistics analyze (const std::uint32_t * indices, std::size_t count, std::size_t vertex_count, std::size_t cache_size) {
+			
+			if ((count%3)!=0) throw std::logic_error("Triangle lists must have a multiple of three indices");
+			if (cache_size==0) throw std::logic_error("Cache size must be positive");
+			
+			//	A vertex is in the cache if fewer than cache_size
+			//	vertices have been transformed since it was, a
+			//	stamp of zero is never in the cache
+			std::vector<std::size_t> stamps(vertex_count,0);
+			std::vector<bool> referenced(vertex_count,false);
+			auto time=cache_size+1;
+			std::size_t distinct=0;
+			statistics retr{0,0.0,0.0};
+			for (std::size_t i=0;i<count;++i) {
+				
+				auto v=indices[i];
+				if (v>=vertex_count) throw std::logic_error("Index out of range");
+				
+				if (!referenced[v]) {
+					
+					referenced[v]=true;
+					++distinct;
+					
+				}
+				
+				if ((time-stamps[v])<=cache_size) continue;
+				
+				stamps[v]=time++;
+				++retr.transformed;
+				
+			}
+			
+			if (count!=0) retr.acmr=double(retr.transformed)/double(count/3);
+			if (distinct!=0) retr.atvr=double(retr.transformed)/double(distinct);
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
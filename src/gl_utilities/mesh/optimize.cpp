@@ -0,0 +1,63 @@
+#include <gl_utilities/mesh.hpp>
+#include <cstring>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace mesh {
+		
+		
+		result optimize (const std::uint32_t * indices, std::size_t count, const void * vertices, std::size_t vertex_count, std::size_t vertex_size, const settings & s) {
+			
+			result retr;
+			retr.before=analyze(indices,count,vertex_count,s.cache_size);
+			
+			std::vector<std::uint32_t> is(indices,indices+count);
+			std::vector<std::uint8_t> vs;
+			auto vertex_data=vertices;
+			if (s.weld) {
+				
+				auto r=weld(vertices,vertex_count,vertex_size);
+				remap_indices(is.data(),is.size(),r);
+				vs=remap_vertices(vertices,vertex_size,r);
+				vertex_count=r.vertex_count;
+				vertex_data=vs.data();
+				
+			}
+			
+			is=optimize_vertex_cache(is.data(),is.size(),vertex_count,s.cache_size);
+			if (s.overdraw) is=optimize_overdraw(is.data(),is.size(),vertex_data,vertex_count,vertex_size,s.position_offset,s.cache_size,s.overdraw_threshold);
+			
+			auto r=optimize_vertex_fetch(is.data(),is.size(),vertex_count);
+			remap_indices(is.data(),is.size(),r);
+			retr.vertices=remap_vertices(vertex_data,vertex_size,r);
+			retr.vertex_count=r.vertex_count;
+			
+			retr.after=analyze(is.data(),is.size(),retr.vertex_count,s.cache_size);
+			
+			retr.index_count=is.size();
+			retr.index_type=s.narrow ? index_type(retr.vertex_count) : GL_UNSIGNED_INT;
+			if (retr.index_type==GL_UNSIGNED_SHORT) {
+				
+				auto narrowed=narrow(is.data(),is.size());
+				retr.indices.resize(narrowed.size()*sizeof(std::uint16_t));
+				std::memcpy(retr.indices.data(),narrowed.data(),retr.indices.size());
+				
+			} else {
+				
+				retr.indices.resize(is.size()*sizeof(std::uint32_t));
+				std::memcpy(retr.indices.data(),is.data(),retr.indices.size());
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,239 @@
+#include <gl_utilities/mesh.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace gl_utilities {
+	
+	
+	namespace mesh {
+		
+		
+		namespace {
+			
+			
+			using vector=std::array<double,3>;
+			
+			
+			class cluster {
+				
+				
+				public:
+				
+				
+					std::size_t begin;
+					std::size_t end;
+					double sort_key;
+				
+				
+			};
+			
+			
+			class cache {
+				
+				
+				private:
+				
+				
+					std::vector<std::size_t> & stamps_;
+					std::size_t size_;
+					std::size_t time_;
+				
+				
+				public:
+				
+				
+					cache (std::vector<std::size_t> & stamps, std::size_t size) noexcept : stamps_(stamps), size_(size), time_(0) {
+						
+						reset();
+						
+					}
+					
+					
+					//	Rather than clearing every stamp the clock is
+					//	advanced past every stamp which could still be
+					//	in the cache
+					void reset () noexcept {
+						
+						time_+=size_+1;
+						
+					}
+					
+					
+					std::size_t triangle (const std::uint32_t * t) noexcept {
+						
+						std::size_t misses=0;
+						for (std::size_t i=0;i<3;++i) {
+							
+							auto v=t[i];
+							if ((time_-stamps_[v])<=size_) continue;
+							
+							stamps_[v]=time_++;
+							++misses;
+							
+						}
+						
+						return misses;
+						
+					}
+				
+				
+			};
+			
+			
+			vector position (const std::uint8_t * vertices, std::size_t vertex_size, std::size_t position_offset, std::uint32_t v) noexcept {
+				
+				float f [3];
+				std::memcpy(f,vertices+(std::size_t(v)*vertex_size)+position_offset,sizeof(f));
+				
+				return vector{{f[0],f[1],f[2]}};
+				
+			}
+			
+			
+			vector sub (const vector & a, const vector & b) noexcept {
+				
+				return vector{{a[0]-b[0],a[1]-b[1],a[2]-b[2]}};
+				
+			}
+			
+			
+			vector cross (const vector & a, const vector & b) noexcept {
+				
+				return vector{{(a[1]*b[2])-(a[2]*b[1]),(a[2]*b[0])-(a[0]*b[2]),(a[0]*b[1])-(a[1]*b[0])}};
+				
+			}
+			
+			
+			double dot (const vector & a, const vector & b) noexcept {
+				
+				return (a[0]*b[0])+(a[1]*b[1])+(a[2]*b[2]);
+				
+			}
+			
+			
+		}
+		
+		
+		std::vector<std::uint32_t> optimize_overdraw (const std::uint32_t * indices, std::size_t count, const void * vertices, std::size_t vertex_count, std::size_t vertex_size, std::size_t position_offset, std::size_t cache_size, float threshold) {
+			
+			if ((count%3)!=0) throw std::logic_error("Triangle lists must have a multiple of three indices");
+			if (cache_size==0) throw std::logic_error("Cache size must be positive");
+			if ((position_offset+(3*sizeof(float)))>vertex_size) throw std::logic_error("Positions must lie within vertices");
+			for (std::size_t i=0;i<count;++i) if (indices[i]>=vertex_count) throw std::logic_error("Index out of range");
+			
+			auto triangles=count/3;
+			auto bytes=static_cast<const std::uint8_t *>(vertices);
+			std::vector<std::size_t> stamps(vertex_count,0);
+			
+			//	Hard boundaries are where the vertex cache ordering
+			//	jumped to an unrelated part of the mesh, i.e. where
+			//	a triangle misses on all three vertices, reordering
+			//	there costs nothing
+			std::vector<std::size_t> hard;
+			cache c(stamps,cache_size);
+			for (std::size_t t=0;t<triangles;++t) if (c.triangle(indices+(t*3))==3) hard.push_back(t);
+			hard.push_back(triangles);
+			
+			//	Hard clusters are split further wherever the miss
+			//	ratio so far is within the threshold of the miss
+			//	ratio of the entire cluster
+			std::vector<cluster> clusters;
+			for (std::size_t h=0;(h+1)<hard.size();++h) {
+				
+				auto begin=hard[h];
+				auto end=hard[h+1];
+				
+				c.reset();
+				std::size_t misses=0;
+				for (auto t=begin;t<end;++t) misses+=c.triangle(indices+(t*3));
+				auto limit=(double(misses)/double(end-begin))*double(threshold);
+				
+				c.reset();
+				misses=0;
+				auto start=begin;
+				for (auto t=begin;t<end;++t) {
+					
+					misses+=c.triangle(indices+(t*3));
+					if (((t+1)==end) || ((double(misses)/double((t+1)-start))>limit)) continue;
+					
+					clusters.push_back(cluster{start,t+1,0.0});
+					start=t+1;
+					misses=0;
+					c.reset();
+					
+				}
+				if (start!=end) clusters.push_back(cluster{start,end,0.0});
+				
+			}
+			
+			//	Clusters facing away from the centre of the mesh
+			//	are more likely to occlude the rest of the mesh
+			vector centre{{0.0,0.0,0.0}};
+			{
+				
+				std::vector<bool> seen(vertex_count,false);
+				std::size_t n=0;
+				for (std::size_t i=0;i<count;++i) {
+					
+					if (seen[indices[i]]) continue;
+					seen[indices[i]]=true;
+					auto p=position(bytes,vertex_size,position_offset,indices[i]);
+					for (std::size_t j=0;j<3;++j) centre[j]+=p[j];
+					++n;
+					
+				}
+				if (n!=0) for (auto & x : centre) x/=double(n);
+				
+			}
+			for (auto & cl : clusters) {
+				
+				vector centroid{{0.0,0.0,0.0}};
+				vector normal{{0.0,0.0,0.0}};
+				double area=0.0;
+				for (auto t=cl.begin;t<cl.end;++t) {
+					
+					auto a=position(bytes,vertex_size,position_offset,indices[t*3]);
+					auto b=position(bytes,vertex_size,position_offset,indices[(t*3)+1]);
+					auto d=position(bytes,vertex_size,position_offset,indices[(t*3)+2]);
+					//	The cross product has twice the area of the
+					//	triangle as its length, which weights both
+					//	the normal and the centroid by area
+					auto n=cross(sub(b,a),sub(d,a));
+					auto w=std::sqrt(dot(n,n));
+					for (std::size_t j=0;j<3;++j) {
+						
+						normal[j]+=n[j];
+						centroid[j]+=w*(a[j]+b[j]+d[j])/3.0;
+						
+					}
+					area+=w;
+					
+				}
+				
+				if (area==0.0) continue;
+				
+				for (auto & x : centroid) x/=area;
+				auto len=std::sqrt(dot(normal,normal));
+				if (len!=0.0) cl.sort_key=dot(sub(centroid,centre),normal)/len;
+				
+			}
+			
+			std::stable_sort(clusters.begin(),clusters.end(),[] (const cluster & a, const cluster & b) noexcept {	return a.sort_key>b.sort_key;	});
+			
+			std::vector<std::uint32_t> retr;
+			retr.reserve(count);
+			for (auto & cl : clusters) retr.insert(retr.end(),indices+(cl.begin*3),indices+(cl.end*3));
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
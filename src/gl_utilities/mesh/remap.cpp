@@ -0,0 +1,148 @@
+#include <gl_utilities/hash.hpp>
+#include <gl_utilities/mesh.hpp>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+
+namespace gl_utilities {
+	
+	
+	namespace mesh {
+		
+		
+		remap weld (const void * vertices, std::size_t vertex_count, std::size_t vertex_size) {
+			
+			if (vertex_count>=unused) throw std::logic_error("Too many vertices");
+			
+			auto bytes=static_cast<const char *>(vertices);
+			remap retr{std::vector<std::uint32_t>(vertex_count),0};
+			
+			//	Distinct vertices with the same hash are chained
+			//	together, each distinct vertex is identified by
+			//	its new index
+			std::unordered_map<std::uint64_t,std::uint32_t> heads;
+			heads.reserve(vertex_count);
+			std::vector<std::uint32_t> chain;
+			std::vector<std::size_t> first;
+			for (std::size_t v=0;v<vertex_count;++v) {
+				
+				auto ptr=bytes+(v*vertex_size);
+				auto h=fnv1a(ptr,vertex_size);
+				auto iter=heads.find(h);
+				auto index=unused;
+				if (iter!=heads.end()) for (auto c=iter->second;c!=unused;c=chain[c]) if (std::memcmp(bytes+(first[c]*vertex_size),ptr,vertex_size)==0) {
+					
+					index=c;
+					break;
+					
+				}
+				
+				if (index==unused) {
+					
+					index=std::uint32_t(first.size());
+					first.push_back(v);
+					if (iter==heads.end()) {
+						
+						chain.push_back(unused);
+						heads.emplace(h,index);
+						
+					} else {
+						
+						chain.push_back(iter->second);
+						iter->second=index;
+						
+					}
+					
+				}
+				
+				retr.table[v]=index;
+				
+			}
+			
+			retr.vertex_count=first.size();
+			
+			return retr;
+			
+		}
+		
+		
+		remap optimize_vertex_fetch (const std::uint32_t * indices, std::size_t count, std::size_t vertex_count) {
+			
+			if (vertex_count>=unused) throw std::logic_error("Too many vertices");
+			
+			remap retr{std::vector<std::uint32_t>(vertex_count,unused),0};
+			for (std::size_t i=0;i<count;++i) {
+				
+				auto v=indices[i];
+				if (v>=vertex_count) throw std::logic_error("Index out of range");
+				if (retr.table[v]==unused) retr.table[v]=std::uint32_t(retr.vertex_count++);
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+		void remap_indices (std::uint32_t * indices, std::size_t count, const remap & r) {
+			
+			for (std::size_t i=0;i<count;++i) {
+				
+				if ((indices[i]>=r.table.size()) || (r.table[indices[i]]==unused)) throw std::logic_error("Index refers to a vertex which is not remapped");
+				indices[i]=r.table[indices[i]];
+				
+			}
+			
+		}
+		
+		
+		std::vector<std::uint8_t> remap_vertices (const void * vertices, std::size_t vertex_size, const remap & r) {
+			
+			auto bytes=static_cast<const std::uint8_t *>(vertices);
+			std::vector<std::uint8_t> retr(r.vertex_count*vertex_size);
+			//	Welded vertices are written more than once but
+			//	they are identical
+			for (std::size_t v=0;v<r.table.size();++v) {
+				
+				auto n=r.table[v];
+				if (n==unused) continue;
+				
+				std::memcpy(retr.data()+(std::size_t(n)*vertex_size),bytes+(v*vertex_size),vertex_size);
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+		GLenum index_type (std::size_t vertex_count, bool restart) noexcept {
+			
+			std::size_t limit=std::size_t(std::numeric_limits<std::uint16_t>::max())+(restart ? 0 : 1);
+			
+			return (vertex_count<=limit) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+			
+		}
+		
+		
+		std::vector<std::uint16_t> narrow (const std::uint32_t * indices, std::size_t count) {
+			
+			std::vector<std::uint16_t> retr(count);
+			for (std::size_t i=0;i<count;++i) {
+				
+				if (indices[i]>std::numeric_limits<std::uint16_t>::max()) throw std::logic_error("Index does not fit in 16 bits");
+				retr[i]=std::uint16_t(indices[i]);
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,129 @@
+#include <gl_utilities/mesh.hpp>
+#include <stdexcept>
+
+
+namespace gl_utilities {
+	
+	
+	namespace mesh {
+		
+		
+		std::vector<std::uint32_t> optimize_vertex_cache (const std::uint32_t * indices, std::size_t count, std::size_t vertex_count, std::size_t cache_size) {
+			
+			if ((count%3)!=0) throw std::logic_error("Triangle lists must have a multiple of three indices");
+			if (cache_size==0) throw std::logic_error("Cache size must be positive");
+			
+			auto triangles=count/3;
+			
+			//	The triangles which use each vertex, stored
+			//	contiguously and indexed by offsets
+			std::vector<std::uint32_t> live(vertex_count,0);
+			for (std::size_t i=0;i<count;++i) {
+				
+				if (indices[i]>=vertex_count) throw std::logic_error("Index out of range");
+				++live[indices[i]];
+				
+			}
+			std::vector<std::size_t> offsets(vertex_count+1,0);
+			for (std::size_t v=0;v<vertex_count;++v) offsets[v+1]=offsets[v]+live[v];
+			std::vector<std::uint32_t> adjacency(count);
+			{
+				
+				auto fill=offsets;
+				for (std::size_t i=0;i<count;++i) adjacency[fill[indices[i]]++]=std::uint32_t(i/3);
+				
+			}
+			
+			std::vector<std::size_t> stamps(vertex_count,0);
+			std::vector<bool> emitted(triangles,false);
+			std::vector<std::uint32_t> dead_ends;
+			std::vector<std::uint32_t> candidates;
+			std::vector<std::uint32_t> retr;
+			retr.reserve(count);
+			
+			auto time=cache_size+1;
+			std::size_t cursor=0;
+			auto none=vertex_count;
+			std::size_t fanning=(vertex_count==0) ? none : 0;
+			while (fanning!=none) {
+				
+				//	Emit every remaining triangle around the
+				//	fanning vertex
+				candidates.clear();
+				for (auto a=offsets[fanning];a<offsets[fanning+1];++a) {
+					
+					auto t=adjacency[a];
+					if (emitted[t]) continue;
+					
+					for (std::size_t j=0;j<3;++j) {
+						
+						auto v=indices[(t*3)+j];
+						retr.push_back(v);
+						dead_ends.push_back(v);
+						candidates.push_back(v);
+						--live[v];
+						if ((time-stamps[v])>cache_size) stamps[v]=time++;
+						
+					}
+					emitted[t]=true;
+					
+				}
+				
+				//	Prefer the vertex which has been in the cache the
+				//	longest but will still be in it after its remaining
+				//	triangles are emitted
+				fanning=none;
+				std::size_t best=0;
+				bool found=false;
+				for (auto v : candidates) {
+					
+					if (live[v]==0) continue;
+					
+					std::size_t priority=0;
+					if (((time-stamps[v])+(2*live[v]))<=cache_size) priority=time-stamps[v];
+					if (!found || (priority>best)) {
+						
+						found=true;
+						best=priority;
+						fanning=v;
+						
+					}
+					
+				}
+				if (found) continue;
+				
+				//	Dead end, fall back to the most recently
+				//	emitted vertex which still has triangles and
+				//	then to the next such vertex in input order
+				while (!dead_ends.empty()) {
+					
+					auto v=dead_ends.back();
+					dead_ends.pop_back();
+					if (live[v]!=0) {
+						
+						fanning=v;
+						break;
+						
+					}
+					
+				}
+				if (fanning!=none) continue;
+				
+				for (;cursor<vertex_count;++cursor) if (live[cursor]!=0) {
+					
+					fanning=cursor;
+					break;
+					
+				}
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
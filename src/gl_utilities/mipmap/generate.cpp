@@ -0,0 +1,380 @@
+#include <gl_utilities/mipmap.hpp>
+#include <gl_utilities/pixel.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+
+namespace gl_utilities {
+	
+	
+	namespace mipmap {
+		
+		
+		namespace {
+			
+			
+			using for_each_type=std::function<void (std::size_t, std::size_t, const std::function<void (std::size_t, std::size_t)> &)>;
+			
+			
+			//	Pixels are always stored as four floats while
+			//	filtering regardless of the number of channels
+			//	so that each pixel is exactly one SIMD register
+			class image {
+				
+				
+				public:
+				
+				
+					std::size_t width;
+					std::size_t height;
+					std::vector<float> pixels;
+					
+					
+					image (std::size_t w, std::size_t h) : width(w), height(h), pixels(w*h*4,0.0f) {	}
+				
+				
+			};
+			
+			
+			//	The weights used to compute each destination
+			//	pixel along one axis, every destination pixel
+			//	has the same number of taps (padded with zero
+			//	weights) which always lie within the source
+			class weights {
+				
+				
+				public:
+				
+				
+					std::size_t taps;
+					std::vector<std::size_t> start;
+					std::vector<float> w;
+				
+				
+			};
+			
+			
+			const double pi=3.14159265358979323846;
+			
+			
+			double sinc (double x) noexcept {
+				
+				if (x==0.0) return 1.0;
+				
+				x*=pi;
+				return std::sin(x)/x;
+				
+			}
+			
+			
+			double bessel_i0 (double x) noexcept {
+				
+				double sum=1.0;
+				double term=1.0;
+				double half=x/2.0;
+				for (double k=1.0;;k+=1.0) {
+					
+					term*=(half/k)*(half/k);
+					sum+=term;
+					if (term<(sum*1e-12)) return sum;
+					
+				}
+				
+			}
+			
+			
+			double radius (filter f) noexcept {
+				
+				return (f==filter::box) ? 0.5 : 3.0;
+				
+			}
+			
+			
+			double evaluate (const settings & s, double t) noexcept {
+				
+				switch (s.f) {
+					
+					case filter::box:
+					default:
+						return ((t>=-0.5) && (t<0.5)) ? 1.0 : 0.0;
+					case filter::kaiser:{
+						
+						auto r=t/radius(s.f);
+						if (std::abs(r)>=1.0) return 0.0;
+						double a=s.kaiser_alpha;
+						return sinc(t)*(bessel_i0(a*std::sqrt(1.0-(r*r)))/bessel_i0(a));
+						
+					}
+					case filter::lanczos:
+						if (std::abs(t)>=radius(s.f)) return 0.0;
+						return sinc(t)*sinc(t/radius(s.f));
+					
+				}
+				
+			}
+			
+			
+			weights make_weights (std::size_t src, std::size_t dst, const settings & s) {
+				
+				auto scale=double(src)/double(dst);
+				auto support=radius(s.f)*scale;
+				
+				std::vector<std::size_t> lo(dst);
+				std::vector<std::vector<double>> all(dst);
+				std::size_t taps=0;
+				for (std::size_t i=0;i<dst;++i) {
+					
+					auto center=((double(i)+0.5)*scale)-0.5;
+					auto first=std::ptrdiff_t(std::floor(center-support));
+					auto last=std::ptrdiff_t(std::ceil(center+support));
+					//	Sample positions beyond the edges of the
+					//	source clamp to the edges
+					auto clamp=[&] (std::ptrdiff_t j) noexcept {	return std::size_t(std::min(std::max(j,std::ptrdiff_t(0)),std::ptrdiff_t(src-1)));	};
+					auto begin=clamp(first);
+					auto & ws=all[i];
+					ws.assign(clamp(last)-begin+1,0.0);
+					for (auto j=first;j<=last;++j) ws[clamp(j)-begin]+=evaluate(s,(double(j)-center)/scale);
+					
+					//	Trim taps which do not contribute
+					while ((ws.size()>1) && (ws.back()==0.0)) ws.pop_back();
+					std::size_t zeroes=0;
+					while (((zeroes+1)<ws.size()) && (ws[zeroes]==0.0)) ++zeroes;
+					ws.erase(ws.begin(),ws.begin()+zeroes);
+					begin+=zeroes;
+					
+					double sum=0.0;
+					for (auto w : ws) sum+=w;
+					if (sum!=0.0) for (auto & w : ws) w/=sum;
+					
+					lo[i]=begin;
+					taps=std::max(taps,ws.size());
+					
+				}
+				
+				weights retr;
+				retr.taps=taps;
+				retr.start.resize(dst);
+				retr.w.assign(dst*taps,0.0f);
+				for (std::size_t i=0;i<dst;++i) {
+					
+					//	Shift the window left if it would extend past
+					//	the end of the source, the shifted in taps have
+					//	zero weight
+					auto start=std::min(lo[i],src-taps);
+					auto offset=lo[i]-start;
+					retr.start[i]=start;
+					auto & ws=all[i];
+					for (std::size_t j=0;j<ws.size();++j) retr.w[(i*taps)+offset+j]=float(ws[j]);
+					
+				}
+				
+				return retr;
+				
+			}
+			
+			
+			inline void accumulate (float * acc, const float * src, float w, std::size_t n) noexcept {
+				
+				std::size_t i=0;
+				#ifdef __SSE__
+				auto wv=_mm_set1_ps(w);
+				for (;(n-i)>=4;i+=4) _mm_storeu_ps(acc+i,_mm_add_ps(_mm_loadu_ps(acc+i),_mm_mul_ps(wv,_mm_loadu_ps(src+i))));
+				#endif
+				for (;i<n;++i) acc[i]+=w*src[i];
+				
+			}
+			
+			
+			image horizontal (const image & src, std::size_t width, const settings & s, const for_each_type & for_each) {
+				
+				auto ws=make_weights(src.width,width,s);
+				image retr(width,src.height);
+				for_each(0,src.height,[&] (std::size_t begin, std::size_t end) {
+					
+					for (auto y=begin;y<end;++y) {
+						
+						auto in=src.pixels.data()+(y*src.width*4);
+						auto out=retr.pixels.data()+(y*width*4);
+						for (std::size_t x=0;x<width;++x) {
+							
+							auto p=in+(ws.start[x]*4);
+							auto w=ws.w.data()+(x*ws.taps);
+							#ifdef __SSE__
+							auto acc=_mm_setzero_ps();
+							for (std::size_t k=0;k<ws.taps;++k) acc=_mm_add_ps(acc,_mm_mul_ps(_mm_set1_ps(w[k]),_mm_loadu_ps(p+(k*4))));
+							_mm_storeu_ps(out+(x*4),acc);
+							#else
+							for (std::size_t k=0;k<ws.taps;++k) accumulate(out+(x*4),p+(k*4),w[k],4);
+							#endif
+							
+						}
+						
+					}
+					
+				});
+				
+				return retr;
+				
+			}
+			
+			
+			image vertical (const image & src, std::size_t height, const settings & s, const for_each_type & for_each) {
+				
+				auto ws=make_weights(src.height,height,s);
+				image retr(src.width,height);
+				auto row=src.width*4;
+				for_each(0,height,[&] (std::size_t begin, std::size_t end) {
+					
+					//	Accumulating entire rows at a time keeps
+					//	the inner loop contiguous in memory
+					for (auto y=begin;y<end;++y) {
+						
+						auto out=retr.pixels.data()+(y*row);
+						auto w=ws.w.data()+(y*ws.taps);
+						for (std::size_t k=0;k<ws.taps;++k) {
+							
+							if (w[k]==0.0f) continue;
+							accumulate(out,src.pixels.data()+((ws.start[y]+k)*row),w[k],row);
+							
+						}
+						
+					}
+					
+				});
+				
+				return retr;
+				
+			}
+			
+			
+			bool is_srgb (const settings & s, std::size_t channel) noexcept {
+				
+				if (!s.srgb) return false;
+				
+				return !(s.alpha && (channel==(s.channels-1)));
+				
+			}
+			
+			
+			image to_image (const std::uint8_t * data, std::size_t width, std::size_t height, const settings & s, const for_each_type & for_each) {
+				
+				float lut [2][256];
+				for (unsigned i=0;i<256;++i) {
+					
+					lut[0][i]=float(i)/255.0f;
+					lut[1][i]=pixel::reference::srgb_decode(std::uint8_t(i));
+					
+				}
+				
+				image retr(width,height);
+				for_each(0,height,[&] (std::size_t begin, std::size_t end) {
+					
+					for (auto i=begin*width;i<(end*width);++i) for (std::size_t c=0;c<s.channels;++c) {
+						
+						retr.pixels[(i*4)+c]=lut[is_srgb(s,c) ? 1 : 0][data[(i*s.channels)+c]];
+						
+					}
+					
+				});
+				
+				return retr;
+				
+			}
+			
+			
+			level to_level (const image & img, const settings & s, const for_each_type & for_each) {
+				
+				level retr;
+				retr.width=img.width;
+				retr.height=img.height;
+				retr.data.resize(img.width*img.height*s.channels);
+				for_each(0,img.height,[&] (std::size_t begin, std::size_t end) {
+					
+					std::vector<float> row(img.width*s.channels);
+					for (auto y=begin;y<end;++y) {
+						
+						auto in=img.pixels.data()+(y*img.width*4);
+						auto out=retr.data.data()+(y*img.width*s.channels);
+						for (std::size_t x=0;x<img.width;++x) for (std::size_t c=0;c<s.channels;++c) row[(x*s.channels)+c]=in[(x*4)+c];
+						
+						//	Encode the entire row as sRGB in one go (so
+						//	that the vectorized kernel is used) and then
+						//	overwrite the linear channels
+						if (s.srgb) pixel::srgb_encode(row.data(),out,row.size());
+						for (std::size_t i=0;i<row.size();++i) {
+							
+							if (is_srgb(s,i%s.channels)) continue;
+							
+							auto f=std::min(std::max(row[i],0.0f),1.0f);
+							out[i]=std::uint8_t((f*255.0f)+0.5f);
+							
+						}
+						
+					}
+					
+				});
+				
+				return retr;
+				
+			}
+			
+			
+			std::vector<level> generate (const std::uint8_t * data, std::size_t width, std::size_t height, const settings & s, const for_each_type & for_each) {
+				
+				if ((s.channels==0) || (s.channels>4)) throw std::logic_error("Mipmaps may only be generated for images with between 1 and 4 channels");
+				if ((width==0) || (height==0)) throw std::logic_error("Mipmaps may not be generated for empty images");
+				
+				std::vector<level> retr;
+				auto curr=to_image(data,width,height,s,for_each);
+				while ((curr.width>1) || (curr.height>1)) {
+					
+					auto w=std::max<std::size_t>(curr.width/2,1);
+					auto h=std::max<std::size_t>(curr.height/2,1);
+					if (w!=curr.width) curr=horizontal(curr,w,s,for_each);
+					if (h!=curr.height) curr=vertical(curr,h,s,for_each);
+					retr.push_back(to_level(curr,s,for_each));
+					
+				}
+				
+				return retr;
+				
+			}
+			
+			
+		}
+		
+		
+		std::vector<level> generate (const std::uint8_t * data, std::size_t width, std::size_t height, const settings & s, thread_pool & pool) {
+			
+			return generate(data,width,height,s,[&] (std::size_t begin, std::size_t end, const std::function<void (std::size_t, std::size_t)> & func) {
+				
+				pool.parallel_for(begin,end,func);
+				
+			});
+			
+		}
+		
+		
+		std::vector<level> generate (const std::uint8_t * data, std::size_t width, std::size_t height, const settings & s) {
+			
+			return generate(data,width,height,s,[] (std::size_t begin, std::size_t end, const std::function<void (std::size_t, std::size_t)> & func) {
+				
+				func(begin,end);
+				
+			});
+			
+		}
+		
+		
+	}
+	
+	
+}
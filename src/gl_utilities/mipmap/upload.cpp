@@ -0,0 +1,76 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/mipmap.hpp>
+
+
+namespace gl_utilities {
+	
+	
+	namespace mipmap {
+		
+		
+		namespace {
+			
+			
+			//	Levels are tightly packed but the default unpack
+			//	alignment is four
+			class unpack_alignment_guard {
+				
+				
+				private:
+				
+				
+					GLint old_;
+				
+				
+				public:
+				
+				
+					unpack_alignment_guard (const unpack_alignment_guard &) = delete;
+					unpack_alignment_guard & operator = (const unpack_alignment_guard &) = delete;
+					
+					
+					explicit unpack_alignment_guard (GLint alignment) {
+						
+						glGetIntegerv(GL_UNPACK_ALIGNMENT,&old_);
+						opengl::raise();
+						
+						glPixelStorei(GL_UNPACK_ALIGNMENT,alignment);
+						opengl::raise();
+						
+					}
+					
+					
+					~unpack_alignment_guard () noexcept {
+						
+						glPixelStorei(GL_UNPACK_ALIGNMENT,old_);
+						
+					}
+				
+				
+			};
+			
+			
+		}
+		
+		
+		void upload (const std::vector<level> & levels, const opengl::texture & tex, GLenum target, GLenum format, GLint first) {
+			
+			auto g=tex.bind(target);
+			unpack_alignment_guard a(1);
+			
+			for (auto & l : levels) {
+				
+				glTexSubImage2D(target,first++,0,0,GLsizei(l.width),GLsizei(l.height),format,GL_UNSIGNED_BYTE,l.data.data());
+				opengl::raise();
+				
+			}
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,396 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/opengl.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			//	Runs longer than this are split into multiple
+			//	calls so that the names may be gathered on the
+			//	stack
+			const std::size_t max_run=32;
+			
+			
+			GLenum start_of (GLenum target) {
+				
+				switch (target) {
+					
+					case GL_ATOMIC_COUNTER_BUFFER:
+						return GL_ATOMIC_COUNTER_BUFFER_START;
+					case GL_SHADER_STORAGE_BUFFER:
+						return GL_SHADER_STORAGE_BUFFER_START;
+					case GL_TRANSFORM_FEEDBACK_BUFFER:
+						return GL_TRANSFORM_FEEDBACK_BUFFER_START;
+					case GL_UNIFORM_BUFFER:
+						return GL_UNIFORM_BUFFER_START;
+					default:
+						throw std::logic_error("Not an indexed buffer target");
+					
+				}
+				
+			}
+			
+			
+			GLenum size_of (GLenum target) {
+				
+				switch (target) {
+					
+					case GL_ATOMIC_COUNTER_BUFFER:
+						return GL_ATOMIC_COUNTER_BUFFER_SIZE;
+					case GL_SHADER_STORAGE_BUFFER:
+						return GL_SHADER_STORAGE_BUFFER_SIZE;
+					case GL_TRANSFORM_FEEDBACK_BUFFER:
+						return GL_TRANSFORM_FEEDBACK_BUFFER_SIZE;
+					case GL_UNIFORM_BUFFER:
+						return GL_UNIFORM_BUFFER_SIZE;
+					default:
+						throw std::logic_error("Not an indexed buffer target");
+					
+				}
+				
+			}
+			
+			
+			//	Invokes a function for each run of entries which
+			//	satisfy a predicate pairwise
+			template <typename T, typename Joins, typename Func>
+			void for_each_run (const std::vector<T> & entries, Joins joins, Func func) {
+				
+				for (std::size_t i=0;i<entries.size();) {
+					
+					auto j=i+1;
+					while ((j<entries.size()) && ((j-i)<max_run) && joins(entries[j-1],entries[j])) ++j;
+					func(i,j);
+					i=j;
+					
+				}
+				
+			}
+			
+			
+		}
+		
+		
+		void binding_table::apply_textures (const std::vector<texture_entry> & entries) {
+			
+			if (entries.empty()) return;
+			
+			//	glBindTextures binds each texture to its own target,
+			//	but binding zero unbinds every target of the unit,
+			//	so zero is only ever bound the old fashioned way
+			bool multi=GLEW_ARB_multi_bind;
+			if (multi) {
+				
+				for_each_run(entries,[] (const texture_entry & a, const texture_entry & b) noexcept {
+					
+					return ((a.unit+1)==b.unit) && (a.handle!=0) && (b.handle!=0);
+					
+				},[&] (std::size_t begin, std::size_t end) {
+					
+					if (entries[begin].handle==0) return;
+					
+					std::array<GLuint,max_run> names;
+					for (auto i=begin;i<end;++i) names[i-begin]=entries[i].handle;
+					glBindTextures(entries[begin].unit,GLsizei(end-begin),names.data());
+					
+				});
+				raise();
+				
+			}
+			
+			//	The active texture unit is only saved if it must be
+			//	changed at all, and only changed when the unit
+			//	differs from that of the previous entry
+			optional<active_texture_guard> g;
+			optional<GLuint> active;
+			for (auto & e : entries) {
+				
+				if (multi && (e.handle!=0)) continue;
+				
+				if (!g) g.emplace();
+				if (!(active && (*active==e.unit))) {
+					
+					glActiveTexture(GL_TEXTURE0+e.unit);
+					active=e.unit;
+					
+				}
+				glBindTexture(e.target,e.handle);
+				
+			}
+			raise();
+			
+		}
+		
+		
+		void binding_table::apply_samplers (const std::vector<sampler_entry> & entries) {
+			
+			if (entries.empty()) return;
+			
+			if (GLEW_ARB_multi_bind) {
+				
+				for_each_run(entries,[] (const sampler_entry & a, const sampler_entry & b) noexcept {
+					
+					return (a.unit+1)==b.unit;
+					
+				},[&] (std::size_t begin, std::size_t end) {
+					
+					std::array<GLuint,max_run> names;
+					for (auto i=begin;i<end;++i) names[i-begin]=entries[i].handle;
+					glBindSamplers(entries[begin].unit,GLsizei(end-begin),names.data());
+					
+				});
+				
+			} else {
+				
+				for (auto & e : entries) glBindSampler(e.unit,e.handle);
+				
+			}
+			raise();
+			
+		}
+		
+		
+		void binding_table::apply_buffers (const std::vector<buffer_entry> & entries) {
+			
+			if (entries.empty()) return;
+			
+			if (GLEW_ARB_multi_bind) {
+				
+				for_each_run(entries,[] (const buffer_entry & a, const buffer_entry & b) noexcept {
+					
+					return (a.target==b.target) && ((a.index+1)==b.index) && ((a.size==0)==(b.size==0));
+					
+				},[&] (std::size_t begin, std::size_t end) {
+					
+					auto & first=entries[begin];
+					auto count=GLsizei(end-begin);
+					std::array<GLuint,max_run> names;
+					for (auto i=begin;i<end;++i) names[i-begin]=entries[i].handle;
+					if (first.size==0) {
+						
+						glBindBuffersBase(first.target,first.index,count,names.data());
+						return;
+						
+					}
+					
+					std::array<GLintptr,max_run> offsets;
+					std::array<GLsizeiptr,max_run> sizes;
+					for (auto i=begin;i<end;++i) {
+						
+						offsets[i-begin]=entries[i].offset;
+						sizes[i-begin]=entries[i].size;
+						
+					}
+					glBindBuffersRange(first.target,first.index,count,names.data(),offsets.data(),sizes.data());
+					
+				});
+				
+			} else {
+				
+				for (auto & e : entries) {
+					
+					if (e.size==0) glBindBufferBase(e.target,e.index,e.handle);
+					else glBindBufferRange(e.target,e.index,e.handle,e.offset,e.size);
+					
+				}
+				
+			}
+			raise();
+			
+		}
+		
+		
+		void binding_table::guard::destroy () noexcept {
+			
+			if (!d_) return;
+			
+			apply_buffers(d_->buffers);
+			apply_samplers(d_->samplers);
+			apply_textures(d_->textures);
+			d_=nullopt;
+			
+		}
+		
+		
+		binding_table::guard::guard (const binding_table & table) : d_(in_place) {
+			
+			auto & d=*d_;
+			d.textures.reserve(table.textures_.size());
+			d.samplers.reserve(table.samplers_.size());
+			d.buffers.reserve(table.buffers_.size());
+			
+			//	Texture and sampler bindings may only be queried for
+			//	the active texture unit so the active texture unit is
+			//	switched only when necessary and restored at the end
+			{
+				
+				active_texture_guard g;
+				optional<GLuint> curr;
+				auto activate=[&] (GLuint unit) {
+					
+					if (curr && (*curr==unit)) return;
+					
+					glActiveTexture(GL_TEXTURE0+unit);
+					curr=unit;
+					
+				};
+				
+				GLint handle;
+				for (auto & e : table.textures_) {
+					
+					activate(e.unit);
+					glGetIntegerv(texture::binding(e.target),&handle);
+					d.textures.push_back({e.unit,e.target,GLuint(handle)});
+					
+				}
+				for (auto & e : table.samplers_) {
+					
+					activate(e.unit);
+					glGetIntegerv(GL_SAMPLER_BINDING,&handle);
+					d.samplers.push_back({e.unit,GLuint(handle)});
+					
+				}
+				raise();
+				
+			}
+			
+			for (auto & e : table.buffers_) {
+				
+				GLint handle;
+				glGetIntegeri_v(buffer::binding(e.target),e.index,&handle);
+				GLint64 offset;
+				glGetInteger64i_v(start_of(e.target),e.index,&offset);
+				GLint64 size;
+				glGetInteger64i_v(size_of(e.target),e.index,&size);
+				//	Bindings made with glBindBufferBase report a
+				//	size of zero, which is exactly how entries
+				//	represent them
+				if (handle==0) size=0;
+				d.buffers.push_back({e.target,e.index,GLuint(handle),GLintptr(offset),GLsizeiptr(size)});
+				
+			}
+			raise();
+			
+		}
+		
+		
+		binding_table::guard::guard (guard && other) noexcept {
+			
+			std::swap(other.d_,d_);
+			
+		}
+		
+		
+		binding_table::guard::~guard () noexcept {
+			
+			destroy();
+			
+		}
+		
+		
+		binding_table & binding_table::add_texture (GLuint unit, GLenum target, const texture & tex) {
+			
+			auto iter=std::find_if(textures_.begin(),textures_.end(),[&] (const texture_entry & e) noexcept {
+				
+				return (e.unit>unit) || ((e.unit==unit) && (e.target>=target));
+				
+			});
+			if ((iter!=textures_.end()) && (iter->unit==unit) && (iter->target==target)) iter->handle=tex;
+			else textures_.insert(iter,{unit,target,tex});
+			
+			return *this;
+			
+		}
+		
+		
+		binding_table & binding_table::add_sampler (GLuint unit, const sampler & s) {
+			
+			auto iter=std::find_if(samplers_.begin(),samplers_.end(),[&] (const sampler_entry & e) noexcept {	return e.unit>=unit;	});
+			if ((iter!=samplers_.end()) && (iter->unit==unit)) iter->handle=s;
+			else samplers_.insert(iter,{unit,s});
+			
+			return *this;
+			
+		}
+		
+		
+		binding_table & binding_table::add_buffer_range (GLenum target, GLuint index, const buffer & b, GLintptr offset, GLsizeiptr size) {
+			
+			if (size<=0) throw std::logic_error("Buffer ranges must not be empty");
+			
+			buffer_entry entry{target,index,b,offset,size};
+			auto iter=std::find_if(buffers_.begin(),buffers_.end(),[&] (const buffer_entry & e) noexcept {
+				
+				return (e.target>target) || ((e.target==target) && (e.index>=index));
+				
+			});
+			if ((iter!=buffers_.end()) && (iter->target==target) && (iter->index==index)) *iter=entry;
+			else buffers_.insert(iter,entry);
+			
+			return *this;
+			
+		}
+		
+		
+		binding_table & binding_table::add_buffer_base (GLenum target, GLuint index, const buffer & b) {
+			
+			buffer_entry entry{target,index,b,0,0};
+			auto iter=std::find_if(buffers_.begin(),buffers_.end(),[&] (const buffer_entry & e) noexcept {
+				
+				return (e.target>target) || ((e.target==target) && (e.index>=index));
+				
+			});
+			if ((iter!=buffers_.end()) && (iter->target==target) && (iter->index==index)) *iter=entry;
+			else buffers_.insert(iter,entry);
+			
+			return *this;
+			
+		}
+		
+		
+		void binding_table::clear () noexcept {
+			
+			textures_.clear();
+			samplers_.clear();
+			buffers_.clear();
+			
+		}
+		
+		
+		void binding_table::apply () const {
+			
+			apply_textures(textures_);
+			apply_samplers(samplers_);
+			apply_buffers(buffers_);
+			
+		}
+		
+		
+		binding_table::guard binding_table::bind () const {
+			
+			guard retr(*this);
+			
+			apply();
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
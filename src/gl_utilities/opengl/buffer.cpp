@@ -75,7 +75,7 @@ namespace gl_utilities {
 		}
 		
 		
-		static GLenum to_get (GLenum type) {
+		GLenum buffer::binding (GLenum type) {
 			
 			switch (type) {
 				
@@ -116,7 +116,7 @@ namespace gl_utilities {
 			//	Buffer handles are unsigned integers but
 			//	there's no glGet* for unsigned integers...
 			GLint handle;
-			glGetIntegerv(to_get(type),&handle);
+			glGetIntegerv(binding(type),&handle);
 			raise();
 			
 			d_->handle=handle;
@@ -151,6 +151,60 @@ namespace gl_utilities {
 		}
 		
 		
+		void buffer::mapping::destroy () noexcept {
+			
+			if (ptr_==nullptr) return;
+			
+			//	GL_FALSE indicates the data store became corrupt
+			//	while mapped, there's nothing we can do about
+			//	that here
+			glUnmapBuffer(type_);
+			ptr_=nullptr;
+			
+		}
+		
+		
+		buffer::mapping::mapping (guard g, GLenum type, void * ptr) noexcept : guard_(std::move(g)), type_(type), ptr_(ptr) {	}
+		
+		
+		buffer::mapping::mapping (mapping && other) noexcept : guard_(std::move(other.guard_)), type_(other.type_), ptr_(other.ptr_) {
+			
+			other.ptr_=nullptr;
+			
+		}
+		
+		
+		buffer::mapping::~mapping () noexcept {
+			
+			destroy();
+			
+		}
+		
+		
+		void * buffer::mapping::get () const noexcept {
+			
+			return ptr_;
+			
+		}
+		
+		
+		buffer::mapping buffer::map (GLenum type, GLintptr offset, GLsizeiptr length, GLbitfield access) const {
+			
+			auto g=bind(type);
+			
+			auto ptr=glMapBufferRange(type,offset,length,access);
+			if (ptr==nullptr) {
+				
+				raise();
+				throw error("glMapBufferRange failed");
+				
+			}
+			
+			return mapping(std::move(g),type,ptr);
+			
+		}
+		
+		
 	}
 	
 	
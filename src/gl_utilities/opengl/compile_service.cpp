@@ -0,0 +1,192 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/compile_service.hpp>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			const GLuint64 fence_timeout=1000000000;
+			
+			
+			program build (const std::vector<shader_source> & sources) {
+				
+				program retr;
+				std::vector<shader> shaders;
+				shaders.reserve(sources.size());
+				for (auto & s : sources) {
+					
+					shaders.emplace_back(s.type,s.source);
+					retr.attach(shaders.back());
+					
+				}
+				retr.link();
+				
+				//	The program must be complete in this context
+				//	before another context may safely use it
+				auto fence=glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+				raise();
+				GLenum result;
+				do {
+					
+					result=glClientWaitSync(fence,GL_SYNC_FLUSH_COMMANDS_BIT,fence_timeout);
+					
+				} while (result==GL_TIMEOUT_EXPIRED);
+				glDeleteSync(fence);
+				raise();
+				
+				return retr;
+				
+			}
+			
+			
+		}
+		
+		
+		shared_context::~shared_context () noexcept {	}
+		
+		
+		void compile_service::worker (shared_context & context) {
+			
+			//	If the context cannot be made current every job
+			//	this worker takes fails with the same exception
+			std::exception_ptr ex;
+			try {
+				
+				context.make_current();
+				
+			} catch (...) {
+				
+				ex=std::current_exception();
+				
+			}
+			
+			for (;;) {
+				
+				job j;
+				{
+					
+					std::unique_lock<std::mutex> l(m_);
+					cv_.wait(l,[&] () {	return stop_ || !queue_.empty();	});
+					//	Only exit once the queue has been drained
+					if (queue_.empty()) break;
+					j=std::move(queue_.front());
+					queue_.pop_front();
+					
+				}
+				
+				if (ex) {
+					
+					j.result.set_exception(ex);
+					continue;
+					
+				}
+				
+				try {
+					
+					j.result.set_value(build(j.sources));
+					
+				} catch (...) {
+					
+					j.result.set_exception(std::current_exception());
+					
+				}
+				
+			}
+			
+			if (!ex) context.release();
+			
+		}
+		
+		
+		void compile_service::stop () noexcept {
+			
+			{
+				
+				std::lock_guard<std::mutex> l(m_);
+				stop_=true;
+				
+			}
+			
+			cv_.notify_all();
+			for (auto & t : threads_) t.join();
+			
+		}
+		
+		
+		compile_service::compile_service (const factory_type & factory, std::size_t threads) : stop_(false) {
+			
+			if (threads==0) throw std::logic_error("A compile service requires at least one worker");
+			
+			contexts_.reserve(threads);
+			for (std::size_t i=0;i<threads;++i) contexts_.push_back(factory());
+			
+			threads_.reserve(threads);
+			try {
+				
+				for (auto & c : contexts_) {
+					
+					auto ptr=c.get();
+					threads_.emplace_back([this,ptr] () {	worker(*ptr);	});
+					
+				}
+				
+			} catch (...) {
+				
+				stop();
+				
+				throw;
+				
+			}
+			
+		}
+		
+		
+		compile_service::~compile_service () noexcept {
+			
+			stop();
+			
+		}
+		
+		
+		std::size_t compile_service::size () const noexcept {
+			
+			return threads_.size();
+			
+		}
+		
+		
+		std::future<program> compile_service::submit (std::vector<shader_source> sources) {
+			
+			job j;
+			j.sources=std::move(sources);
+			auto retr=j.result.get_future();
+			
+			{
+				
+				std::lock_guard<std::mutex> l(m_);
+				queue_.push_back(std::move(j));
+				
+			}
+			
+			cv_.notify_one();
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
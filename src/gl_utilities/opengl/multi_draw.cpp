@@ -0,0 +1,163 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/hash.hpp>
+#include <gl_utilities/multi_draw.hpp>
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			std::size_t index_size (GLenum type) {
+				
+				switch (type) {
+					
+					case GL_UNSIGNED_BYTE:
+						return 1;
+					case GL_UNSIGNED_SHORT:
+						return 2;
+					case GL_UNSIGNED_INT:
+						return 4;
+					default:
+						throw std::logic_error("Unsupported index type");
+					
+				}
+				
+			}
+			
+			
+		}
+		
+		
+		bool multi_draw_state::operator == (const multi_draw_state & other) const noexcept {
+			
+			return (vao==other.vao) &&
+				(elements==other.elements) &&
+				(mode==other.mode) &&
+				(index_type==other.index_type);
+			
+		}
+		
+		
+		std::size_t multi_draw::hasher::operator () (const multi_draw_state & s) const noexcept {
+			
+			auto retr=fnv1a_integer(reinterpret_cast<std::uintptr_t>(s.vao));
+			retr=fnv1a_integer(reinterpret_cast<std::uintptr_t>(s.elements),retr);
+			retr=fnv1a_integer(s.mode,retr);
+			retr=fnv1a_integer(s.index_type,retr);
+			
+			return std::size_t(retr);
+			
+		}
+		
+		
+		multi_draw::multi_draw () noexcept : draws_(0), calls_(0) {	}
+		
+		
+		void multi_draw::add (const multi_draw_state & state, GLsizei count, std::size_t first, GLint base_vertex) {
+			
+			if ((state.vao==nullptr) || (state.elements==nullptr)) throw std::logic_error("Draws require a vertex array and an element buffer");
+			auto offset=first*index_size(state.index_type);
+			if ((base_vertex!=0) && !GLEW_ARB_draw_elements_base_vertex) throw error("Base vertices require ARB_draw_elements_base_vertex");
+			if (count<=0) return;
+			
+			auto iter=map_.find(state);
+			if (iter==map_.end()) {
+				
+				buckets_.push_back(bucket{state,{},{},{}});
+				iter=map_.emplace(state,buckets_.size()-1).first;
+				
+			}
+			
+			auto & b=buckets_[iter->second];
+			b.counts.push_back(count);
+			b.offsets.push_back(reinterpret_cast<const void *>(offset));
+			b.base_vertices.push_back(base_vertex);
+			
+		}
+		
+		
+		void multi_draw::flush () {
+			
+			bool base_vertex=GLEW_ARB_draw_elements_base_vertex;
+			for (auto & b : buckets_) {
+				
+				auto drawcount=GLsizei(b.counts.size());
+				//	The element buffer binding belongs to the vertex
+				//	array, so it must be restored before the vertex
+				//	array binding is, which declaration order ensures
+				auto vg=b.state.vao->bind();
+				auto eg=b.state.elements->bind(GL_ELEMENT_ARRAY_BUFFER);
+				if (base_vertex) {
+					
+					glMultiDrawElementsBaseVertex(b.state.mode,b.counts.data(),b.state.index_type,b.offsets.data(),drawcount,b.base_vertices.data());
+					
+				} else {
+					
+					glMultiDrawElements(b.state.mode,b.counts.data(),b.state.index_type,b.offsets.data(),drawcount);
+					
+				}
+				raise();
+				
+				draws_+=b.counts.size();
+				++calls_;
+				
+			}
+			
+			clear();
+			
+		}
+		
+		
+		void multi_draw::clear () noexcept {
+			
+			buckets_.clear();
+			map_.clear();
+			
+		}
+		
+		
+		std::size_t multi_draw::pending () const noexcept {
+			
+			std::size_t retr=0;
+			for (auto & b : buckets_) retr+=b.counts.size();
+			
+			return retr;
+			
+		}
+		
+		
+		std::size_t multi_draw::draws () const noexcept {
+			
+			return draws_;
+			
+		}
+		
+		
+		std::size_t multi_draw::calls () const noexcept {
+			
+			return calls_;
+			
+		}
+		
+		
+		void multi_draw::reset_statistics () noexcept {
+			
+			draws_=0;
+			calls_=0;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,124 @@
+#include <gl_utilities/hash.hpp>
+#include <gl_utilities/opengl.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		std::size_t pipeline_cache::hasher::operator () (const key_type & key) const noexcept {
+			
+			auto retr=fnv1a_offset_basis;
+			for (auto & pair : key) {
+				
+				retr=fnv1a_integer(pair.first,retr);
+				retr=fnv1a_integer(pair.second,retr);
+				
+			}
+			
+			return std::size_t(retr);
+			
+		}
+		
+		
+		bool pipeline_cache::entry::expired () const noexcept {
+			
+			return std::any_of(programs.begin(),programs.end(),[] (const std::weak_ptr<const program> & p) noexcept {	return p.expired();	});
+			
+		}
+		
+		
+		pipeline_cache::entry pipeline_cache::make_entry (const std::vector<pipeline_stage> & stages) {
+			
+			entry retr;
+			retr.programs.reserve(stages.size());
+			for (auto & s : stages) {
+				
+				retr.pipeline.use_stages(s.stages,*s.p);
+				retr.programs.push_back(s.p);
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+		pipeline_cache::pipeline_cache () noexcept : created_(0) {	}
+		
+		
+		const program_pipeline & pipeline_cache::get (const std::vector<pipeline_stage> & stages) {
+			
+			key_type key;
+			key.reserve(stages.size());
+			for (auto & s : stages) {
+				
+				if (!s.p) throw std::logic_error("Pipeline stages must refer to a program");
+				key.emplace_back(s.stages,GLuint(*s.p));
+				
+			}
+			
+			auto iter=map_.find(key);
+			if (iter!=map_.end()) {
+				
+				//	A program with the same handle as one which has
+				//	since been deleted is a different program, the
+				//	pipeline must be recreated
+				if (!iter->second.expired()) return iter->second.pipeline;
+				
+				iter->second=make_entry(stages);
+				++created_;
+				return iter->second.pipeline;
+				
+			}
+			
+			auto & retr=map_.emplace(std::move(key),make_entry(stages)).first->second.pipeline;
+			++created_;
+			
+			return retr;
+			
+		}
+		
+		
+		void pipeline_cache::prune () noexcept {
+			
+			for (auto iter=map_.begin();iter!=map_.end();) {
+				
+				if (iter->second.expired()) iter=map_.erase(iter);
+				else ++iter;
+				
+			}
+			
+		}
+		
+		
+		void pipeline_cache::clear () noexcept {
+			
+			map_.clear();
+			
+		}
+		
+		
+		std::size_t pipeline_cache::size () const noexcept {
+			
+			return map_.size();
+			
+		}
+		
+		
+		std::size_t pipeline_cache::created () const noexcept {
+			
+			return created_;
+			
+		}
+		
+		
+	}
+	
+	
+}
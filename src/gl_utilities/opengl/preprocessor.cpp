@@ -0,0 +1,388 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/mapped_file.hpp>
+#include <gl_utilities/opengl.hpp>
+#include <gl_utilities/preprocessor.hpp>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <sys/stat.h>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			std::string define_name (const std::string & define) {
+				
+				return define.substr(0,define.find(' '));
+				
+			}
+			
+			
+			std::string directory_of (const std::string & path) {
+				
+				auto slash=path.rfind('/');
+				if (slash==std::string::npos) return ".";
+				
+				return path.substr(0,slash);
+				
+			}
+			
+			
+			bool exists (const std::string & path) noexcept {
+				
+				struct stat s;
+				
+				return (stat(path.c_str(),&s)==0) && S_ISREG(s.st_mode);
+				
+			}
+			
+			
+			bool starts_with (const std::string & str, std::size_t pos, const char * prefix) noexcept {
+				
+				for (;*prefix!='\0';++prefix,++pos) if ((pos>=str.size()) || (str[pos]!=*prefix)) return false;
+				
+				return true;
+				
+			}
+			
+			
+			std::size_t skip_space (const std::string & str, std::size_t pos, std::size_t end) noexcept {
+				
+				while ((pos<end) && ((str[pos]==' ') || (str[pos]=='\t'))) ++pos;
+				
+				return pos;
+				
+			}
+			
+			
+			//	Before GLSL 3.30 and GLSL ES 3.00 "#line n" gives the
+			//	line after it the number n+1 rather than n.  \em pos
+			//	is just past "version" in a #version directive.
+			bool numbers_next_line (const std::string & src, std::size_t pos, std::size_t end) {
+				
+				pos=skip_space(src,pos,end);
+				auto digits=pos;
+				while ((digits<end) && (src[digits]>='0') && (src[digits]<='9')) ++digits;
+				if (digits==pos) return false;
+				
+				auto version=std::stoul(src.substr(pos,digits-pos));
+				if (version>=330) return true;
+				
+				return (version>=300) && starts_with(src,skip_space(src,digits,end),"es");
+				
+			}
+			
+			
+			//	A #line directive which gives the line after it the
+			//	number \em line, and optionally changes the source
+			//	string number
+			std::string line_directive (std::size_t line, bool next_line, std::size_t file=std::string::npos) {
+				
+				std::string retr("#line ");
+				retr+=std::to_string(next_line ? line : (line-1));
+				if (file!=std::string::npos) {
+					
+					retr+=' ';
+					retr+=std::to_string(file);
+					
+				}
+				retr+='\n';
+				
+				return retr;
+				
+			}
+			
+			
+		}
+		
+		
+		std::string inject_defines (const std::string & source, const std::vector<std::string> & defines) {
+			
+			if (defines.empty()) return source;
+			
+			std::string block;
+			for (auto & d : defines) {
+				
+				block+="#define ";
+				block+=d;
+				block+='\n';
+				
+			}
+			
+			//	Compiler messages must still give the line numbers
+			//	of the source as written
+			auto v=source.find("#version");
+			if (v==std::string::npos) return block+line_directive(1,false)+source;
+			
+			auto nl=source.find('\n',v);
+			if (nl==std::string::npos) return source+'\n'+block;
+			
+			auto line=std::size_t(std::count(source.begin(),source.begin()+nl,'\n'))+2;
+			block+=line_directive(line,numbers_next_line(source,v+8,nl));
+			
+			std::string retr;
+			retr.reserve(source.size()+block.size());
+			retr.append(source,0,nl+1);
+			retr+=block;
+			retr.append(source,nl+1,std::string::npos);
+			
+			return retr;
+			
+		}
+		
+		
+		std::vector<std::string> canonical_defines (std::vector<std::string> defines) {
+			
+			std::stable_sort(defines.begin(),defines.end(),[] (const std::string & a, const std::string & b) {	return define_name(a)<define_name(b);	});
+			
+			std::vector<std::string> retr;
+			retr.reserve(defines.size());
+			for (auto & d : defines) {
+				
+				if (!retr.empty() && (define_name(retr.back())==define_name(d))) {
+					
+					if (retr.back()!=d) throw std::logic_error("Conflicting definitions of "+define_name(d));
+					
+					continue;
+					
+				}
+				
+				retr.push_back(std::move(d));
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+		std::string canonical_path (const std::string & path) {
+			
+			char buffer [PATH_MAX];
+			if (realpath(path.c_str(),buffer)==nullptr) return path;
+			
+			return buffer;
+			
+		}
+		
+		
+		const std::string & shader_preprocessor::read (const std::string & path) {
+			
+			auto generated=generated_.find(path);
+			if (generated!=generated_.end()) return generated->second;
+			
+			auto iter=files_.find(path);
+			if (iter!=files_.end()) return iter->second;
+			
+			mapped_file file;
+			try {
+				
+				file=mapped_file(path);
+				
+			} catch (const std::system_error &) {
+				
+				throw shader_compilation_error("Could not open "+path);
+				
+			}
+			
+			std::string contents;
+			if (file.size()!=0) contents.assign(file.data(),file.size());
+			
+			return files_.emplace(path,std::move(contents)).first->second;
+			
+		}
+		
+		
+		std::string shader_preprocessor::resolve (const std::string & from, const std::string & name) const {
+			
+			auto candidate=directory_of(from)+'/'+name;
+			if (exists(candidate)) return canonical_path(candidate);
+			
+			for (auto & dir : include_paths_) {
+				
+				candidate=dir+'/'+name;
+				if (exists(candidate)) return canonical_path(candidate);
+				
+			}
+			
+			throw shader_compilation_error("Could not find "+name+" included from "+from);
+			
+		}
+		
+		
+		bool shader_preprocessor::expand (const std::string & path, expansion & e) {
+			
+			if (!e.included.insert(path).second) return false;
+			
+			auto file=e.files.size();
+			e.files.push_back(path);
+			//	Whether the next line written needs a #line
+			//	directive, which is not written before the #version
+			//	directive since nothing but comments may precede it
+			auto pending=file!=0;
+			std::size_t line=1;
+			auto & src=read(path);
+			for (std::size_t begin=0;begin<src.size();++line) {
+				
+				auto end=src.find('\n',begin);
+				auto next=(end==std::string::npos) ? src.size() : (end+1);
+				if (end==std::string::npos) end=src.size();
+				
+				auto pos=skip_space(src,begin,end);
+				auto version=false;
+				if ((pos<end) && (src[pos]=='#')) {
+					
+					auto directive=skip_space(src,pos+1,end);
+					if (starts_with(src,directive,"include")) {
+						
+						auto open=skip_space(src,directive+7,end);
+						auto close_char=((open<end) && (src[open]=='<')) ? '>' : '"';
+						auto close=src.find(close_char,open+1);
+						if ((open>=end) || ((src[open]!='"') && (src[open]!='<')) || (close==std::string::npos) || (close>=end)) {
+							
+							throw shader_compilation_error("Malformed #include in "+path);
+							
+						}
+						
+						auto name=src.substr(open+1,close-open-1);
+						if (expand((generated_.count(name)==0) ? resolve(path,name) : name,e)) pending=true;
+						begin=next;
+						continue;
+						
+					}
+					
+					if (starts_with(src,directive,"pragma") && starts_with(src,skip_space(src,directive+6,end),"once")) {
+						
+						begin=next;
+						continue;
+						
+					}
+					
+					if (starts_with(src,directive,"version")) {
+						
+						version=true;
+						e.next_line=numbers_next_line(src,directive+7,end);
+						
+					}
+					
+				}
+				
+				if (pending && !version) {
+					
+					e.out+=line_directive(line,e.next_line,file);
+					pending=false;
+					
+				}
+				e.out.append(src,begin,end-begin);
+				e.out+='\n';
+				begin=next;
+				
+			}
+			
+			return true;
+			
+		}
+		
+		
+		shader_preprocessor::shader_preprocessor (std::vector<std::string> include_paths) : include_paths_(std::move(include_paths)) {	}
+		
+		
+		const std::string & shader_preprocessor::load (const std::string & filename) {
+			
+			auto iter=expanded_.find(filename);
+			if (iter!=expanded_.end()) return iter->second;
+			
+			auto generated=generated_.count(filename)!=0;
+			if (!(generated || exists(filename))) throw shader_compilation_error("Could not open "+filename);
+			
+			expansion e;
+			e.next_line=false;
+			expand(generated ? filename : canonical_path(filename),e);
+			
+			auto & retr=expanded_.emplace(filename,std::move(e.out)).first->second;
+			//	Files defined in memory cannot change on disk
+			auto & deps=dependencies_[filename];
+			for (auto & path : e.files) if (generated_.count(path)==0) deps.push_back(path);
+			source_strings_[filename]=std::move(e.files);
+			
+			return retr;
+			
+		}
+		
+		
+		const std::vector<std::string> & shader_preprocessor::dependencies (const std::string & filename) {
+			
+			load(filename);
+			
+			return dependencies_.at(filename);
+			
+		}
+		
+		
+		const std::vector<std::string> & shader_preprocessor::source_strings (const std::string & filename) {
+			
+			load(filename);
+			
+			return source_strings_.at(filename);
+			
+		}
+		
+		
+		void shader_preprocessor::invalidate (const std::string & path) {
+			
+			files_.erase(path);
+			
+			for (auto iter=dependencies_.begin();iter!=dependencies_.end();) {
+				
+				if (std::find(iter->second.begin(),iter->second.end(),path)==iter->second.end()) {
+					
+					++iter;
+					continue;
+					
+				}
+				
+				expanded_.erase(iter->first);
+				source_strings_.erase(iter->first);
+				iter=dependencies_.erase(iter);
+				
+			}
+			
+		}
+		
+		
+		void shader_preprocessor::define (const std::string & name, std::string source) {
+			
+			generated_[name]=std::move(source);
+			expanded_.clear();
+			dependencies_.clear();
+			source_strings_.clear();
+			
+		}
+		
+		
+		void shader_preprocessor::clear () noexcept {
+			
+			files_.clear();
+			expanded_.clear();
+			dependencies_.clear();
+			source_strings_.clear();
+			
+		}
+		
+		
+	}
+	
+	
+}
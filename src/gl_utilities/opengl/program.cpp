@@ -5,8 +5,10 @@
 #include <cstdlib>
 #include <memory>
 #include <new>
-#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 
 namespace gl_utilities {
@@ -32,7 +34,10 @@ namespace gl_utilities {
 		}
 		
 		
-		program::program (program && other) noexcept : handle_(other.handle_) {
+		program::program (GLuint handle) noexcept : handle_(handle) {	}
+		
+		
+		program::program (program && other) noexcept : handle_(other.handle_), reflection_(std::move(other.reflection_)), shadow_(std::move(other.shadow_)) {
 			
 			other.handle_=0;
 			
@@ -44,6 +49,8 @@ namespace gl_utilities {
 			destroy();
 			
 			std::swap(other.handle_,handle_);
+			std::swap(other.reflection_,reflection_);
+			std::swap(other.shadow_,shadow_);
 			
 			return *this;
 			
@@ -64,6 +71,31 @@ namespace gl_utilities {
 		}
 		
 		
+		program program::separable (GLenum type, const std::string & src) {
+			
+			auto str=src.c_str();
+			auto handle=glCreateShaderProgramv(type,1,&str);
+			//	Compilation errors are not reported here, they
+			//	end up in the info log of the program and are
+			//	reported by check
+			if (handle==0) raise();
+			
+			program retr(handle);
+			retr.check();
+			
+			return retr;
+			
+		}
+		
+		
+		void program::set_separable (bool separable) {
+			
+			glProgramParameteri(handle_,GL_PROGRAM_SEPARABLE,separable ? GL_TRUE : GL_FALSE);
+			raise();
+			
+		}
+		
+		
 		void program::attach (const shader & s) {
 			
 			glAttachShader(handle_,s);
@@ -74,13 +106,46 @@ namespace gl_utilities {
 		
 		void program::link () {
 			
+			link_async();
+			check();
+			
+		}
+		
+		
+		void program::link_async () {
+			
 			glLinkProgram(handle_);
 			raise();
 			
+		}
+		
+		
+		bool program::completed () const {
+			
+			if (!(GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile)) return true;
+			
+			GLint retr;
+			glGetProgramiv(handle_,GL_COMPLETION_STATUS_KHR,&retr);
+			raise();
+			
+			return retr==GL_TRUE;
+			
+		}
+		
+		
+		void program::check () {
+			
 			GLint success;
 			glGetProgramiv(handle_,GL_LINK_STATUS,&success);
 			raise();
-			if (success==GL_TRUE) return;
+			if (success==GL_TRUE) {
+				
+				reflection_.reflect(handle_);
+				shadow_.reset(handle_,reflection_);
+				
+				return;
+				
+			}
 			
 			//	Link failed
 			GLint msglen;
@@ -168,7 +233,24 @@ namespace gl_utilities {
 		
 		GLint program::attribute_location (const char * name) const {
 			
-			auto retr=glGetAttribLocation(handle_,name);
+			return attribute_location(resource_name(name));
+			
+		}
+		
+		
+		GLint program::attribute_location (const std::string & name) const {
+			
+			return attribute_location(resource_name(name));
+			
+		}
+		
+		
+		GLint program::attribute_location (const resource_name & name) const {
+			
+			auto r=reflection_.attribute(name);
+			if (r!=nullptr) return r->location;
+			
+			auto retr=glGetAttribLocation(handle_,std::string(name.str,name.len).c_str());
 			raise();
 			//	If the attribute isn't found OpenGL elects
 			//	to not report this as an error through the
@@ -178,37 +260,361 @@ namespace gl_utilities {
 			//	Wonderful design, this is PHP levels of greatness
 			if (retr!=-1) return retr;
 			
-			std::ostringstream ss;
-			ss << "Could not find attribute \"" << name << "\"";
-			throw attribute_not_found_error(ss.str());
+			std::string msg("Could not find attribute \"");
+			msg.append(name.str,name.len);
+			msg+='"';
+			throw attribute_not_found_error(msg);
 			
 		}
 		
 		
-		GLint program::attribute_location (const std::string & name) const {
+		GLint program::uniform_location (const char * name) const {
 			
-			return attribute_location(name.c_str());
+			return uniform_location(resource_name(name));
 			
 		}
 		
 		
-		GLint program::uniform_location (const char * name) const {
+		GLint program::uniform_location (const std::string & name) const {
 			
-			auto retr=glGetUniformLocation(handle_,name);
-			raise();
+			return uniform_location(resource_name(name));
+			
+		}
+		
+		
+		GLint program::uniform_location (const resource_name & name) const {
+			
+			//	Uniforms within blocks do not have locations
+			auto r=reflection_.uniform(name);
+			if ((r!=nullptr) && (r->location!=-1)) return r->location;
+			
+			GLint retr=-1;
+			if (r==nullptr) {
+				
+				retr=glGetUniformLocation(handle_,std::string(name.str,name.len).c_str());
+				raise();
+				
+			}
 			//	See rant above in attribute_location
 			if (retr!=-1) return retr;
 			
-			std::ostringstream ss;
-			ss << "Could not find uniform \"" << name << "\"";
-			throw uniform_not_found_error(ss.str());
+			std::string msg("Could not find uniform \"");
+			msg.append(name.str,name.len);
+			msg+='"';
+			throw uniform_not_found_error(msg);
 			
 		}
 		
 		
-		GLint program::uniform_location (const std::string & name) const {
+		const program_reflection & program::reflection () const noexcept {
+			
+			return reflection_;
+			
+		}
+		
+		
+		//	Uploads are made with glProgramUniform where available,
+		//	otherwise the program is made current for the duration
+		//	of the upload
+		template <typename Separate, typename Current>
+		void program::upload (GLint location, const void * data, std::size_t bytes, Separate separate, Current current) {
+			
+			if (!shadow_.update(location,data,bytes)) return;
+			
+			try {
+				
+				if (GLEW_VERSION_4_1 || GLEW_ARB_separate_shader_objects) {
+					
+					separate();
+					
+				} else {
+					
+					auto g=use();
+					current();
+					
+				}
+				raise();
+				
+			} catch (...) {
+				
+				//	The shadow no longer reflects what OpenGL has
+				shadow_.invalidate();
+				
+				throw;
+				
+			}
+			
+		}
+		
+		
+		void program::set_uniform (GLint location, GLfloat x) {
+			
+			set_uniform_vector(location,1,1,&x);
+			
+		}
+		
+		
+		void program::set_uniform (GLint location, GLint x) {
+			
+			set_uniform_vector(location,1,1,&x);
+			
+		}
+		
+		
+		void program::set_uniform (GLint location, GLuint x) {
+			
+			set_uniform_vector(location,1,1,&x);
+			
+		}
+		
+		
+		void program::set_uniform_vector (GLint location, GLsizei components, GLsizei count, const GLfloat * v) {
+			
+			if ((components<1) || (components>4)) throw std::logic_error("Vectors must have between 1 and 4 components");
+			
+			upload(location,v,sizeof(GLfloat)*std::size_t(components*count),[&] () {
+				
+				switch (components) {
+					
+					case 1:
+						glProgramUniform1fv(handle_,location,count,v);
+						break;
+					case 2:
+						glProgramUniform2fv(handle_,location,count,v);
+						break;
+					case 3:
+						glProgramUniform3fv(handle_,location,count,v);
+						break;
+					default:
+						glProgramUniform4fv(handle_,location,count,v);
+						break;
+					
+				}
+				
+			},[&] () {
+				
+				switch (components) {
+					
+					case 1:
+						glUniform1fv(location,count,v);
+						break;
+					case 2:
+						glUniform2fv(location,count,v);
+						break;
+					case 3:
+						glUniform3fv(location,count,v);
+						break;
+					default:
+						glUniform4fv(location,count,v);
+						break;
+					
+				}
+				
+			});
+			
+		}
+		
+		
+		void program::set_uniform_vector (GLint location, GLsizei components, GLsizei count, const GLint * v) {
+			
+			if ((components<1) || (components>4)) throw std::logic_error("Vectors must have between 1 and 4 components");
+			
+			upload(location,v,sizeof(GLint)*std::size_t(components*count),[&] () {
+				
+				switch (components) {
+					
+					case 1:
+						glProgramUniform1iv(handle_,location,count,v);
+						break;
+					case 2:
+						glProgramUniform2iv(handle_,location,count,v);
+						break;
+					case 3:
+						glProgramUniform3iv(handle_,location,count,v);
+						break;
+					default:
+						glProgramUniform4iv(handle_,location,count,v);
+						break;
+					
+				}
+				
+			},[&] () {
+				
+				switch (components) {
+					
+					case 1:
+						glUniform1iv(location,count,v);
+						break;
+					case 2:
+						glUniform2iv(location,count,v);
+						break;
+					case 3:
+						glUniform3iv(location,count,v);
+						break;
+					default:
+						glUniform4iv(location,count,v);
+						break;
+					
+				}
+				
+			});
+			
+		}
+		
+		
+		void program::set_uniform_vector (GLint location, GLsizei components, GLsizei count, const GLuint * v) {
+			
+			if ((components<1) || (components>4)) throw std::logic_error("Vectors must have between 1 and 4 components");
+			
+			upload(location,v,sizeof(GLuint)*std::size_t(components*count),[&] () {
+				
+				switch (components) {
+					
+					case 1:
+						glProgramUniform1uiv(handle_,location,count,v);
+						break;
+					case 2:
+						glProgramUniform2uiv(handle_,location,count,v);
+						break;
+					case 3:
+						glProgramUniform3uiv(handle_,location,count,v);
+						break;
+					default:
+						glProgramUniform4uiv(handle_,location,count,v);
+						break;
+					
+				}
+				
+			},[&] () {
+				
+				switch (components) {
+					
+					case 1:
+						glUniform1uiv(location,count,v);
+						break;
+					case 2:
+						glUniform2uiv(location,count,v);
+						break;
+					case 3:
+						glUniform3uiv(location,count,v);
+						break;
+					default:
+						glUniform4uiv(location,count,v);
+						break;
+					
+				}
+				
+			});
+			
+		}
+		
+		
+		void program::set_uniform_matrix (GLint location, GLsizei columns, GLsizei rows, GLsizei count, GLboolean transpose, const GLfloat * v) {
+			
+			if ((columns<2) || (columns>4) || (rows<2) || (rows>4)) throw std::logic_error("Matrices must have between 2 and 4 columns and rows");
+			
+			//	The shadow compares bytes, so row major matrices are
+			//	converted to column major before being compared and
+			//	uploaded
+			std::vector<GLfloat> column_major;
+			if (transpose!=GL_FALSE) {
+				
+				auto size=std::size_t(columns*rows);
+				column_major.resize(size*std::size_t(count));
+				for (std::size_t m=0;m<std::size_t(count);++m) for (GLsizei c=0;c<columns;++c) for (GLsizei r=0;r<rows;++r) {
+					
+					column_major[(m*size)+std::size_t((c*rows)+r)]=v[(m*size)+std::size_t((r*columns)+c)];
+					
+				}
+				v=column_major.data();
+				transpose=GL_FALSE;
+				
+			}
+			
+			auto dims=(columns*10)+rows;
+			upload(location,v,sizeof(GLfloat)*std::size_t(columns*rows*count),[&] () {
+				
+				switch (dims) {
+					
+					case 22:
+						glProgramUniformMatrix2fv(handle_,location,count,transpose,v);
+						break;
+					case 23:
+						glProgramUniformMatrix2x3fv(handle_,location,count,transpose,v);
+						break;
+					case 24:
+						glProgramUniformMatrix2x4fv(handle_,location,count,transpose,v);
+						break;
+					case 32:
+						glProgramUniformMatrix3x2fv(handle_,location,count,transpose,v);
+						break;
+					case 33:
+						glProgramUniformMatrix3fv(handle_,location,count,transpose,v);
+						break;
+					case 34:
+						glProgramUniformMatrix3x4fv(handle_,location,count,transpose,v);
+						break;
+					case 42:
+						glProgramUniformMatrix4x2fv(handle_,location,count,transpose,v);
+						break;
+					case 43:
+						glProgramUniformMatrix4x3fv(handle_,location,count,transpose,v);
+						break;
+					default:
+						glProgramUniformMatrix4fv(handle_,location,count,transpose,v);
+						break;
+					
+				}
+				
+			},[&] () {
+				
+				switch (dims) {
+					
+					case 22:
+						glUniformMatrix2fv(location,count,transpose,v);
+						break;
+					case 23:
+						glUniformMatrix2x3fv(location,count,transpose,v);
+						break;
+					case 24:
+						glUniformMatrix2x4fv(location,count,transpose,v);
+						break;
+					case 32:
+						glUniformMatrix3x2fv(location,count,transpose,v);
+						break;
+					case 33:
+						glUniformMatrix3fv(location,count,transpose,v);
+						break;
+					case 34:
+						glUniformMatrix3x4fv(location,count,transpose,v);
+						break;
+					case 42:
+						glUniformMatrix4x2fv(location,count,transpose,v);
+						break;
+					case 43:
+						glUniformMatrix4x3fv(location,count,transpose,v);
+						break;
+					default:
+						glUniformMatrix4fv(location,count,transpose,v);
+						break;
+					
+				}
+				
+			});
+			
+		}
+		
+		
+		const uniform_shadow & program::shadow () const noexcept {
+			
+			return shadow_;
+			
+		}
+		
+		
+		uniform_shadow & program::shadow () noexcept {
 			
-			return uniform_location(name.c_str());
+			return shadow_;
 			
 		}
 		
@@ -0,0 +1,102 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/program_batch.hpp>
+#include <stdexcept>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		program_batch::entry & program_batch::get_entry (std::size_t i) {
+			
+			auto & retr=entries_.at(i);
+			if (!retr.p) throw std::logic_error("Program has already been taken");
+			
+			return retr;
+			
+		}
+		
+		
+		const program_batch::entry & program_batch::get_entry (std::size_t i) const {
+			
+			auto & retr=entries_.at(i);
+			if (!retr.p) throw std::logic_error("Program has already been taken");
+			
+			return retr;
+			
+		}
+		
+		
+		std::size_t program_batch::add (const std::vector<shader_source> & sources) {
+			
+			entry e;
+			e.p.emplace();
+			e.shaders.reserve(sources.size());
+			for (auto & s : sources) {
+				
+				e.shaders.push_back(shader::deferred(s.type,s.source));
+				e.p->attach(e.shaders.back());
+				
+			}
+			//	Linking may be issued before compilation finishes,
+			//	the implementation orders the two
+			e.p->link_async();
+			
+			entries_.push_back(std::move(e));
+			
+			return entries_.size()-1;
+			
+		}
+		
+		
+		std::size_t program_batch::size () const noexcept {
+			
+			return entries_.size();
+			
+		}
+		
+		
+		bool program_batch::completed (std::size_t i) const {
+			
+			return get_entry(i).p->completed();
+			
+		}
+		
+		
+		std::size_t program_batch::pending () const {
+			
+			std::size_t retr=0;
+			for (auto & e : entries_) if (e.p && !e.p->completed()) ++retr;
+			
+			return retr;
+			
+		}
+		
+		
+		program program_batch::take (std::size_t i) {
+			
+			auto & e=get_entry(i);
+			//	Checking shaders first means that a compilation
+			//	failure is reported as such rather than as a link
+			//	failure with a less useful log
+			for (auto & s : e.shaders) s.check();
+			e.p->check();
+			
+			program retr(std::move(*e.p));
+			e.p=nullopt;
+			e.shaders.clear();
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
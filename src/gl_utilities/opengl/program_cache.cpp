@@ -0,0 +1,454 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/hash.hpp>
+#include <gl_utilities/program_cache.hpp>
+#include <gl_utilities/system_error.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			const char magic [4]={'G','L','P','B'};
+			const std::uint32_t version=1;
+			const char extension []=".bin";
+			
+			
+			//	Zero if the file does not exist
+			std::size_t file_size (const std::string & path) noexcept {
+				
+				struct stat s;
+				if (stat(path.c_str(),&s)!=0) return 0;
+				
+				return std::size_t(s.st_size);
+				
+			}
+			
+			
+			//	Binaries are only ever read back on the machine
+			//	which wrote them so the header is written in the
+			//	native representation
+			class header {
+				
+				
+				public:
+				
+				
+					char magic [4];
+					std::uint32_t version;
+					std::uint64_t key;
+					std::uint32_t format;
+					std::uint32_t length;
+				
+				
+			};
+			
+			
+			class file {
+				
+				
+				public:
+				
+				
+					std::string path;
+					std::size_t size;
+					std::time_t modified;
+				
+				
+			};
+			
+			
+			bool ends_with (const std::string & str, const char * suffix) noexcept {
+				
+				auto len=std::strlen(suffix);
+				if (str.size()<len) return false;
+				
+				return str.compare(str.size()-len,len,suffix)==0;
+				
+			}
+			
+			
+			std::uint64_t driver () {
+				
+				std::uint64_t retr=fnv1a_offset_basis;
+				for (auto name : {GL_VENDOR,GL_RENDERER,GL_VERSION}) {
+					
+					auto str=reinterpret_cast<const char *>(glGetString(name));
+					raise();
+					std::string s((str==nullptr) ? "" : str);
+					retr=fnv1a_integer(s.size(),retr);
+					retr=fnv1a(s,retr);
+					
+				}
+				
+				return retr;
+				
+			}
+			
+			
+			bool binaries_supported () {
+				
+				if (!GLEW_ARB_get_program_binary) return false;
+				
+				GLint formats;
+				glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS,&formats);
+				raise();
+				
+				return formats>0;
+				
+			}
+			
+			
+		}
+		
+		
+		std::string program_cache::path (std::uint64_t key) const {
+			
+			std::ostringstream ss;
+			ss << directory_ << '/' << std::hex << std::setw(16) << std::setfill('0') << key << extension;
+			
+			return ss.str();
+			
+		}
+		
+		
+		optional<program> program_cache::load (std::uint64_t key) {
+			
+			auto p=path(key);
+			std::ifstream is(p.c_str(),std::ios::binary);
+			//	Not cached
+			if (!is) return nullopt;
+			
+			auto reject=[&] () {
+				
+				++rejections_;
+				auto size=file_size(p);
+				if (std::remove(p.c_str())==0) used_-=std::min(used_,size);
+				
+			};
+			
+			header h;
+			std::vector<char> data;
+			if (
+				!is.read(reinterpret_cast<char *>(&h),sizeof(h)) ||
+				(std::memcmp(h.magic,magic,sizeof(magic))!=0) ||
+				(h.version!=version) ||
+				(h.key!=key)
+			) {
+				
+				reject();
+				return nullopt;
+				
+			}
+			data.resize(h.length);
+			if (!is.read(data.data(),data.size()) || (is.peek()!=std::char_traits<char>::eof())) {
+				
+				reject();
+				return nullopt;
+				
+			}
+			
+			program retr;
+			glProgramBinary(retr,h.format,data.data(),GLsizei(h.length));
+			//	An unsupported format is reported through the usual
+			//	error channel, but that just means the binary is stale
+			last_error();
+			try {
+				
+				retr.check();
+				
+			} catch (const program_linking_error &) {
+				
+				reject();
+				return nullopt;
+				
+			}
+			
+			//	Bump the modification time so that this binary is
+			//	the most recently used when pruning
+			utime(p.c_str(),nullptr);
+			
+			return optional<program>(std::move(retr));
+			
+		}
+		
+		
+		void program_cache::save (std::uint64_t key, const program & p) {
+			
+			GLint len;
+			glGetProgramiv(p,GL_PROGRAM_BINARY_LENGTH,&len);
+			raise();
+			if (len<=0) return;
+			
+			header h;
+			std::memcpy(h.magic,magic,sizeof(magic));
+			h.version=version;
+			h.key=key;
+			std::vector<char> data(len);
+			GLsizei written;
+			GLenum format;
+			glGetProgramBinary(p,len,&written,&format,data.data());
+			raise();
+			h.format=format;
+			h.length=std::uint32_t(written);
+			
+			//	Failing to write to the cache is not an error, the
+			//	program will simply be compiled again next time
+			auto final_path=path(key);
+			std::ostringstream ss;
+			ss << final_path << ".tmp" << getpid();
+			auto temp_path=ss.str();
+			{
+				
+				std::ofstream os(temp_path.c_str(),std::ios::binary|std::ios::trunc);
+				os.write(reinterpret_cast<const char *>(&h),sizeof(h));
+				os.write(data.data(),written);
+				os.flush();
+				if (!os) {
+					
+					std::remove(temp_path.c_str());
+					return;
+					
+				}
+				
+			}
+			//	A binary being replaced no longer counts
+			auto replaced=file_size(final_path);
+			if (std::rename(temp_path.c_str(),final_path.c_str())!=0) {
+				
+				std::remove(temp_path.c_str());
+				return;
+				
+			}
+			used_-=std::min(used_,replaced);
+			used_+=sizeof(h)+std::size_t(written);
+			
+			if (used_>max_size_) prune();
+			
+		}
+		
+		
+		void program_cache::prune () {
+			
+			std::unique_ptr<DIR,int (*) (DIR *)> dir(opendir(directory_.c_str()),&closedir);
+			if (!dir) return;
+			
+			std::vector<file> files;
+			std::size_t total=0;
+			while (auto e=readdir(dir.get())) {
+				
+				std::string name(e->d_name);
+				if (!ends_with(name,extension)) continue;
+				
+				file f;
+				f.path=directory_+'/'+name;
+				struct stat s;
+				if (stat(f.path.c_str(),&s)!=0) continue;
+				f.size=std::size_t(s.st_size);
+				f.modified=s.st_mtime;
+				total+=f.size;
+				files.push_back(std::move(f));
+				
+			}
+			used_=total;
+			if (total<=max_size_) return;
+			
+			//	Pruning to just within the limit would have a full
+			//	cache scan the directory on every write, so an
+			//	eighth of the limit is left free
+			auto target=max_size_-(max_size_/8);
+			std::sort(files.begin(),files.end(),[] (const file & a, const file & b) noexcept {	return a.modified<b.modified;	});
+			for (auto & f : files) {
+				
+				if (total<=target) break;
+				
+				if (std::remove(f.path.c_str())==0) total-=f.size;
+				
+			}
+			used_=total;
+			
+		}
+		
+		
+		program_cache::program_cache (std::string directory, std::size_t max_size)
+			:	directory_(std::move(directory)),
+				max_size_(max_size),
+				used_(0),
+				driver_(driver()),
+				supported_(binaries_supported()),
+				hits_(0),
+				misses_(0),
+				rejections_(0)
+		{
+			
+			if ((mkdir(directory_.c_str(),0777)!=0) && (errno!=EEXIST)) gl_utilities::raise();
+			
+			//	Establishes the size of the cache and brings it
+			//	within the limit should the limit have shrunk
+			prune();
+			
+		}
+		
+		
+		std::uint64_t program_cache::key (const std::vector<stage> & stages, const std::vector<std::string> & defines) const {
+			
+			//	Sources are hashed individually (so that hashes
+			//	computed ahead of time may be used) and lengths are
+			//	hashed along with definitions so that moving text
+			//	between strings changes the key
+			auto retr=fnv1a_integer(stages.size(),driver_);
+			for (auto & s : stages) {
+				
+				retr=fnv1a_integer(s.type,retr);
+				retr=fnv1a_integer(s.hash,retr);
+				
+			}
+			retr=fnv1a_integer(defines.size(),retr);
+			for (auto & d : defines) {
+				
+				retr=fnv1a_integer(d.size(),retr);
+				retr=fnv1a(d,retr);
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+		program program_cache::build (const std::vector<stage> & stages, const std::vector<std::string> & defines) {
+			
+			auto k=key(stages,defines);
+			if (supported_) {
+				
+				auto cached=load(k);
+				if (cached) {
+					
+					++hits_;
+					return std::move(*cached);
+					
+				}
+				
+			}
+			++misses_;
+			
+			program retr;
+			//	Shaders are flagged for deletion when they go out
+			//	of scope but live on while attached
+			std::vector<shader> shaders;
+			shaders.reserve(stages.size());
+			for (auto & s : stages) {
+				
+				if (defines.empty()) shaders.emplace_back(s.type,std::vector<source_fragment>{s.source});
+				else shaders.emplace_back(s.type,inject_defines(std::string(s.source.data,s.source.size),defines));
+				retr.attach(shaders.back());
+				
+			}
+			if (supported_) {
+				
+				glProgramParameteri(retr,GL_PROGRAM_BINARY_RETRIEVABLE_HINT,GL_TRUE);
+				raise();
+				
+			}
+			retr.link();
+			
+			if (supported_) save(k,retr);
+			
+			return retr;
+			
+		}
+		
+		
+		std::uint64_t program_cache::key (const std::vector<shader_source> & sources, const std::vector<std::string> & defines) const {
+			
+			std::vector<stage> stages;
+			stages.reserve(sources.size());
+			for (auto & s : sources) stages.push_back(stage{s.type,fnv1a(s.source),source_fragment{s.source.data(),s.source.size()}});
+			
+			return key(stages,defines);
+			
+		}
+		
+		
+		program program_cache::get (const std::vector<shader_source> & sources, const std::vector<std::string> & defines) {
+			
+			std::vector<stage> stages;
+			stages.reserve(sources.size());
+			for (auto & s : sources) stages.push_back(stage{s.type,fnv1a(s.source),source_fragment{s.source.data(),s.source.size()}});
+			
+			return build(stages,defines);
+			
+		}
+		
+		
+		program program_cache::get (const std::vector<embedded_shader> & stages, const std::vector<std::string> & defines) {
+			
+			std::vector<stage> converted;
+			converted.reserve(stages.size());
+			for (auto & s : stages) converted.push_back(stage{s.type,s.source->hash,source_fragment{s.source->data,s.source->size}});
+			
+			return build(converted,defines);
+			
+		}
+		
+		
+		void program_cache::store (const std::vector<shader_source> & sources, const std::vector<std::string> & defines, const program & p) {
+			
+			if (supported_) save(key(sources,defines),p);
+			
+		}
+		
+		
+		bool program_cache::supported () const noexcept {
+			
+			return supported_;
+			
+		}
+		
+		
+		std::size_t program_cache::hits () const noexcept {
+			
+			return hits_;
+			
+		}
+		
+		
+		std::size_t program_cache::misses () const noexcept {
+			
+			return misses_;
+			
+		}
+		
+		
+		std::size_t program_cache::rejections () const noexcept {
+			
+			return rejections_;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,169 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/opengl.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		void program_pipeline::destroy () noexcept {
+			
+			if (handle_==0) return;
+			
+			glDeleteProgramPipelines(1,&handle_);
+			handle_=0;
+			
+		}
+		
+		
+		program_pipeline::program_pipeline () {
+			
+			glGenProgramPipelines(1,&handle_);
+			raise();
+			
+		}
+		
+		
+		program_pipeline::program_pipeline (program_pipeline && other) noexcept : handle_(other.handle_) {
+			
+			other.handle_=0;
+			
+		}
+		
+		
+		program_pipeline & program_pipeline::operator = (program_pipeline && other) noexcept {
+			
+			destroy();
+			
+			std::swap(handle_,other.handle_);
+			
+			return *this;
+			
+		}
+		
+		
+		program_pipeline::~program_pipeline () noexcept {
+			
+			destroy();
+			
+		}
+		
+		
+		program_pipeline::operator GLuint () const noexcept {
+			
+			return handle_;
+			
+		}
+		
+		
+		void program_pipeline::use_stages (GLbitfield stages, const program & p) {
+			
+			glUseProgramStages(handle_,stages,p);
+			raise();
+			
+		}
+		
+		
+		void program_pipeline::clear_stages (GLbitfield stages) {
+			
+			glUseProgramStages(handle_,stages,0);
+			raise();
+			
+		}
+		
+		
+		void program_pipeline::active_program (const program & p) {
+			
+			glActiveShaderProgram(handle_,p);
+			raise();
+			
+		}
+		
+		
+		void program_pipeline::validate () const {
+			
+			glValidateProgramPipeline(handle_);
+			raise();
+			
+			GLint success;
+			glGetProgramPipelineiv(handle_,GL_VALIDATE_STATUS,&success);
+			raise();
+			if (success==GL_TRUE) return;
+			
+			GLint msglen;
+			glGetProgramPipelineiv(handle_,GL_INFO_LOG_LENGTH,&msglen);
+			raise();
+			if (msglen==0) throw program_linking_error{};
+			std::vector<char> buffer(msglen);
+			glGetProgramPipelineInfoLog(handle_,msglen,nullptr,buffer.data());
+			raise();
+			throw program_linking_error(std::string(buffer.begin(),buffer.end()-1));
+			
+		}
+		
+		
+		void program_pipeline::guard::destroy () noexcept {
+			
+			if (!d_) return;
+			
+			glBindProgramPipeline(d_->pipeline);
+			raise();
+			glUseProgram(d_->program);
+			raise();
+			d_=nullopt;
+			
+		}
+		
+		
+		program_pipeline::guard::guard () : d_(in_place) {
+			
+			GLint old;
+			glGetIntegerv(GL_CURRENT_PROGRAM,&old);
+			raise();
+			d_->program=old;
+			glGetIntegerv(GL_PROGRAM_PIPELINE_BINDING,&old);
+			raise();
+			d_->pipeline=old;
+			
+		}
+		
+		
+		program_pipeline::guard::guard (guard && other) noexcept {
+			
+			std::swap(d_,other.d_);
+			
+		}
+		
+		
+		program_pipeline::guard::~guard () noexcept {
+			
+			destroy();
+			
+		}
+		
+		
+		program_pipeline::guard program_pipeline::use () const {
+			
+			guard retr;
+			
+			glUseProgram(0);
+			raise();
+			glBindProgramPipeline(handle_);
+			raise();
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,380 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/opengl.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			program_resource make_resource (GLuint index) noexcept {
+				
+				program_resource retr;
+				retr.index=index;
+				retr.location=-1;
+				retr.type=0;
+				retr.array_size=1;
+				retr.block_index=-1;
+				retr.offset=-1;
+				retr.binding=-1;
+				retr.data_size=0;
+				
+				return retr;
+				
+			}
+			
+			
+			//	OpenGL reports arrays as "name[0]", they are made
+			//	available under "name" as well
+			template <typename Table>
+			void insert (Table & t, const char * name, std::size_t len, const program_resource & r) {
+				
+				t.insert(resource_name(name,len),r);
+				
+				const char suffix []="[0]";
+				auto suffix_len=sizeof(suffix)-1;
+				if ((len>suffix_len) && (std::memcmp(name+(len-suffix_len),suffix,suffix_len)==0)) t.insert(resource_name(name,len-suffix_len),r);
+				
+			}
+			
+			
+			template <typename Table>
+			void reflect_interface (GLuint p, GLenum iface, Table & t) {
+				
+				GLint count;
+				glGetProgramInterfaceiv(p,iface,GL_ACTIVE_RESOURCES,&count);
+				GLint max_len;
+				glGetProgramInterfaceiv(p,iface,GL_MAX_NAME_LENGTH,&max_len);
+				raise();
+				
+				std::vector<char> name(std::size_t(std::max(max_len,1)));
+				const GLenum variable_props []={GL_TYPE,GL_ARRAY_SIZE,GL_BLOCK_INDEX,GL_OFFSET};
+				const GLenum block_props []={GL_BUFFER_BINDING,GL_BUFFER_DATA_SIZE};
+				for (GLint i=0;i<count;++i) {
+					
+					auto r=make_resource(GLuint(i));
+					GLsizei len;
+					glGetProgramResourceName(p,iface,GLuint(i),GLsizei(name.size()),&len,name.data());
+					switch (iface) {
+						
+						case GL_UNIFORM_BLOCK:
+						case GL_SHADER_STORAGE_BLOCK:{
+							
+							GLint values [2];
+							glGetProgramResourceiv(p,iface,GLuint(i),2,block_props,2,nullptr,values);
+							r.binding=values[0];
+							r.data_size=values[1];
+							
+						}break;
+						case GL_PROGRAM_INPUT:{
+							
+							GLint values [2];
+							glGetProgramResourceiv(p,iface,GLuint(i),2,variable_props,2,nullptr,values);
+							r.type=GLenum(values[0]);
+							r.array_size=values[1];
+							r.location=glGetProgramResourceLocation(p,iface,name.data());
+							
+						}break;
+						default:{
+							
+							GLint values [4];
+							glGetProgramResourceiv(p,iface,GLuint(i),4,variable_props,4,nullptr,values);
+							r.type=GLenum(values[0]);
+							r.array_size=values[1];
+							r.block_index=values[2];
+							r.offset=values[3];
+							if (iface==GL_UNIFORM) r.location=glGetProgramResourceLocation(p,iface,name.data());
+							
+						}break;
+						
+					}
+					raise();
+					
+					insert(t,name.data(),std::size_t(len),r);
+					
+				}
+				
+			}
+			
+			
+			template <typename Table>
+			void reflect_attributes (GLuint p, Table & t) {
+				
+				GLint count;
+				glGetProgramiv(p,GL_ACTIVE_ATTRIBUTES,&count);
+				GLint max_len;
+				glGetProgramiv(p,GL_ACTIVE_ATTRIBUTE_MAX_LENGTH,&max_len);
+				raise();
+				
+				std::vector<char> name(std::size_t(std::max(max_len,1)));
+				for (GLint i=0;i<count;++i) {
+					
+					auto r=make_resource(GLuint(i));
+					GLsizei len;
+					glGetActiveAttrib(p,GLuint(i),GLsizei(name.size()),&len,&r.array_size,&r.type,name.data());
+					r.location=glGetAttribLocation(p,name.data());
+					raise();
+					
+					insert(t,name.data(),std::size_t(len),r);
+					
+				}
+				
+			}
+			
+			
+			template <typename Table>
+			void reflect_uniforms (GLuint p, Table & t) {
+				
+				GLint count;
+				glGetProgramiv(p,GL_ACTIVE_UNIFORMS,&count);
+				GLint max_len;
+				glGetProgramiv(p,GL_ACTIVE_UNIFORM_MAX_LENGTH,&max_len);
+				raise();
+				
+				bool blocks=GLEW_VERSION_3_1 || GLEW_ARB_uniform_buffer_object;
+				std::vector<char> name(std::size_t(std::max(max_len,1)));
+				for (GLint i=0;i<count;++i) {
+					
+					auto r=make_resource(GLuint(i));
+					GLsizei len;
+					glGetActiveUniform(p,GLuint(i),GLsizei(name.size()),&len,&r.array_size,&r.type,name.data());
+					r.location=glGetUniformLocation(p,name.data());
+					if (blocks) {
+						
+						auto index=GLuint(i);
+						glGetActiveUniformsiv(p,1,&index,GL_UNIFORM_BLOCK_INDEX,&r.block_index);
+						glGetActiveUniformsiv(p,1,&index,GL_UNIFORM_OFFSET,&r.offset);
+						
+					}
+					raise();
+					
+					insert(t,name.data(),std::size_t(len),r);
+					
+				}
+				
+			}
+			
+			
+			template <typename Table>
+			void reflect_uniform_blocks (GLuint p, Table & t) {
+				
+				if (!(GLEW_VERSION_3_1 || GLEW_ARB_uniform_buffer_object)) return;
+				
+				GLint count;
+				glGetProgramiv(p,GL_ACTIVE_UNIFORM_BLOCKS,&count);
+				GLint max_len;
+				glGetProgramiv(p,GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH,&max_len);
+				raise();
+				
+				std::vector<char> name(std::size_t(std::max(max_len,1)));
+				for (GLint i=0;i<count;++i) {
+					
+					auto r=make_resource(GLuint(i));
+					GLsizei len;
+					glGetActiveUniformBlockName(p,GLuint(i),GLsizei(name.size()),&len,name.data());
+					glGetActiveUniformBlockiv(p,GLuint(i),GL_UNIFORM_BLOCK_BINDING,&r.binding);
+					glGetActiveUniformBlockiv(p,GLuint(i),GL_UNIFORM_BLOCK_DATA_SIZE,&r.data_size);
+					raise();
+					
+					insert(t,name.data(),std::size_t(len),r);
+					
+				}
+				
+			}
+			
+			
+		}
+		
+		
+		void program_reflection::table::place (const slot & s) noexcept {
+			
+			auto mask=slots_.size()-1;
+			for (auto i=std::size_t(s.hash)&mask;;i=(i+1)&mask) {
+				
+				if (slots_[i].used) continue;
+				
+				slots_[i]=s;
+				return;
+				
+			}
+			
+		}
+		
+		
+		program_reflection::table::table () noexcept : size_(0) {	}
+		
+		
+		void program_reflection::table::insert (const resource_name & name, const program_resource & resource) {
+			
+			if (find(name)!=nullptr) return;
+			
+			//	Keeping the load factor at or below one half keeps
+			//	probe sequences short
+			if (((size_+1)*2)>slots_.size()) {
+				
+				std::vector<slot> old(std::max<std::size_t>(slots_.size()*2,8));
+				std::swap(old,slots_);
+				for (auto & s : old) if (s.used) place(s);
+				
+			}
+			
+			if (names_.size()>std::numeric_limits<std::uint32_t>::max()) throw std::length_error("Too many resource names");
+			
+			slot s;
+			s.hash=name.hash;
+			s.name=std::uint32_t(names_.size());
+			s.length=std::uint32_t(name.len);
+			s.used=true;
+			s.resource=resource;
+			names_.append(name.str,name.len);
+			place(s);
+			++size_;
+			
+		}
+		
+		
+		const program_resource * program_reflection::table::find (const resource_name & name) const noexcept {
+			
+			if (slots_.empty()) return nullptr;
+			
+			auto mask=slots_.size()-1;
+			for (auto i=std::size_t(name.hash)&mask;;i=(i+1)&mask) {
+				
+				auto & s=slots_[i];
+				if (!s.used) return nullptr;
+				if (
+					(s.hash==name.hash) &&
+					(s.length==name.len) &&
+					(names_.compare(s.name,s.length,name.str,name.len)==0)
+				) return &s.resource;
+				
+			}
+			
+		}
+		
+		
+		void program_reflection::table::for_each (const std::function<void (const resource_name &, const program_resource &)> & func) const {
+			
+			for (auto & s : slots_) if (s.used) func(resource_name(names_.data()+s.name,s.length),s.resource);
+			
+		}
+		
+		
+		std::size_t program_reflection::table::size () const noexcept {
+			
+			return size_;
+			
+		}
+		
+		
+		void program_reflection::table::clear () noexcept {
+			
+			slots_.clear();
+			names_.clear();
+			size_=0;
+			
+		}
+		
+		
+		void program_reflection::reflect (GLuint p) {
+			
+			clear();
+			
+			if (GLEW_ARB_program_interface_query) {
+				
+				reflect_interface(p,GL_UNIFORM,uniforms_);
+				reflect_interface(p,GL_PROGRAM_INPUT,attributes_);
+				reflect_interface(p,GL_UNIFORM_BLOCK,uniform_blocks_);
+				if (GLEW_ARB_shader_storage_buffer_object) {
+					
+					reflect_interface(p,GL_SHADER_STORAGE_BLOCK,storage_blocks_);
+					reflect_interface(p,GL_BUFFER_VARIABLE,buffer_variables_);
+					
+				}
+				
+				return;
+				
+			}
+			
+			reflect_uniforms(p,uniforms_);
+			reflect_attributes(p,attributes_);
+			reflect_uniform_blocks(p,uniform_blocks_);
+			
+		}
+		
+		
+		void program_reflection::clear () noexcept {
+			
+			uniforms_.clear();
+			attributes_.clear();
+			uniform_blocks_.clear();
+			storage_blocks_.clear();
+			buffer_variables_.clear();
+			
+		}
+		
+		
+		const program_resource * program_reflection::uniform (const resource_name & name) const noexcept {
+			
+			return uniforms_.find(name);
+			
+		}
+		
+		
+		const program_resource * program_reflection::attribute (const resource_name & name) const noexcept {
+			
+			return attributes_.find(name);
+			
+		}
+		
+		
+		const program_resource * program_reflection::uniform_block (const resource_name & name) const noexcept {
+			
+			return uniform_blocks_.find(name);
+			
+		}
+		
+		
+		const program_resource * program_reflection::storage_block (const resource_name & name) const noexcept {
+			
+			return storage_blocks_.find(name);
+			
+		}
+		
+		
+		const program_resource * program_reflection::buffer_variable (const resource_name & name) const noexcept {
+			
+			return buffer_variables_.find(name);
+			
+		}
+		
+		
+		void program_reflection::for_each_uniform (const std::function<void (const resource_name &, const program_resource &)> & func) const {
+			
+			uniforms_.for_each(func);
+			
+		}
+		
+		
+		void program_reflection::for_each_attribute (const std::function<void (const resource_name &, const program_resource &)> & func) const {
+			
+			attributes_.for_each(func);
+			
+		}
+		
+		
+	}
+	
+	
+}
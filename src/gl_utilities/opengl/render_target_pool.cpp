@@ -0,0 +1,406 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/hash.hpp>
+#include <gl_utilities/render_target_pool.hpp>
+#include <gl_utilities/residency.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			bool is_color (GLenum attachment) noexcept {
+				
+				return (attachment!=GL_DEPTH_ATTACHMENT) &&
+					(attachment!=GL_STENCIL_ATTACHMENT) &&
+					(attachment!=GL_DEPTH_STENCIL_ATTACHMENT);
+				
+			}
+			
+			
+			texture make_texture (const render_target_description & desc, const render_target_attachment & a) {
+				
+				texture retr;
+				if (desc.samples>0) {
+					
+					auto g=retr.bind(GL_TEXTURE_2D_MULTISAMPLE);
+					glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE,desc.samples,a.internal_format,desc.width,desc.height,GL_TRUE);
+					raise();
+					
+				} else {
+					
+					//	glTexImage2D would require a format and type
+					//	compatible with each internal format
+					if (!GLEW_ARB_texture_storage) throw error("Sampled render targets require ARB_texture_storage");
+					
+					auto g=retr.bind(GL_TEXTURE_2D);
+					glTexStorage2D(GL_TEXTURE_2D,1,a.internal_format,desc.width,desc.height);
+					raise();
+					
+				}
+				
+				return retr;
+				
+			}
+			
+			
+			render_buffer make_render_buffer (const render_target_description & desc, const render_target_attachment & a) {
+				
+				render_buffer retr;
+				auto g=retr.bind();
+				glRenderbufferStorageMultisample(GL_RENDERBUFFER,desc.samples,a.internal_format,desc.width,desc.height);
+				raise();
+				
+				return retr;
+				
+			}
+			
+			
+		}
+		
+		
+		bool render_target_attachment::operator == (const render_target_attachment & other) const noexcept {
+			
+			return (attachment==other.attachment) &&
+				(internal_format==other.internal_format) &&
+				(sampled==other.sampled);
+			
+		}
+		
+		
+		bool render_target_description::operator == (const render_target_description & other) const noexcept {
+			
+			return (width==other.width) &&
+				(height==other.height) &&
+				(samples==other.samples) &&
+				(attachments==other.attachments);
+			
+		}
+		
+		
+		std::size_t render_target_description::size () const {
+			
+			std::size_t retr=0;
+			for (auto & a : attachments) retr+=estimate_size(a.internal_format,width,height,1,samples);
+			
+			return retr;
+			
+		}
+		
+		
+		render_target::render_target (render_target_description desc) : description(std::move(desc)) {
+			
+			if ((description.width<=0) || (description.height<=0)) throw std::logic_error("Render targets must not be empty");
+			
+			auto g=fb.bind(GL_FRAMEBUFFER);
+			std::vector<GLenum> draw_buffers;
+			textures.reserve(description.attachments.size());
+			render_buffers.reserve(description.attachments.size());
+			for (auto & a : description.attachments) {
+				
+				if (a.sampled) {
+					
+					textures.emplace_back(make_texture(description,a));
+					render_buffers.emplace_back();
+					auto target=(description.samples>0) ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+					glFramebufferTexture2D(GL_FRAMEBUFFER,a.attachment,target,*textures.back(),0);
+					
+				} else {
+					
+					textures.emplace_back();
+					render_buffers.emplace_back(make_render_buffer(description,a));
+					glFramebufferRenderbuffer(GL_FRAMEBUFFER,a.attachment,GL_RENDERBUFFER,*render_buffers.back());
+					
+				}
+				raise();
+				
+				if (is_color(a.attachment)) draw_buffers.push_back(a.attachment);
+				
+			}
+			
+			if (draw_buffers.empty()) {
+				
+				glDrawBuffer(GL_NONE);
+				raise();
+				glReadBuffer(GL_NONE);
+				raise();
+				
+			} else {
+				
+				glDrawBuffers(GLsizei(draw_buffers.size()),draw_buffers.data());
+				raise();
+				glReadBuffer(draw_buffers.front());
+				raise();
+				
+			}
+			
+			auto status=glCheckFramebufferStatus(GL_FRAMEBUFFER);
+			raise();
+			if (status!=GL_FRAMEBUFFER_COMPLETE) throw error("Render target frame buffer is incomplete");
+			
+		}
+		
+		
+		const texture & render_target::get_texture (GLenum attachment) const {
+			
+			for (std::size_t i=0;i<description.attachments.size();++i) if (description.attachments[i].attachment==attachment) {
+				
+				if (!textures[i]) throw std::logic_error("Attachment is not sampled");
+				
+				return *textures[i];
+				
+			}
+			
+			throw std::logic_error("No such attachment");
+			
+		}
+		
+		
+		void render_target_pool::lease::destroy () noexcept {
+			
+			if (pool_==nullptr) return;
+			
+			pool_->release(std::move(*t_),bytes_);
+			t_=nullopt;
+			pool_=nullptr;
+			
+		}
+		
+		
+		render_target_pool::lease::lease () noexcept : pool_(nullptr), bytes_(0) {	}
+		
+		
+		render_target_pool::lease::lease (render_target_pool & pool, render_target t, std::size_t bytes) noexcept : pool_(&pool), t_(std::move(t)), bytes_(bytes) {	}
+		
+		
+		render_target_pool::lease::lease (lease && other) noexcept : pool_(other.pool_), t_(std::move(other.t_)), bytes_(other.bytes_) {
+			
+			other.pool_=nullptr;
+			other.t_=nullopt;
+			
+		}
+		
+		
+		render_target_pool::lease & render_target_pool::lease::operator = (lease && other) noexcept {
+			
+			destroy();
+			
+			pool_=other.pool_;
+			t_=std::move(other.t_);
+			bytes_=other.bytes_;
+			other.pool_=nullptr;
+			other.t_=nullopt;
+			
+			return *this;
+			
+		}
+		
+		
+		render_target_pool::lease::~lease () noexcept {
+			
+			destroy();
+			
+		}
+		
+		
+		const render_target & render_target_pool::lease::operator * () const noexcept {
+			
+			return *t_;
+			
+		}
+		
+		
+		const render_target * render_target_pool::lease::operator -> () const noexcept {
+			
+			return &*t_;
+			
+		}
+		
+		
+		std::size_t render_target_pool::hasher::operator () (const render_target_description & desc) const noexcept {
+			
+			auto retr=fnv1a_integer(desc.width);
+			retr=fnv1a_integer(desc.height,retr);
+			retr=fnv1a_integer(desc.samples,retr);
+			for (auto & a : desc.attachments) {
+				
+				retr=fnv1a_integer(a.attachment,retr);
+				retr=fnv1a_integer(a.internal_format,retr);
+				retr=fnv1a_integer(a.sampled ? 1 : 0,retr);
+				
+			}
+			
+			return std::size_t(retr);
+			
+		}
+		
+		
+		render_target_pool::entry render_target_pool::create (const render_target_description & desc) {
+			
+			auto bytes=desc.size();
+			entry retr{render_target(desc),bytes,frame_,false};
+			
+			size_+=bytes;
+			peak_=std::max(peak_,size_);
+			frame_peak_=std::max(frame_peak_,size_);
+			++created_;
+			
+			return retr;
+			
+		}
+		
+		
+		void render_target_pool::release (render_target t, std::size_t bytes) noexcept {
+			
+			try {
+				
+				auto & list=free_[t.description];
+				list.push_back(entry{std::move(t),bytes,frame_,false});
+				
+			} catch (...) {
+				
+				//	The render target is deleted instead of being
+				//	recycled, which is always safe
+				size_-=bytes;
+				
+			}
+			
+		}
+		
+		
+		render_target_pool::render_target_pool (std::size_t max_idle_frames) noexcept
+			:	max_idle_(max_idle_frames),
+				frame_(0),
+				size_(0),
+				peak_(0),
+				frame_peak_(0),
+				steady_(0),
+				created_(0),
+				reused_(0)
+		{	}
+		
+		
+		render_target_pool::lease render_target_pool::acquire (const render_target_description & desc) {
+			
+			auto iter=free_.find(desc);
+			if ((iter==free_.end()) || iter->second.empty()) {
+				
+				auto e=create(desc);
+				
+				return lease(*this,std::move(e.t),e.bytes);
+				
+			}
+			
+			//	The most recently released render target is the
+			//	most likely to still be resident
+			auto e=std::move(iter->second.back());
+			iter->second.pop_back();
+			++reused_;
+			
+			return lease(*this,std::move(e.t),e.bytes);
+			
+		}
+		
+		
+		void render_target_pool::reserve (const render_target_description & desc, std::size_t count) {
+			
+			auto & list=free_[desc];
+			list.reserve(count);
+			while (list.size()<count) {
+				
+				list.push_back(create(desc));
+				list.back().reserved=true;
+				
+			}
+			
+		}
+		
+		
+		void render_target_pool::end_frame () {
+			
+			++frame_;
+			
+			//	Reserved render targets may sit anywhere in a free
+			//	list, so the order of the rest (which acquire
+			//	relies on) is kept by removing idle ones in place
+			for (auto iter=free_.begin();iter!=free_.end();) {
+				
+				auto & list=iter->second;
+				auto idle=std::stable_partition(list.begin(),list.end(),[&] (const entry & e) noexcept {	return e.reserved || ((frame_-e.frame)<=max_idle_);	});
+				for (auto i=idle;i!=list.end();++i) size_-=i->bytes;
+				list.erase(idle,list.end());
+				
+				if (list.empty()) iter=free_.erase(iter);
+				else ++iter;
+				
+			}
+			
+			steady_=frame_peak_;
+			frame_peak_=size_;
+			
+		}
+		
+		
+		void render_target_pool::clear () noexcept {
+			
+			for (auto & pair : free_) for (auto & e : pair.second) size_-=e.bytes;
+			free_.clear();
+			
+		}
+		
+		
+		std::uint64_t render_target_pool::frame () const noexcept {
+			
+			return frame_;
+			
+		}
+		
+		
+		std::size_t render_target_pool::size () const noexcept {
+			
+			return size_;
+			
+		}
+		
+		
+		std::size_t render_target_pool::peak () const noexcept {
+			
+			return peak_;
+			
+		}
+		
+		
+		std::size_t render_target_pool::steady () const noexcept {
+			
+			return steady_;
+			
+		}
+		
+		
+		std::size_t render_target_pool::created () const noexcept {
+			
+			return created_;
+			
+		}
+		
+		
+		std::size_t render_target_pool::reused () const noexcept {
+			
+			return reused_;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,645 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/residency.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			class format_info {
+				
+				
+				public:
+				
+				
+					//	For uncompressed formats the size of
+					//	a single pixel, for compressed formats
+					//	the size of a single block
+					std::size_t bytes;
+					std::size_t block;
+				
+				
+			};
+			
+			
+			format_info get_format_info (GLenum internal_format) {
+				
+				switch (internal_format) {
+					
+					case GL_R8:
+					case GL_R8_SNORM:
+					case GL_R8I:
+					case GL_R8UI:
+					case GL_STENCIL_INDEX8:
+						return {1,1};
+					case GL_RG8:
+					case GL_RG8_SNORM:
+					case GL_RG8I:
+					case GL_RG8UI:
+					case GL_R16:
+					case GL_R16_SNORM:
+					case GL_R16F:
+					case GL_R16I:
+					case GL_R16UI:
+					case GL_RGB565:
+					case GL_RGB5_A1:
+					case GL_RGBA4:
+					case GL_DEPTH_COMPONENT16:
+						return {2,1};
+					//	Three component formats are padded to four
+					//	by essentially every implementation
+					case GL_RGB8:
+					case GL_RGB8_SNORM:
+					case GL_RGB8I:
+					case GL_RGB8UI:
+					case GL_SRGB8:
+					case GL_RGBA8:
+					case GL_RGBA8_SNORM:
+					case GL_RGBA8I:
+					case GL_RGBA8UI:
+					case GL_SRGB8_ALPHA8:
+					case GL_RGB10_A2:
+					case GL_RGB10_A2UI:
+					case GL_R11F_G11F_B10F:
+					case GL_RGB9_E5:
+					case GL_RG16:
+					case GL_RG16_SNORM:
+					case GL_RG16F:
+					case GL_RG16I:
+					case GL_RG16UI:
+					case GL_R32F:
+					case GL_R32I:
+					case GL_R32UI:
+					case GL_DEPTH_COMPONENT24:
+					case GL_DEPTH_COMPONENT32:
+					case GL_DEPTH_COMPONENT32F:
+					case GL_DEPTH24_STENCIL8:
+						return {4,1};
+					case GL_RGB16:
+					case GL_RGB16_SNORM:
+					case GL_RGB16F:
+					case GL_RGB16I:
+					case GL_RGB16UI:
+					case GL_RGBA16:
+					case GL_RGBA16_SNORM:
+					case GL_RGBA16F:
+					case GL_RGBA16I:
+					case GL_RGBA16UI:
+					case GL_RG32F:
+					case GL_RG32I:
+					case GL_RG32UI:
+					case GL_DEPTH32F_STENCIL8:
+						return {8,1};
+					case GL_RGB32F:
+					case GL_RGB32I:
+					case GL_RGB32UI:
+						return {12,1};
+					case GL_RGBA32F:
+					case GL_RGBA32I:
+					case GL_RGBA32UI:
+						return {16,1};
+					case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+					case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+					case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+					case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+					case GL_COMPRESSED_RED_RGTC1:
+					case GL_COMPRESSED_SIGNED_RED_RGTC1:
+					case GL_COMPRESSED_RGB8_ETC2:
+					case GL_COMPRESSED_SRGB8_ETC2:
+					case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+					case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+					case GL_COMPRESSED_R11_EAC:
+					case GL_COMPRESSED_SIGNED_R11_EAC:
+						return {8,4};
+					case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+					case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+					case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+					case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+					case GL_COMPRESSED_RG_RGTC2:
+					case GL_COMPRESSED_SIGNED_RG_RGTC2:
+					case GL_COMPRESSED_RGBA_BPTC_UNORM:
+					case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+					case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+					case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+					case GL_COMPRESSED_RGBA8_ETC2_EAC:
+					case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+					case GL_COMPRESSED_RG11_EAC:
+					case GL_COMPRESSED_SIGNED_RG11_EAC:
+						return {16,4};
+					default:
+						throw std::logic_error("Unknown internal format");
+					
+				}
+				
+			}
+			
+			
+			GLsizei level_dimension (GLsizei d, GLsizei level) noexcept {
+				
+				return std::max(d>>level,1);
+				
+			}
+			
+			
+			bool is_array (GLenum target) noexcept {
+				
+				return (target==GL_TEXTURE_1D_ARRAY) || (target==GL_TEXTURE_2D_ARRAY) || (target==GL_TEXTURE_2D_MULTISAMPLE_ARRAY) || (target==GL_TEXTURE_CUBE_MAP_ARRAY);
+				
+			}
+			
+			
+			//	The sampling state kept in a texture object, which
+			//	must follow a texture when it is replaced
+			class texture_parameters {
+				
+				
+				public:
+				
+				
+					GLint min_filter;
+					GLint mag_filter;
+					GLint wrap [3];
+					GLint swizzle [4];
+					GLint compare_mode;
+					GLint compare_func;
+					GLint base_level;
+					GLint max_level;
+					GLfloat min_lod;
+					GLfloat max_lod;
+					GLfloat lod_bias;
+					GLfloat border_color [4];
+					GLfloat max_anisotropy;
+					
+					
+					//	Reads the parameters of the texture bound
+					//	to target
+					static texture_parameters get (GLenum target) {
+						
+						texture_parameters retr;
+						glGetTexParameteriv(target,GL_TEXTURE_MIN_FILTER,&retr.min_filter);
+						glGetTexParameteriv(target,GL_TEXTURE_MAG_FILTER,&retr.mag_filter);
+						glGetTexParameteriv(target,GL_TEXTURE_WRAP_S,&retr.wrap[0]);
+						glGetTexParameteriv(target,GL_TEXTURE_WRAP_T,&retr.wrap[1]);
+						glGetTexParameteriv(target,GL_TEXTURE_WRAP_R,&retr.wrap[2]);
+						glGetTexParameteriv(target,GL_TEXTURE_SWIZZLE_RGBA,retr.swizzle);
+						glGetTexParameteriv(target,GL_TEXTURE_COMPARE_MODE,&retr.compare_mode);
+						glGetTexParameteriv(target,GL_TEXTURE_COMPARE_FUNC,&retr.compare_func);
+						glGetTexParameteriv(target,GL_TEXTURE_BASE_LEVEL,&retr.base_level);
+						glGetTexParameteriv(target,GL_TEXTURE_MAX_LEVEL,&retr.max_level);
+						glGetTexParameterfv(target,GL_TEXTURE_MIN_LOD,&retr.min_lod);
+						glGetTexParameterfv(target,GL_TEXTURE_MAX_LOD,&retr.max_lod);
+						glGetTexParameterfv(target,GL_TEXTURE_LOD_BIAS,&retr.lod_bias);
+						glGetTexParameterfv(target,GL_TEXTURE_BORDER_COLOR,retr.border_color);
+						retr.max_anisotropy=1.0f;
+						if (GLEW_EXT_texture_filter_anisotropic || GLEW_ARB_texture_filter_anisotropic) glGetTexParameterfv(target,GL_TEXTURE_MAX_ANISOTROPY_EXT,&retr.max_anisotropy);
+						raise();
+						
+						return retr;
+						
+					}
+					
+					
+					//	Writes the parameters to the texture bound
+					//	to target, which lacks the first dropped
+					//	levels of the original
+					void set (GLenum target, GLint dropped) const {
+						
+						glTexParameteri(target,GL_TEXTURE_MIN_FILTER,min_filter);
+						glTexParameteri(target,GL_TEXTURE_MAG_FILTER,mag_filter);
+						glTexParameteri(target,GL_TEXTURE_WRAP_S,wrap[0]);
+						glTexParameteri(target,GL_TEXTURE_WRAP_T,wrap[1]);
+						glTexParameteri(target,GL_TEXTURE_WRAP_R,wrap[2]);
+						glTexParameteriv(target,GL_TEXTURE_SWIZZLE_RGBA,swizzle);
+						glTexParameteri(target,GL_TEXTURE_COMPARE_MODE,compare_mode);
+						glTexParameteri(target,GL_TEXTURE_COMPARE_FUNC,compare_func);
+						//	Levels are renumbered, level i of the
+						//	replacement being level i+dropped of the
+						//	original
+						glTexParameteri(target,GL_TEXTURE_BASE_LEVEL,std::max(base_level-dropped,0));
+						glTexParameteri(target,GL_TEXTURE_MAX_LEVEL,std::max(max_level-dropped,0));
+						glTexParameterf(target,GL_TEXTURE_MIN_LOD,min_lod);
+						glTexParameterf(target,GL_TEXTURE_MAX_LOD,max_lod);
+						glTexParameterf(target,GL_TEXTURE_LOD_BIAS,lod_bias);
+						glTexParameterfv(target,GL_TEXTURE_BORDER_COLOR,border_color);
+						if (GLEW_EXT_texture_filter_anisotropic || GLEW_ARB_texture_filter_anisotropic) glTexParameterf(target,GL_TEXTURE_MAX_ANISOTROPY_EXT,max_anisotropy);
+						raise();
+						
+					}
+				
+				
+			};
+			
+			
+			//	The storage which remains when the largest levels
+			//	are dropped
+			texture_storage without_levels (const texture_storage & s, GLsizei dropped) noexcept {
+				
+				auto retr=s;
+				retr.width=level_dimension(s.width,dropped);
+				if (s.target!=GL_TEXTURE_1D_ARRAY) retr.height=level_dimension(s.height,dropped);
+				if (s.target==GL_TEXTURE_3D) retr.depth=level_dimension(s.depth,dropped);
+				retr.levels-=dropped;
+				
+				return retr;
+				
+			}
+			
+			
+			//	The depth passed to glCopyImageSubData, which treats
+			//	the faces of cube maps as layers
+			GLsizei copy_depth (const texture_storage & s, GLsizei level) noexcept {
+				
+				if (s.target==GL_TEXTURE_3D) return level_dimension(s.depth,level);
+				if (s.target==GL_TEXTURE_CUBE_MAP) return 6;
+				if (is_array(s.target)) return s.depth;
+				
+				return 1;
+				
+			}
+			
+			
+		}
+		
+		
+		std::size_t estimate_size (GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth, GLsizei samples) {
+			
+			auto info=get_format_info(internal_format);
+			auto blocks=[&] (GLsizei d) noexcept {	return (std::size_t(d)+info.block-1)/info.block;	};
+			
+			return blocks(width)*blocks(height)*std::size_t(depth)*info.bytes*std::size_t(std::max(samples,1));
+			
+		}
+		
+		
+		std::size_t texture_storage::size () const {
+			
+			std::size_t retr=0;
+			for (GLsizei i=0;i<levels;++i) {
+				
+				GLsizei d;
+				if (target==GL_TEXTURE_3D) d=level_dimension(depth,i);
+				else d=depth;
+				//	Layers of 1D array textures are stored in
+				//	the height
+				GLsizei h=(target==GL_TEXTURE_1D_ARRAY) ? height : level_dimension(height,i);
+				retr+=estimate_size(internal_format,level_dimension(width,i),h,d,samples);
+				
+			}
+			
+			//	The depth of cube map arrays already counts
+			//	layer-faces
+			if (target==GL_TEXTURE_CUBE_MAP) retr*=6;
+			
+			return retr;
+			
+		}
+		
+		
+		void residency_manager::allocation::destroy () noexcept {
+			
+			if (m_==nullptr) return;
+			
+			m_->remove_bytes(bytes_);
+			m_=nullptr;
+			
+		}
+		
+		
+		residency_manager::allocation::allocation () noexcept : m_(nullptr), bytes_(0) {	}
+		
+		
+		residency_manager::allocation::allocation (residency_manager & m, std::size_t bytes) noexcept : m_(&m), bytes_(bytes) {
+			
+			m_->add_bytes(bytes_);
+			
+		}
+		
+		
+		residency_manager::allocation::allocation (allocation && other) noexcept : m_(other.m_), bytes_(other.bytes_) {
+			
+			other.m_=nullptr;
+			
+		}
+		
+		
+		residency_manager::allocation & residency_manager::allocation::operator = (allocation && other) noexcept {
+			
+			destroy();
+			
+			std::swap(m_,other.m_);
+			std::swap(bytes_,other.bytes_);
+			
+			return *this;
+			
+		}
+		
+		
+		residency_manager::allocation::~allocation () noexcept {
+			
+			destroy();
+			
+		}
+		
+		
+		std::size_t residency_manager::allocation::size () const noexcept {
+			
+			return bytes_;
+			
+		}
+		
+		
+		residency_manager::entry & residency_manager::get_entry (id i) {
+			
+			auto iter=entries_.find(i);
+			if (iter==entries_.end()) throw std::logic_error("Unknown streamable texture");
+			
+			return iter->second;
+			
+		}
+		
+		
+		const residency_manager::entry & residency_manager::get_entry (id i) const {
+			
+			auto iter=entries_.find(i);
+			if (iter==entries_.end()) throw std::logic_error("Unknown streamable texture");
+			
+			return iter->second;
+			
+		}
+		
+		
+		void residency_manager::add_bytes (std::size_t bytes) noexcept {
+			
+			used_+=bytes;
+			peak_=std::max(peak_,used_);
+			
+		}
+		
+		
+		void residency_manager::remove_bytes (std::size_t bytes) noexcept {
+			
+			used_-=bytes;
+			
+		}
+		
+		
+		GLsizei residency_manager::drop_levels (entry & e) {
+			
+			auto & curr=e.storage;
+			if ((curr.levels<=e.min_levels) || (curr.samples>1)) return 0;
+			if (!(GLEW_ARB_texture_storage && GLEW_ARB_copy_image)) return 0;
+			
+			//	Every level which must go is dropped at once so
+			//	that the texture is only reallocated and copied
+			//	once
+			GLsizei dropped=1;
+			auto next=without_levels(curr,dropped);
+			auto others=used_-curr.size();
+			while ((dropped<(curr.levels-e.min_levels)) && ((others+next.size())>budget_)) next=without_levels(curr,++dropped);
+			
+			//	Binding below stamps both textures, the stamp of the
+			//	original is restored on the replacement so that
+			//	downgrading a texture does not make it recently used
+			auto stamp=e.tex->last_bound();
+			texture_parameters params;
+			{
+				
+				auto g=e.tex->bind(curr.target);
+				params=texture_parameters::get(curr.target);
+				
+			}
+			
+			texture t;
+			{
+				
+				auto g=t.bind(next.target);
+				switch (next.target) {
+					
+					case GL_TEXTURE_1D:
+						glTexStorage1D(next.target,next.levels,next.internal_format,next.width);
+						break;
+					case GL_TEXTURE_2D:
+					case GL_TEXTURE_1D_ARRAY:
+					case GL_TEXTURE_CUBE_MAP:
+						glTexStorage2D(next.target,next.levels,next.internal_format,next.width,next.height);
+						break;
+					case GL_TEXTURE_2D_ARRAY:
+					case GL_TEXTURE_3D:
+					case GL_TEXTURE_CUBE_MAP_ARRAY:
+						glTexStorage3D(next.target,next.levels,next.internal_format,next.width,next.height,next.depth);
+						break;
+					default:
+						//	Not a texture which can have levels
+						return 0;
+					
+				}
+				raise();
+				params.set(next.target,dropped);
+				
+			}
+			
+			for (GLsizei i=0;i<next.levels;++i) {
+				
+				GLsizei h=(next.target==GL_TEXTURE_1D_ARRAY) ? next.height : level_dimension(next.height,i);
+				glCopyImageSubData(*e.tex,curr.target,i+dropped,0,0,0,t,next.target,i,0,0,0,level_dimension(next.width,i),h,copy_depth(next,i));
+				
+			}
+			raise();
+			
+			remove_bytes(curr.size());
+			add_bytes(next.size());
+			t.last_bound(stamp);
+			e.tex=std::move(t);
+			e.storage=next;
+			
+			return dropped;
+			
+		}
+		
+		
+		residency_manager::residency_manager (std::size_t budget) noexcept
+			:	budget_(budget),
+				used_(0),
+				peak_(0),
+				evictions_(0),
+				next_(0)
+		{	}
+		
+		
+		std::size_t residency_manager::budget () const noexcept {
+			
+			return budget_;
+			
+		}
+		
+		
+		void residency_manager::budget (std::size_t bytes) noexcept {
+			
+			budget_=bytes;
+			
+		}
+		
+		
+		std::size_t residency_manager::used () const noexcept {
+			
+			return used_;
+			
+		}
+		
+		
+		std::size_t residency_manager::peak () const noexcept {
+			
+			return peak_;
+			
+		}
+		
+		
+		std::size_t residency_manager::evictions () const noexcept {
+			
+			return evictions_;
+			
+		}
+		
+		
+		residency_manager::allocation residency_manager::account (const texture_storage & storage) {
+			
+			return allocation(*this,storage.size());
+			
+		}
+		
+		
+		residency_manager::allocation residency_manager::account (GLenum internal_format, GLsizei width, GLsizei height, GLsizei samples) {
+			
+			return allocation(*this,estimate_size(internal_format,width,height,1,samples));
+			
+		}
+		
+		
+		residency_manager::id residency_manager::add (texture tex, const texture_storage & storage, evict_type evicted, GLsizei min_levels) {
+			
+			auto bytes=storage.size();
+			
+			entry e;
+			e.tex.emplace(std::move(tex));
+			e.storage=storage;
+			e.min_levels=std::max(min_levels,1);
+			e.evicted=std::move(evicted);
+			
+			auto i=next_++;
+			entries_.emplace(i,std::move(e));
+			add_bytes(bytes);
+			
+			return i;
+			
+		}
+		
+		
+		void residency_manager::replace (id i, texture tex, const texture_storage & storage) {
+			
+			auto & e=get_entry(i);
+			auto bytes=storage.size();
+			
+			if (e.tex) remove_bytes(e.storage.size());
+			e.tex=std::move(tex);
+			e.storage=storage;
+			add_bytes(bytes);
+			
+		}
+		
+		
+		optional<texture> residency_manager::remove (id i) {
+			
+			auto iter=entries_.find(i);
+			if (iter==entries_.end()) throw std::logic_error("Unknown streamable texture");
+			
+			auto retr=std::move(iter->second.tex);
+			if (retr) remove_bytes(iter->second.storage.size());
+			entries_.erase(iter);
+			
+			return retr;
+			
+		}
+		
+		
+		bool residency_manager::resident (id i) const {
+			
+			return bool(get_entry(i).tex);
+			
+		}
+		
+		
+		const texture & residency_manager::get (id i) const {
+			
+			auto & e=get_entry(i);
+			if (!e.tex) throw std::logic_error("Streamable texture is not resident");
+			
+			return *e.tex;
+			
+		}
+		
+		
+		const texture_storage & residency_manager::storage (id i) const {
+			
+			return get_entry(i).storage;
+			
+		}
+		
+		
+		void residency_manager::enforce () {
+			
+			if (used_<=budget_) return;
+			
+			//	Textures may have been bound any number of times
+			//	since the last call so the order must be rebuilt
+			//	from scratch each time
+			std::vector<std::pair<std::uint64_t,id>> lru;
+			for (auto & pair : entries_) if (pair.second.tex) lru.emplace_back(pair.second.tex->last_bound(),pair.first);
+			std::sort(lru.begin(),lru.end());
+			
+			for (auto & pair : lru) {
+				
+				if (used_<=budget_) return;
+				
+				//	Callbacks may have removed textures
+				auto iter=entries_.find(pair.second);
+				if ((iter==entries_.end()) || !iter->second.tex) continue;
+				auto & e=iter->second;
+				auto dropped=drop_levels(e);
+				if (dropped==0) continue;
+				evictions_+=std::size_t(dropped);
+				if (e.evicted) e.evicted(pair.second);
+				
+			}
+			
+			for (auto & pair : lru) {
+				
+				if (used_<=budget_) return;
+				
+				auto iter=entries_.find(pair.second);
+				if ((iter==entries_.end()) || !iter->second.tex) continue;
+				auto & e=iter->second;
+				remove_bytes(e.storage.size());
+				e.tex=nullopt;
+				++evictions_;
+				if (e.evicted) e.evicted(pair.second);
+				
+			}
+			
+		}
+		
+		
+	}
+	
+	
+}
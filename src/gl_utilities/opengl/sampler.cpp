@@ -0,0 +1,231 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/opengl.hpp>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		bool sampler_description::operator == (const sampler_description & other) const noexcept {
+			
+			return (min_filter==other.min_filter) &&
+				(mag_filter==other.mag_filter) &&
+				(wrap_s==other.wrap_s) &&
+				(wrap_t==other.wrap_t) &&
+				(wrap_r==other.wrap_r) &&
+				(max_anisotropy==other.max_anisotropy) &&
+				(lod_bias==other.lod_bias) &&
+				(min_lod==other.min_lod) &&
+				(max_lod==other.max_lod) &&
+				(compare_mode==other.compare_mode) &&
+				(compare_func==other.compare_func) &&
+				(border_color==other.border_color);
+			
+		}
+		
+		
+		bool sampler_description::operator != (const sampler_description & other) const noexcept {
+			
+			return !(*this==other);
+			
+		}
+		
+		
+		static void combine (std::size_t & seed, std::uint32_t value) noexcept {
+			
+			seed^=value+0x9E3779B9U+(seed<<6)+(seed>>2);
+			
+		}
+		
+		
+		static void combine (std::size_t & seed, GLfloat value) noexcept {
+			
+			//	Positive and negative zero compare equal and
+			//	therefore must hash equal
+			if (value==0.0f) value=0.0f;
+			
+			std::uint32_t bits;
+			std::memcpy(&bits,&value,sizeof(bits));
+			combine(seed,bits);
+			
+		}
+		
+		
+		std::size_t sampler_description::hash () const noexcept {
+			
+			std::size_t retr=0;
+			combine(retr,std::uint32_t(min_filter));
+			combine(retr,std::uint32_t(mag_filter));
+			combine(retr,std::uint32_t(wrap_s));
+			combine(retr,std::uint32_t(wrap_t));
+			combine(retr,std::uint32_t(wrap_r));
+			combine(retr,max_anisotropy);
+			combine(retr,lod_bias);
+			combine(retr,min_lod);
+			combine(retr,max_lod);
+			combine(retr,std::uint32_t(compare_mode));
+			combine(retr,std::uint32_t(compare_func));
+			for (auto f : border_color) combine(retr,f);
+			
+			return retr;
+			
+		}
+		
+		
+		void sampler::destroy () noexcept {
+			
+			if (handle_==0) return;
+			
+			glDeleteSamplers(1,&handle_);
+			handle_=0;
+			
+		}
+		
+		
+		sampler::sampler () {
+			
+			glGenSamplers(1,&handle_);
+			raise();
+			
+		}
+		
+		
+		sampler::sampler (sampler && other) noexcept : handle_(other.handle_) {
+			
+			other.handle_=0;
+			
+		}
+		
+		
+		sampler & sampler::operator = (sampler && other) noexcept {
+			
+			destroy();
+			
+			std::swap(other.handle_,handle_);
+			
+			return *this;
+			
+		}
+		
+		
+		sampler::sampler (const sampler_description & desc) : sampler() {
+			
+			set(desc);
+			
+		}
+		
+		
+		sampler::~sampler () noexcept {
+			
+			destroy();
+			
+		}
+		
+		
+		sampler::operator GLuint () const noexcept {
+			
+			return handle_;
+			
+		}
+		
+		
+		void sampler::set (const sampler_description & desc) {
+			
+			glSamplerParameteri(handle_,GL_TEXTURE_MIN_FILTER,GLint(desc.min_filter));
+			glSamplerParameteri(handle_,GL_TEXTURE_MAG_FILTER,GLint(desc.mag_filter));
+			glSamplerParameteri(handle_,GL_TEXTURE_WRAP_S,GLint(desc.wrap_s));
+			glSamplerParameteri(handle_,GL_TEXTURE_WRAP_T,GLint(desc.wrap_t));
+			glSamplerParameteri(handle_,GL_TEXTURE_WRAP_R,GLint(desc.wrap_r));
+			glSamplerParameterf(handle_,GL_TEXTURE_LOD_BIAS,desc.lod_bias);
+			glSamplerParameterf(handle_,GL_TEXTURE_MIN_LOD,desc.min_lod);
+			glSamplerParameterf(handle_,GL_TEXTURE_MAX_LOD,desc.max_lod);
+			glSamplerParameteri(handle_,GL_TEXTURE_COMPARE_MODE,GLint(desc.compare_mode));
+			glSamplerParameteri(handle_,GL_TEXTURE_COMPARE_FUNC,GLint(desc.compare_func));
+			glSamplerParameterfv(handle_,GL_TEXTURE_BORDER_COLOR,desc.border_color.data());
+			raise();
+			
+			//	Anisotropic filtering is an extension (albeit a
+			//	ubiquitous one) prior to OpenGL 4.6.  It is set
+			//	even when it is 1 (the default) so that set may
+			//	lower a value set previously
+			if (GLEW_EXT_texture_filter_anisotropic || GLEW_ARB_texture_filter_anisotropic) {
+				
+				GLfloat max;
+				glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT,&max);
+				raise();
+				glSamplerParameterf(handle_,GL_TEXTURE_MAX_ANISOTROPY_EXT,std::min(std::max(desc.max_anisotropy,1.0f),max));
+				raise();
+				
+			}
+			
+		}
+		
+		
+		void sampler::guard::destroy () noexcept {
+			
+			if (!d_) return;
+			
+			glBindSampler(d_->unit,d_->handle);
+			raise();
+			d_=nullopt;
+			
+		}
+		
+		
+		sampler::guard::guard (GLuint unit) : d_(in_place) {
+			
+			//	GL_SAMPLER_BINDING reports the sampler bound to the
+			//	active texture unit so the unit in question must
+			//	temporarily be made active
+			GLint handle;
+			{
+				
+				auto a=active_texture(unit);
+				glGetIntegerv(GL_SAMPLER_BINDING,&handle);
+				raise();
+				
+			}
+			
+			d_->unit=unit;
+			d_->handle=handle;
+			
+		}
+		
+		
+		sampler::guard::guard (guard && other) noexcept {
+			
+			std::swap(other.d_,d_);
+			
+		}
+		
+		
+		sampler::guard::~guard () noexcept {
+			
+			destroy();
+			
+		}
+		
+		
+		sampler::guard sampler::bind (GLuint unit) const {
+			
+			guard retr(unit);
+			
+			glBindSampler(unit,handle_);
+			raise();
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
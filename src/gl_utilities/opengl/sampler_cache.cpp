@@ -0,0 +1,66 @@
+#include <gl_utilities/opengl.hpp>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		std::size_t sampler_cache::hasher::operator () (const sampler_description & desc) const noexcept {
+			
+			return desc.hash();
+			
+		}
+		
+		
+		std::shared_ptr<const sampler> sampler_cache::get (const sampler_description & desc) {
+			
+			auto iter=map_.find(desc);
+			if (iter!=map_.end()) {
+				
+				auto retr=iter->second.lock();
+				if (retr) return retr;
+				
+				//	The sampler object was deleted since nothing
+				//	referred to it anymore, the entry is discarded
+				//	so that it does not linger if creating a new
+				//	one below throws
+				map_.erase(iter);
+				
+			}
+			
+			auto retr=std::make_shared<const sampler>(desc);
+			map_.emplace(desc,retr);
+			
+			return retr;
+			
+		}
+		
+		
+		void sampler_cache::prune () noexcept {
+			
+			for (auto iter=map_.begin();iter!=map_.end();) {
+				
+				if (iter->second.expired()) iter=map_.erase(iter);
+				else ++iter;
+				
+			}
+			
+		}
+		
+		
+		std::size_t sampler_cache::size () const noexcept {
+			
+			std::size_t retr=0;
+			for (auto & pair : map_) if (!pair.second.expired()) ++retr;
+			
+			return retr;
+			
+		}
+		
+		
+	}
+	
+	
+}
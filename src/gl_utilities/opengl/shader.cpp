@@ -1,13 +1,17 @@
 //	We must include in this order because glew.h insists
 //	on being included before gl.h
 #include <GL/glew.h>
+#include <gl_utilities/mapped_file.hpp>
 #include <gl_utilities/opengl.hpp>
+#include <algorithm>
 #include <cstdlib>
-#include <fstream>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <new>
 #include <sstream>
+#include <stdexcept>
+#include <system_error>
 #include <utility>
 
 
@@ -68,45 +72,129 @@ namespace gl_utilities {
 		
 		shader shader::from_file (GLenum type, const std::string & filename) {
 			
-			std::ifstream is(filename.c_str());
-			if (!is) {
+			return from_file(type,filename,std::vector<std::string>{});
+			
+		}
+		
+		
+		shader shader::from_file (GLenum type, const std::string & filename, const std::vector<std::string> & headers) {
+			
+			mapped_file file;
+			try {
+				
+				file=mapped_file(filename);
+				
+			} catch (const std::system_error & ex) {
 				
 				std::ostringstream ss;
-				ss << "Could not open " << filename;
+				ss << "Could not open " << filename << ": " << ex.what();
 				throw shader_compilation_error(ss.str());
 				
 			}
 			
-			return shader(type,is);
+			std::vector<source_fragment> fragments;
+			fragments.reserve(headers.size()+1);
+			for (auto & h : headers) fragments.push_back(source_fragment{h.data(),h.size()});
+			fragments.push_back(source_fragment{file.data(),file.size()});
+			
+			return shader(type,fragments);
 			
 		}
 		
 		
-		shader::shader (GLenum type, std::istream & is) : handle_(type) {
+		shader shader::from_embedded (GLenum type, const embedded_source & source) {
 			
-			if (handle_==0) raise();
+			return shader(type,std::vector<source_fragment>{source_fragment{source.data,source.size}});
+			
+		}
+		
+		
+		shader shader::from_embedded (GLenum type, const embedded_table & table, const std::string & name) {
+			
+			auto source=table.find(name);
+			if (source==nullptr) throw shader_compilation_error("No embedded source named "+name);
+			
+			return from_embedded(type,*source);
+			
+		}
+		
+		
+		//	Read the entire source code stream
+		shader::shader (GLenum type, std::istream & is) : shader(type,std::string(std::istreambuf_iterator<char>(is),std::istreambuf_iterator<char>{})) {	}
+		
+		
+		shader shader::deferred (GLenum type, const std::string & src) {
+			
+			return deferred(type,std::vector<source_fragment>{source_fragment{src.data(),src.size()}});
+			
+		}
+		
+		
+		shader shader::deferred (GLenum type, const std::vector<source_fragment> & fragments) {
+			
+			inner handle(type);
+			
+			//	glShaderSource takes the length of each string as
+			//	a GLint, so fragments which are longer than that
+			//	can represent are passed as several strings
+			const std::size_t max=std::numeric_limits<GLint>::max();
+			std::vector<const GLchar *> strings;
+			std::vector<GLint> lengths;
+			for (auto & f : fragments) for (std::size_t offset=0;offset<f.size;offset+=max) {
+				
+				strings.push_back(f.data+offset);
+				lengths.push_back(GLint(std::min(max,f.size-offset)));
+				
+			}
+			if (strings.size()>std::size_t(std::numeric_limits<GLsizei>::max())) throw std::length_error("Too many shader source strings");
 			
-			//	Read the entire source code stream
-			typedef std::istreambuf_iterator<char> iterator;
-			std::string src(iterator(is),iterator{});
-			
-			//	Compile
-			auto cstr=src.c_str();
-			//	We assume that this conversion is not lossy
-			//
-			//	NOTE: This may be a very bad assumption, depending
-			//	on the lengths involved
-			GLint len(src.size());
-			glShaderSource(handle_,1,&cstr,&len);
-			glCompileShader(handle_);
+			glShaderSource(handle,GLsizei(strings.size()),strings.data(),lengths.data());
+			glCompileShader(handle);
 			//	glCompileShader may fail if a shader compiler
 			//	is not supported, and therefore we should
 			//	check if it failed and throw if it did
-			//	(glShaderSource only fails if handle_ is
+			//	(glShaderSource only fails if handle is
 			//	invalid, but we know it's valid since we
 			//	just got it from glCreateShader
 			raise();
 			
+			return shader(std::move(handle));
+			
+		}
+		
+		
+		shader::shader (inner handle) noexcept : handle_(std::move(handle)) {	}
+		
+		
+		shader::shader (GLenum type, const std::string & src) : shader(deferred(type,src)) {
+			
+			check();
+			
+		}
+		
+		
+		shader::shader (GLenum type, const std::vector<source_fragment> & fragments) : shader(deferred(type,fragments)) {
+			
+			check();
+			
+		}
+		
+		
+		bool shader::completed () const {
+			
+			if (!(GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile)) return true;
+			
+			GLint retr;
+			glGetShaderiv(handle_,GL_COMPLETION_STATUS_KHR,&retr);
+			raise();
+			
+			return retr==GL_TRUE;
+			
+		}
+		
+		
+		void shader::check () const {
+			
 			//	Check compilation result
 			GLint success;
 			glGetShaderiv(handle_,GL_COMPILE_STATUS,&success);
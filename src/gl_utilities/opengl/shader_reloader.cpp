@@ -0,0 +1,364 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/shader_reloader.hpp>
+#include <gl_utilities/system_error.hpp>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			//	Editors commonly save by writing a new file and
+			//	renaming it over the old one, which would not be
+			//	noticed by a watch on the file itself, so the
+			//	containing directories are watched instead.
+			//	Creation is not watched since a file which has
+			//	just been created is usually still empty, it is
+			//	reported once it has been written and closed
+			const std::uint32_t mask=IN_CLOSE_WRITE|IN_MOVED_TO;
+			
+			
+			std::string directory_of (const std::string & path) {
+				
+				auto slash=path.rfind('/');
+				if (slash==std::string::npos) return ".";
+				
+				return path.substr(0,slash);
+				
+			}
+			
+			
+			//	Equivalent to directory_of(path)==dir without
+			//	allocating
+			bool in_directory (const std::string & path, const std::string & dir) noexcept {
+				
+				auto slash=path.rfind('/');
+				if (slash==std::string::npos) return dir==".";
+				
+				return (slash==dir.size()) && (path.compare(0,slash,dir)==0);
+				
+			}
+			
+			
+		}
+		
+		
+		void shader_reloader::run () {
+			
+			pollfd fds [2]={{fd_,POLLIN,0},{wake_[0],POLLIN,0}};
+			alignas(inotify_event) char buffer [4096];
+			for (;;) {
+				
+				if (::poll(fds,2,-1)<0) {
+					
+					if (errno==EINTR) continue;
+					
+					return;
+					
+				}
+				if (fds[1].revents!=0) return;
+				
+				for (;;) {
+					
+					auto n=read(fd_,buffer,sizeof(buffer));
+					if (n<=0) break;
+					
+					std::lock_guard<std::mutex> l(m_);
+					for (auto p=buffer;p<(buffer+n);) {
+						
+						auto e=reinterpret_cast<const inotify_event *>(p);
+						p+=sizeof(inotify_event)+e->len;
+						if (e->len==0) continue;
+						
+						auto iter=directories_.find(e->wd);
+						if (iter==directories_.end()) continue;
+						
+						changed_.insert(iter->second+'/'+e->name);
+						dirty_.store(true,std::memory_order_release);
+						
+					}
+					
+				}
+				
+			}
+			
+		}
+		
+		
+		void shader_reloader::watch_dependencies (watched & w) {
+			
+			w.dependencies.clear();
+			for (auto & s : w.stages) for (auto & d : pre_.dependencies(s.filename)) {
+				
+				if (std::find(w.dependencies.begin(),w.dependencies.end(),d)==w.dependencies.end()) w.dependencies.push_back(d);
+				
+			}
+			
+			for (auto & d : w.dependencies) {
+				
+				auto dir=directory_of(d);
+				//	Adding a watch to a directory which is already
+				//	watched returns the existing descriptor
+				auto wd=inotify_add_watch(fd_,dir.c_str(),mask);
+				if (wd==-1) gl_utilities::raise();
+				
+				std::lock_guard<std::mutex> l(m_);
+				directories_[wd]=std::move(dir);
+				
+			}
+			
+		}
+		
+		
+		void shader_reloader::unwatch_directories () noexcept {
+			
+			std::lock_guard<std::mutex> l(m_);
+			for (auto iter=directories_.begin();iter!=directories_.end();) {
+				
+				auto & dir=iter->second;
+				auto used=std::any_of(watched_.begin(),watched_.end(),[&] (const std::pair<const id,watched> & p) noexcept {
+					
+					auto & deps=p.second.dependencies;
+					return std::any_of(deps.begin(),deps.end(),[&] (const std::string & d) noexcept {	return in_directory(d,dir);	});
+					
+				});
+				if (used) {
+					
+					++iter;
+					continue;
+					
+				}
+				
+				//	Events already queued for the descriptor are
+				//	dropped by run since it is no longer mapped
+				inotify_rm_watch(fd_,iter->first);
+				iter=directories_.erase(iter);
+				
+			}
+			
+		}
+		
+		
+		void shader_reloader::rebuild (id i, watched & w) {
+			
+			//	A rebuild which is already in progress has been
+			//	superseded
+			flights_.erase(std::remove_if(flights_.begin(),flights_.end(),[&] (const flight & f) noexcept {	return f.which==i;	}),flights_.end());
+			
+			try {
+				
+				std::vector<shader_source> sources;
+				sources.reserve(w.stages.size());
+				for (auto & s : w.stages) sources.push_back(shader_source{s.type,inject_defines(pre_.load(s.filename),w.defines)});
+				//	The set of included files may have changed
+				watch_dependencies(w);
+				unwatch_directories();
+				
+				flight f;
+				f.which=i;
+				f.index=0;
+				if (service_!=nullptr) {
+					
+					f.future=service_->submit(std::move(sources));
+					
+				} else {
+					
+					if (!batch_) batch_.emplace();
+					f.index=batch_->add(sources);
+					
+				}
+				flights_.push_back(std::move(f));
+				
+			} catch (const std::runtime_error & ex) {
+				
+				fail(i,ex.what());
+				
+			}
+			
+		}
+		
+		
+		void shader_reloader::land () {
+			
+			for (auto iter=flights_.begin();iter!=flights_.end();) {
+				
+				auto ready=(service_==nullptr) ? batch_->completed(iter->index) : (iter->future.wait_for(std::chrono::seconds(0))==std::future_status::ready);
+				if (!ready) {
+					
+					++iter;
+					continue;
+					
+				}
+				
+				auto i=iter->which;
+				try {
+					
+					auto p=(service_==nullptr) ? batch_->take(iter->index) : iter->future.get();
+					auto w=watched_.find(i);
+					if (w!=watched_.end()) {
+						
+						*w->second.owner=std::move(p);
+						++reloads_;
+						
+					}
+					
+				} catch (const std::runtime_error & ex) {
+					
+					fail(i,ex.what());
+					
+				}
+				
+				iter=flights_.erase(iter);
+				
+			}
+			
+			if (flights_.empty()) batch_=nullopt;
+			
+		}
+		
+		
+		void shader_reloader::fail (id i, const std::string & what) {
+			
+			++failures_;
+			if (error_) error_(i,what);
+			
+		}
+		
+		
+		shader_reloader::shader_reloader (shader_preprocessor & pre, error_type error, compile_service * service)
+			:	pre_(pre),
+				service_(service),
+				error_(std::move(error)),
+				next_(0),
+				reloads_(0),
+				failures_(0),
+				dirty_(false)
+		{
+			
+			fd_=inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+			if (fd_==-1) gl_utilities::raise();
+			
+			if (pipe2(wake_,O_CLOEXEC)!=0) {
+				
+				auto e=errno;
+				close(fd_);
+				errno=e;
+				gl_utilities::raise();
+				
+			}
+			
+			try {
+				
+				thread_=std::thread([this] () {	run();	});
+				
+			} catch (...) {
+				
+				close(fd_);
+				close(wake_[0]);
+				close(wake_[1]);
+				
+				throw;
+				
+			}
+			
+		}
+		
+		
+		shader_reloader::~shader_reloader () noexcept {
+			
+			char c=0;
+			while ((write(wake_[1],&c,1)==-1) && (errno==EINTR));
+			thread_.join();
+			
+			close(fd_);
+			close(wake_[0]);
+			close(wake_[1]);
+			
+		}
+		
+		
+		shader_reloader::id shader_reloader::watch (program & owner, std::vector<shader_file> stages, std::vector<std::string> defines) {
+			
+			watched w;
+			w.owner=&owner;
+			w.stages=std::move(stages);
+			w.defines=std::move(defines);
+			watch_dependencies(w);
+			
+			auto retr=next_++;
+			watched_.emplace(retr,std::move(w));
+			
+			return retr;
+			
+		}
+		
+		
+		void shader_reloader::unwatch (id i) noexcept {
+			
+			watched_.erase(i);
+			flights_.erase(std::remove_if(flights_.begin(),flights_.end(),[&] (const flight & f) noexcept {	return f.which==i;	}),flights_.end());
+			unwatch_directories();
+			
+		}
+		
+		
+		void shader_reloader::poll () {
+			
+			if (!flights_.empty()) land();
+			
+			if (!dirty_.load(std::memory_order_acquire)) return;
+			
+			std::unordered_set<std::string> changed;
+			{
+				
+				std::lock_guard<std::mutex> l(m_);
+				std::swap(changed,changed_);
+				dirty_.store(false,std::memory_order_relaxed);
+				
+			}
+			
+			for (auto & c : changed) pre_.invalidate(c);
+			
+			for (auto & p : watched_) {
+				
+				auto & deps=p.second.dependencies;
+				if (std::any_of(deps.begin(),deps.end(),[&] (const std::string & d) {	return changed.count(d)!=0;	})) rebuild(p.first,p.second);
+				
+			}
+			
+		}
+		
+		
+		std::size_t shader_reloader::reloads () const noexcept {
+			
+			return reloads_;
+			
+		}
+		
+		
+		std::size_t shader_reloader::failures () const noexcept {
+			
+			return failures_;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,195 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/strip_batch.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			const std::uint32_t restart=0xFFFFFFFFU;
+			
+			
+		}
+		
+		
+		void strip_batch::begin_primitive () {
+			
+			if (primitives_!=0) indices_.push_back(restart);
+			++primitives_;
+			
+		}
+		
+		
+		strip_batch::strip_batch (GLenum mode) : mode_(mode), primitives_(0), max_(0) {
+			
+			switch (mode) {
+				
+				case GL_TRIANGLE_STRIP:
+				case GL_TRIANGLE_FAN:
+				case GL_LINE_STRIP:
+				case GL_LINE_LOOP:
+					break;
+				default:
+					//	Lists gain nothing from restarting since
+					//	they may simply be concatenated
+					throw std::logic_error("Only strips, fans, and loops may be batched");
+				
+			}
+			
+		}
+		
+		
+		void strip_batch::add (const std::uint32_t * indices, std::size_t count, std::uint32_t base_vertex) {
+			
+			if (count==0) return;
+			
+			//	Validate before modifying anything so that a
+			//	failure leaves the batch unchanged
+			auto max=max_;
+			for (std::size_t i=0;i<count;++i) {
+				
+				if (indices[i]>=(restart-base_vertex)) throw std::logic_error("Index collides with the primitive restart index");
+				max=std::max(max,indices[i]+base_vertex);
+				
+			}
+			
+			indices_.reserve(indices_.size()+count+1);
+			begin_primitive();
+			for (std::size_t i=0;i<count;++i) indices_.push_back(indices[i]+base_vertex);
+			max_=max;
+			
+		}
+		
+		
+		void strip_batch::add (std::uint32_t first, std::size_t count) {
+			
+			if (count==0) return;
+			
+			if ((count-1)>=std::size_t(restart-first)) throw std::logic_error("Index collides with the primitive restart index");
+			
+			indices_.reserve(indices_.size()+count+1);
+			begin_primitive();
+			for (std::size_t i=0;i<count;++i) indices_.push_back(first+std::uint32_t(i));
+			max_=std::max(max_,first+std::uint32_t(count-1));
+			
+		}
+		
+		
+		void strip_batch::clear () noexcept {
+			
+			indices_.clear();
+			primitives_=0;
+			max_=0;
+			
+		}
+		
+		
+		GLenum strip_batch::mode () const noexcept {
+			
+			return mode_;
+			
+		}
+		
+		
+		std::size_t strip_batch::primitives () const noexcept {
+			
+			return primitives_;
+			
+		}
+		
+		
+		std::size_t strip_batch::index_count () const noexcept {
+			
+			return indices_.size();
+			
+		}
+		
+		
+		GLenum strip_batch::index_type () const noexcept {
+			
+			//	0xFFFF is reserved for the restart index
+			return (max_<0xFFFFU) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+			
+		}
+		
+		
+		GLuint strip_batch::restart_index () const noexcept {
+			
+			return (index_type()==GL_UNSIGNED_SHORT) ? 0xFFFFU : 0xFFFFFFFFU;
+			
+		}
+		
+		
+		std::vector<std::uint8_t> strip_batch::indices () const {
+			
+			if (index_type()==GL_UNSIGNED_INT) {
+				
+				std::vector<std::uint8_t> retr(indices_.size()*sizeof(std::uint32_t));
+				if (!indices_.empty()) std::memcpy(retr.data(),indices_.data(),retr.size());
+				
+				return retr;
+				
+			}
+			
+			//	Truncation maps the restart index onto 0xFFFF
+			std::vector<std::uint8_t> retr(indices_.size()*sizeof(std::uint16_t));
+			for (std::size_t i=0;i<indices_.size();++i) {
+				
+				auto n=std::uint16_t(indices_[i]);
+				std::memcpy(retr.data()+(i*sizeof(n)),&n,sizeof(n));
+				
+			}
+			
+			return retr;
+			
+		}
+		
+		
+		void strip_batch::upload (const buffer & b, GLenum usage) const {
+			
+			auto data=indices();
+			auto g=b.bind(GL_COPY_WRITE_BUFFER);
+			glBufferData(GL_COPY_WRITE_BUFFER,GLsizeiptr(data.size()),data.data(),usage);
+			raise();
+			
+		}
+		
+		
+		void strip_batch::draw (std::size_t offset) const {
+			
+			if (indices_.empty()) return;
+			
+			auto count=GLsizei(indices_.size());
+			auto ptr=reinterpret_cast<const void *>(offset);
+			if (GLEW_ARB_ES3_compatibility) {
+				
+				auto g=enable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+				glDrawElements(mode_,count,index_type(),ptr);
+				raise();
+				
+				return;
+				
+			}
+			
+			auto g=enable(GL_PRIMITIVE_RESTART);
+			auto ig=primitive_restart_index(restart_index());
+			glDrawElements(mode_,count,index_type(),ptr);
+			raise();
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -2,6 +2,7 @@
 //	on being included before gl.h
 #include <GL/glew.h>
 #include <gl_utilities/opengl.hpp>
+#include <atomic>
 #include <stdexcept>
 #include <utility>
 
@@ -22,7 +23,10 @@ namespace gl_utilities {
 		}
 		
 		
-		texture::texture () {
+		static std::atomic<std::uint64_t> bind_clock(0);
+		
+		
+		texture::texture () : last_bound_(0) {
 			
 			glGenTextures(1,&handle_);
 			raise();
@@ -30,9 +34,10 @@ namespace gl_utilities {
 		}
 		
 		
-		texture::texture (texture && other) noexcept : handle_(other.handle_) {
+		texture::texture (texture && other) noexcept : handle_(other.handle_), last_bound_(other.last_bound_) {
 			
 			other.handle_=0;
+			other.last_bound_=0;
 			
 		}
 		
@@ -42,6 +47,7 @@ namespace gl_utilities {
 			destroy();
 			
 			std::swap(other.handle_,handle_);
+			std::swap(other.last_bound_,last_bound_);
 			
 			return *this;
 			
@@ -73,7 +79,7 @@ namespace gl_utilities {
 		}
 		
 		
-		static GLenum to_get (GLenum type) {
+		GLenum texture::binding (GLenum type) {
 			
 			switch (type) {
 				
@@ -110,7 +116,7 @@ namespace gl_utilities {
 			//	Texture names are technically unsigned integers
 			//	but there's no glGet* for unsigned integers...
 			GLint handle;
-			glGetIntegerv(to_get(type),&handle);
+			glGetIntegerv(binding(type),&handle);
 			raise();
 			
 			d_->handle=handle;
@@ -140,11 +146,29 @@ namespace gl_utilities {
 			glBindTexture(type,handle_);
 			raise();
 			
+			//	Relaxed since this is only used to order
+			//	textures, not to synchronize anything
+			last_bound_=bind_clock.fetch_add(1,std::memory_order_relaxed)+1;
+			
 			return retr;
 			
 		}
 		
 		
+		std::uint64_t texture::last_bound () const noexcept {
+			
+			return last_bound_;
+			
+		}
+		
+		
+		void texture::last_bound (std::uint64_t stamp) noexcept {
+			
+			last_bound_=stamp;
+			
+		}
+		
+		
 	}
 	
 	
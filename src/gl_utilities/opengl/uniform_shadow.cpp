@@ -0,0 +1,208 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/opengl.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			std::size_t type_size (GLenum type) noexcept {
+				
+				switch (type) {
+					
+					case GL_FLOAT_VEC2:
+					case GL_INT_VEC2:
+					case GL_UNSIGNED_INT_VEC2:
+					case GL_BOOL_VEC2:
+					case GL_DOUBLE:
+						return 8;
+					case GL_FLOAT_VEC3:
+					case GL_INT_VEC3:
+					case GL_UNSIGNED_INT_VEC3:
+					case GL_BOOL_VEC3:
+						return 12;
+					case GL_FLOAT_VEC4:
+					case GL_INT_VEC4:
+					case GL_UNSIGNED_INT_VEC4:
+					case GL_BOOL_VEC4:
+					case GL_FLOAT_MAT2:
+					case GL_DOUBLE_VEC2:
+						return 16;
+					case GL_FLOAT_MAT2x3:
+					case GL_FLOAT_MAT3x2:
+					case GL_DOUBLE_VEC3:
+						return 24;
+					case GL_FLOAT_MAT2x4:
+					case GL_FLOAT_MAT4x2:
+					case GL_DOUBLE_VEC4:
+					case GL_DOUBLE_MAT2:
+						return 32;
+					case GL_FLOAT_MAT3:
+						return 36;
+					case GL_FLOAT_MAT3x4:
+					case GL_FLOAT_MAT4x3:
+					case GL_DOUBLE_MAT2x3:
+					case GL_DOUBLE_MAT3x2:
+						return 48;
+					case GL_FLOAT_MAT4:
+					case GL_DOUBLE_MAT2x4:
+					case GL_DOUBLE_MAT4x2:
+						return 64;
+					case GL_DOUBLE_MAT3:
+						return 72;
+					case GL_DOUBLE_MAT3x4:
+					case GL_DOUBLE_MAT4x3:
+						return 96;
+					case GL_DOUBLE_MAT4:
+						return 128;
+					//	Scalars, samplers, and images are all set
+					//	as a single 32 bit value
+					default:
+						return 4;
+					
+				}
+				
+			}
+			
+			
+		}
+		
+		
+		uniform_shadow::uniform_shadow () noexcept : issued_(0), skipped_(0) {	}
+		
+		
+		void uniform_shadow::reset (GLuint p, const program_reflection & reflection) {
+			
+			slots_.clear();
+			data_.clear();
+			valid_.clear();
+			
+			std::vector<bool> seen;
+			reflection.for_each_uniform([&] (const resource_name & name, const program_resource & r) {
+				
+				//	Uniforms in blocks do not have locations and
+				//	are not set through the default block
+				if (r.location<0) return;
+				if (r.index>=seen.size()) seen.resize(r.index+1,false);
+				if (seen[r.index]) return;
+				seen[r.index]=true;
+				
+				auto size=type_size(r.type);
+				auto n=std::size_t(std::max(r.array_size,1));
+				//	The elements of an array are not guaranteed to
+				//	have consecutive locations, so the location of
+				//	each element is queried
+				std::vector<GLint> locations(n,-1);
+				locations[0]=r.location;
+				if (n>1) {
+					
+					std::string base(name.str,name.len);
+					if ((base.size()>3) && (base.compare(base.size()-3,3,"[0]")==0)) base.resize(base.size()-3);
+					for (std::size_t i=1;i<n;++i) locations[i]=glGetUniformLocation(p,(base+'['+std::to_string(i)+']').c_str());
+					raise();
+					
+				}
+				
+				auto offset=data_.size();
+				auto element=valid_.size();
+				data_.resize(offset+(n*size));
+				valid_.resize(element+n,0);
+				for (std::size_t i=0;i<n;++i) {
+					
+					auto location=locations[i];
+					if (location<0) continue;
+					
+					if (std::size_t(location)>=slots_.size()) slots_.resize(std::size_t(location)+1,slot{0,0,0,0});
+					slots_[location]=slot{
+						std::uint32_t(offset+(i*size)),
+						std::uint32_t(element+i),
+						std::uint32_t(size),
+						std::uint32_t(n-i)
+					};
+					
+				}
+				
+			});
+			
+		}
+		
+		
+		void uniform_shadow::invalidate () noexcept {
+			
+			std::fill(valid_.begin(),valid_.end(),0);
+			
+		}
+		
+		
+		bool uniform_shadow::update (GLint location, const void * data, std::size_t bytes) noexcept {
+			
+			//	OpenGL silently ignores uploads to -1
+			if (location<0) {
+				
+				++skipped_;
+				return false;
+				
+			}
+			
+			if ((std::size_t(location)>=slots_.size()) || (slots_[location].size==0)) {
+				
+				++issued_;
+				return true;
+				
+			}
+			
+			//	Uploads past the end of an array are ignored by
+			//	OpenGL and therefore by the shadow
+			auto & s=slots_[location];
+			auto n=std::min<std::size_t>((bytes+s.size-1)/s.size,s.remaining);
+			auto len=std::min(bytes,n*s.size);
+			auto dst=data_.data()+s.offset;
+			auto valid=valid_.data()+s.element;
+			if (
+				std::all_of(valid,valid+n,[] (unsigned char v) noexcept {	return v!=0;	}) &&
+				(std::memcmp(dst,data,len)==0)
+			) {
+				
+				++skipped_;
+				return false;
+				
+			}
+			
+			std::memcpy(dst,data,len);
+			std::fill(valid,valid+n,1);
+			++issued_;
+			
+			return true;
+			
+		}
+		
+		
+		std::size_t uniform_shadow::issued () const noexcept {
+			
+			return issued_;
+			
+		}
+		
+		
+		std::size_t uniform_shadow::skipped () const noexcept {
+			
+			return skipped_;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,163 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/program_batch.hpp>
+#include <gl_utilities/variant_cache.hpp>
+#include <algorithm>
+#include <unordered_map>
+#include <sstream>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		std::vector<shader_source> variant_cache::sources (const shader_variant & v, const std::vector<std::string> & defines) {
+			
+			std::vector<shader_source> retr;
+			retr.reserve(v.stages.size());
+			for (auto & s : v.stages) retr.push_back(shader_source{s.type,inject_defines(pre_.load(s.filename),defines)});
+			
+			return retr;
+			
+		}
+		
+		
+		variant_cache::variant_cache (shader_preprocessor & pre, program_cache * binaries) noexcept
+			:	pre_(pre),
+				binaries_(binaries),
+				builds_(0)
+		{	}
+		
+		
+		variant_key variant_cache::key (const shader_variant & v) {
+			
+			//	The same file reached through different paths
+			//	must give the same key
+			auto stages=v.stages;
+			for (auto & s : stages) s.filename=canonical_path(s.filename);
+			std::sort(stages.begin(),stages.end(),[] (const shader_file & a, const shader_file & b) {
+				
+				if (a.type!=b.type) return a.type<b.type;
+				
+				return a.filename<b.filename;
+				
+			});
+			
+			std::ostringstream ss;
+			for (auto & s : stages) ss << s.type << ' ' << s.filename << '\n';
+			for (auto & d : canonical_defines(v.defines)) ss << "#define " << d << '\n';
+			
+			variant_key retr;
+			retr.text=ss.str();
+			retr.hash=fnv1a(retr.text);
+			
+			return retr;
+			
+		}
+		
+		
+		const program & variant_cache::get (const shader_variant & v) {
+			
+			return get(key(v),v);
+			
+		}
+		
+		
+		const program & variant_cache::get (const variant_key & k, const shader_variant & v) {
+			
+			auto iter=programs_.find(k);
+			if (iter!=programs_.end()) return iter->second;
+			
+			//	The program cache injects the definitions itself
+			//	and hashes them into its own key
+			auto defines=canonical_defines(v.defines);
+			optional<program> p;
+			if (binaries_==nullptr) {
+				
+				p.emplace();
+				std::vector<shader> shaders;
+				for (auto & s : sources(v,defines)) {
+					
+					shaders.emplace_back(s.type,s.source);
+					p->attach(shaders.back());
+					
+				}
+				p->link();
+				
+			} else {
+				
+				std::vector<shader_source> srcs;
+				for (auto & s : v.stages) srcs.push_back(shader_source{s.type,pre_.load(s.filename)});
+				p.emplace(binaries_->get(srcs,defines));
+				
+			}
+			++builds_;
+			
+			return programs_.emplace(k,std::move(*p)).first->second;
+			
+		}
+		
+		
+		void variant_cache::prewarm (const std::vector<shader_variant> & variants) {
+			
+			if (binaries_!=nullptr) {
+				
+				for (auto & v : variants) get(v);
+				
+				return;
+				
+			}
+			
+			//	Every compile and link is issued before any result
+			//	is waited on
+			program_batch batch;
+			std::unordered_map<variant_key,std::size_t,hasher> pending;
+			for (auto & v : variants) {
+				
+				auto k=key(v);
+				if ((programs_.count(k)!=0) || (pending.count(k)!=0)) continue;
+				
+				auto i=batch.add(sources(v,canonical_defines(v.defines)));
+				pending.emplace(std::move(k),i);
+				
+			}
+			
+			for (auto & p : pending) {
+				
+				programs_.emplace(p.first,batch.take(p.second));
+				++builds_;
+				
+			}
+			
+		}
+		
+		
+		std::size_t variant_cache::size () const noexcept {
+			
+			return programs_.size();
+			
+		}
+		
+		
+		std::size_t variant_cache::builds () const noexcept {
+			
+			return builds_;
+			
+		}
+		
+		
+		void variant_cache::clear () noexcept {
+			
+			programs_.clear();
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -114,6 +114,71 @@ namespace gl_utilities {
 		}
 		
 		
+		void vertex_array::attribute_format (GLuint location, GLint count, GLenum type, GLboolean normalized, GLuint relative_offset) {
+			
+			auto g=bind();
+			glVertexAttribFormat(location,count,type,normalized,relative_offset);
+			raise();
+			
+		}
+		
+		
+		void vertex_array::attribute_integer_format (GLuint location, GLint count, GLenum type, GLuint relative_offset) {
+			
+			auto g=bind();
+			glVertexAttribIFormat(location,count,type,relative_offset);
+			raise();
+			
+		}
+		
+		
+		void vertex_array::attribute_binding (GLuint location, GLuint binding) {
+			
+			auto g=bind();
+			glVertexAttribBinding(location,binding);
+			raise();
+			
+		}
+		
+		
+		void vertex_array::enable_attribute (GLuint location) {
+			
+			auto g=bind();
+			glEnableVertexAttribArray(location);
+			raise();
+			
+		}
+		
+		
+		void vertex_array::vertex_buffer (GLuint binding, const buffer & b, GLintptr offset, GLsizei stride) {
+			
+			auto g=bind();
+			glBindVertexBuffer(binding,b,offset,stride);
+			raise();
+			
+		}
+		
+		
+		void vertex_array::binding_divisor (GLuint binding, GLuint divisor) {
+			
+			auto g=bind();
+			glVertexBindingDivisor(binding,divisor);
+			raise();
+			
+		}
+		
+		
+		void vertex_array::element_buffer (const buffer & b) {
+			
+			auto g=bind();
+			//	The element array binding is part of the state of
+			//	the vertex array so it must not be restored
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,b);
+			raise();
+			
+		}
+		
+		
 	}
 	
 	
@@ -0,0 +1,191 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/hash.hpp>
+#include <gl_utilities/vertex_format.hpp>
+#include <cstdint>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		bool vertex_array_cache::key::operator == (const key & other) const noexcept {
+			
+			return (attributes==other.attributes) &&
+				(vertices==other.vertices) &&
+				(base==other.base) &&
+				(elements==other.elements);
+			
+		}
+		
+		
+		std::size_t vertex_array_cache::hasher::operator () (const key & k) const noexcept {
+			
+			auto retr=fnv1a_integer(reinterpret_cast<std::uintptr_t>(k.attributes));
+			retr=fnv1a_integer(k.vertices,retr);
+			retr=fnv1a_integer(k.base,retr);
+			retr=fnv1a_integer(k.elements,retr);
+			
+			return std::size_t(retr);
+			
+		}
+		
+		
+		vertex_array_cache::entry & vertex_array_cache::get_entry (const vertex_layout & layout, const buffer & vertices, GLintptr base, GLuint elements) {
+			
+			//	Shared vertex arrays are keyed only by format,
+			//	their buffer bindings are changed as necessary
+			key k{layout.attributes,0,0,0};
+			if (!shared_) {
+				
+				k.vertices=vertices;
+				k.base=base;
+				k.elements=elements;
+				
+			}
+			
+			auto iter=map_.find(k);
+			if (iter!=map_.end()) return iter->second;
+			
+			entry e{vertex_array{},0,0,0};
+			{
+				
+				auto g=e.vao.bind();
+				if (shared_) {
+					
+					for (std::size_t i=0;i<layout.count;++i) set_vertex_attribute_format(layout.attributes[i],0);
+					
+				} else {
+					
+					auto bg=vertices.bind(GL_ARRAY_BUFFER);
+					for (std::size_t i=0;i<layout.count;++i) set_vertex_attribute(layout.attributes[i],layout.stride,std::size_t(base));
+					//	The element array binding is part of the state
+					//	of the vertex array so it must not be restored
+					glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,elements);
+					raise();
+					e.vertices=vertices;
+					e.base=base;
+					e.elements=elements;
+					
+				}
+				
+			}
+			
+			return map_.emplace(k,std::move(e)).first->second;
+			
+		}
+		
+		
+		bool vertex_array_cache::stale (const entry & e, const buffer & vertices, GLintptr base, GLuint elements) const noexcept {
+			
+			return (e.vertices!=GLuint(vertices)) || (e.base!=base) || (e.elements!=elements);
+			
+		}
+		
+		
+		void vertex_array_cache::rebind (entry & e, const vertex_layout & layout, const buffer & vertices, GLintptr base, GLuint elements) {
+			
+			if ((e.vertices!=GLuint(vertices)) || (e.base!=base)) {
+				
+				glBindVertexBuffer(0,vertices,base,layout.stride);
+				raise();
+				e.vertices=vertices;
+				e.base=base;
+				
+			}
+			
+			if (e.elements!=elements) {
+				
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,elements);
+				raise();
+				e.elements=elements;
+				
+			}
+			
+			++rebinds_;
+			
+		}
+		
+		
+		vertex_array_cache::vertex_array_cache () : shared_(GLEW_ARB_vertex_attrib_binding), rebinds_(0) {	}
+		
+		
+		const vertex_array & vertex_array_cache::get (const vertex_layout & layout, const buffer & vertices, GLintptr base, const buffer * elements) {
+			
+			GLuint el=(elements==nullptr) ? 0 : GLuint(*elements);
+			auto & e=get_entry(layout,vertices,base,el);
+			if (stale(e,vertices,base,el)) {
+				
+				auto g=e.vao.bind();
+				rebind(e,layout,vertices,base,el);
+				
+			}
+			
+			return e.vao;
+			
+		}
+		
+		
+		vertex_array::guard vertex_array_cache::bind (const vertex_layout & layout, const buffer & vertices, GLintptr base, const buffer * elements) {
+			
+			GLuint el=(elements==nullptr) ? 0 : GLuint(*elements);
+			auto & e=get_entry(layout,vertices,base,el);
+			auto retr=e.vao.bind();
+			if (stale(e,vertices,base,el)) rebind(e,layout,vertices,base,el);
+			
+			return retr;
+			
+		}
+		
+		
+		void vertex_array_cache::forget (const buffer & b) noexcept {
+			
+			GLuint handle=b;
+			if (handle==0) return;
+			
+			for (auto iter=map_.begin();iter!=map_.end();) {
+				
+				if ((iter->second.vertices==handle) || (iter->second.elements==handle)) iter=map_.erase(iter);
+				else ++iter;
+				
+			}
+			
+		}
+		
+		
+		void vertex_array_cache::clear () noexcept {
+			
+			map_.clear();
+			
+		}
+		
+		
+		bool vertex_array_cache::shared () const noexcept {
+			
+			return shared_;
+			
+		}
+		
+		
+		std::size_t vertex_array_cache::size () const noexcept {
+			
+			return map_.size();
+			
+		}
+		
+		
+		std::size_t vertex_array_cache::rebinds () const noexcept {
+			
+			return rebinds_;
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,158 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/vertex_format.hpp>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			bool is_integer (GLenum type) noexcept {
+				
+				switch (type) {
+					
+					case GL_INT:
+					case GL_INT_VEC2:
+					case GL_INT_VEC3:
+					case GL_INT_VEC4:
+					case GL_UNSIGNED_INT:
+					case GL_UNSIGNED_INT_VEC2:
+					case GL_UNSIGNED_INT_VEC3:
+					case GL_UNSIGNED_INT_VEC4:
+						return true;
+					default:
+						return false;
+					
+				}
+				
+			}
+			
+			
+			//	Matrices occupy one location per column
+			GLint locations (GLenum type) noexcept {
+				
+				switch (type) {
+					
+					case GL_FLOAT_MAT2:
+					case GL_FLOAT_MAT2x3:
+					case GL_FLOAT_MAT2x4:
+					case GL_DOUBLE_MAT2:
+					case GL_DOUBLE_MAT2x3:
+					case GL_DOUBLE_MAT2x4:
+						return 2;
+					case GL_FLOAT_MAT3:
+					case GL_FLOAT_MAT3x2:
+					case GL_FLOAT_MAT3x4:
+					case GL_DOUBLE_MAT3:
+					case GL_DOUBLE_MAT3x2:
+					case GL_DOUBLE_MAT3x4:
+						return 3;
+					case GL_FLOAT_MAT4:
+					case GL_FLOAT_MAT4x2:
+					case GL_FLOAT_MAT4x3:
+					case GL_DOUBLE_MAT4:
+					case GL_DOUBLE_MAT4x2:
+					case GL_DOUBLE_MAT4x3:
+						return 4;
+					default:
+						return 1;
+					
+				}
+				
+			}
+			
+			
+			bool is_array_alias (const resource_name & name) noexcept {
+				
+				const char suffix []="[0]";
+				auto len=sizeof(suffix)-1;
+				
+				return (name.len>len) && (std::memcmp(name.str+(name.len-len),suffix,len)==0);
+				
+			}
+			
+			
+		}
+		
+		
+		void set_vertex_attribute (const vertex_attribute_description & d, GLsizei stride, std::size_t base) {
+			
+			auto ptr=reinterpret_cast<const void *>(base+d.offset);
+			if (d.convert==conversion::integer) glVertexAttribIPointer(d.location,d.count,d.type,stride,ptr);
+			else glVertexAttribPointer(d.location,d.count,d.type,(d.convert==conversion::normalized) ? GL_TRUE : GL_FALSE,stride,ptr);
+			raise();
+			glEnableVertexAttribArray(d.location);
+			raise();
+			
+		}
+		
+		
+		void set_vertex_attribute_format (const vertex_attribute_description & d, GLuint binding) {
+			
+			if (d.convert==conversion::integer) glVertexAttribIFormat(d.location,d.count,d.type,GLuint(d.offset));
+			else glVertexAttribFormat(d.location,d.count,d.type,(d.convert==conversion::normalized) ? GL_TRUE : GL_FALSE,GLuint(d.offset));
+			raise();
+			glVertexAttribBinding(d.location,binding);
+			raise();
+			glEnableVertexAttribArray(d.location);
+			raise();
+			
+		}
+		
+		
+		void validate_vertex_attributes (const program & p, const vertex_attribute_description * begin, std::size_t count) {
+			
+			auto end=begin+count;
+			std::ostringstream ss;
+			p.reflection().for_each_attribute([&] (const resource_name & name, const program_resource & r) {
+				
+				//	Built in inputs such as gl_VertexID have no
+				//	location
+				if ((r.location<0) || is_array_alias(name)) return;
+				
+				auto n=locations(r.type)*std::max<GLint>(r.array_size,1);
+				for (GLint i=0;i<n;++i) {
+					
+					auto location=GLuint(r.location+i);
+					auto iter=std::find_if(begin,end,[&] (const vertex_attribute_description & d) noexcept {	return d.location==location;	});
+					if (iter==end) {
+						
+						ss << "\n\tAttribute \"";
+						ss.write(name.str,name.len);
+						ss << "\" at location " << location << " is not provided";
+						continue;
+						
+					}
+					
+					if (is_integer(r.type)!=(iter->convert==conversion::integer)) {
+						
+						ss << "\n\tAttribute \"";
+						ss.write(name.str,name.len);
+						ss << "\" at location " << location << (is_integer(r.type) ? " is an integer but is provided as floating point" : " is floating point but is provided as an integer");
+						
+					}
+					
+				}
+				
+			});
+			
+			auto msg=ss.str();
+			if (!msg.empty()) throw vertex_format_error("Vertex format does not match program:"+msg);
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,272 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/vertex_pulling.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			class component {
+				
+				
+				public:
+				
+				
+					//	Within the vertex
+					std::size_t word;
+					unsigned shift;
+					unsigned bits;
+					bool is_signed;
+					bool is_float;
+				
+				
+			};
+			
+			
+			component get_component (const vertex_attribute_description & d, GLint i) {
+				
+				component retr{0,0,0,false,false};
+				std::size_t size=0;
+				switch (d.type) {
+					
+					case GL_BYTE:
+						retr.is_signed=true;
+						//	Fall through
+					case GL_UNSIGNED_BYTE:
+						size=1;
+						break;
+					case GL_SHORT:
+						retr.is_signed=true;
+						//	Fall through
+					case GL_UNSIGNED_SHORT:
+						size=2;
+						break;
+					case GL_HALF_FLOAT:
+						retr.is_float=true;
+						size=2;
+						break;
+					case GL_INT:
+						retr.is_signed=true;
+						//	Fall through
+					case GL_UNSIGNED_INT:
+						size=4;
+						break;
+					case GL_FLOAT:
+						retr.is_float=true;
+						size=4;
+						break;
+					case GL_INT_2_10_10_10_REV:
+						retr.is_signed=true;
+						//	Fall through
+					case GL_UNSIGNED_INT_2_10_10_10_REV:
+						if ((d.offset%4)!=0) throw vertex_format_error("Packed attributes must be aligned to four bytes");
+						retr.word=d.offset/4;
+						retr.shift=unsigned(i)*10U;
+						retr.bits=(i==3) ? 2U : 10U;
+						return retr;
+					default:
+						throw vertex_format_error("Vertex pulling does not support this component type");
+					
+				}
+				
+				auto pos=d.offset+(std::size_t(i)*size);
+				if (((pos%4)+size)>4) throw vertex_format_error("Components may not straddle four byte words");
+				retr.word=pos/4;
+				retr.shift=unsigned(pos%4)*8U;
+				retr.bits=unsigned(size)*8U;
+				
+				return retr;
+				
+			}
+			
+			
+			//	Integers are presented as int or uint, everything
+			//	else as float
+			bool is_int (const vertex_attribute_description & d, const component & c) noexcept {
+				
+				return d.convert==conversion::integer && c.is_signed;
+				
+			}
+			
+			
+			bool is_uint (const vertex_attribute_description & d, const component & c) noexcept {
+				
+				return d.convert==conversion::integer && !c.is_signed;
+				
+			}
+			
+			
+			std::string type_name (const vertex_attribute_description & d, const component & c) {
+				
+				if (d.count==1) return is_int(d,c) ? "int" : (is_uint(d,c) ? "uint" : "float");
+				
+				std::string retr=is_int(d,c) ? "ivec" : (is_uint(d,c) ? "uvec" : "vec");
+				retr+=char('0'+d.count);
+				
+				return retr;
+				
+			}
+			
+			
+			std::string expression (const vertex_attribute_description & d, const component & c, const std::string & prefix) {
+				
+				std::ostringstream word;
+				word << prefix << "_word(base+" << c.word << "u)";
+				
+				std::ostringstream retr;
+				if (c.is_float) {
+					
+					if (c.bits==32) retr << "uintBitsToFloat(" << word.str() << ")";
+					else retr << "unpackHalf2x16(" << word.str() << ">>" << c.shift << "u).x";
+					
+					return retr.str();
+					
+				}
+				
+				//	Extract the field, sign extending it by shifting it
+				//	to the top of a signed integer and back down
+				std::ostringstream value;
+				if (c.bits==32) value << (c.is_signed ? "(int(" : "((") << word.str() << "))";
+				else if (c.is_signed) value << "(int(" << word.str() << "<<" << (32U-c.shift-c.bits) << "u)>>" << (32U-c.bits) << ")";
+				else value << "((" << word.str() << ">>" << c.shift << "u)&" << ((1ULL<<c.bits)-1ULL) << "u)";
+				
+				if (d.convert==conversion::integer) return value.str();
+				if (d.convert==conversion::floating) return "float"+value.str();
+				
+				//	Signed values are mapped as in OpenGL 4.2, where
+				//	both of the smallest values become -1
+				if (c.is_signed) {
+					
+					retr << "max(float" << value.str() << "/" << ((1ULL<<(c.bits-1U))-1ULL) << ".0,-1.0)";
+					
+				} else {
+					
+					retr << "(float" << value.str() << "/" << ((1ULL<<c.bits)-1ULL) << ".0)";
+					
+				}
+				
+				return retr.str();
+				
+			}
+			
+			
+		}
+		
+		
+		std::string vertex_pulling_source (const vertex_layout & layout, const std::string & prefix, GLuint binding, vertex_pulling_storage storage) {
+			
+			if ((layout.stride%4)!=0) throw vertex_format_error("Pulled vertices must have a stride which is a multiple of four");
+			
+			std::ostringstream ss;
+			if (storage==vertex_pulling_storage::shader_storage) {
+				
+				ss << "layout(std430,binding=" << binding << ") readonly buffer " << prefix << "_buffer {\n"
+					<< "\tuint " << prefix << "_words[];\n"
+					<< "};\n"
+					<< "uint " << prefix << "_word (uint i) {\n"
+					<< "\treturn " << prefix << "_words[i];\n"
+					<< "}\n";
+				
+			} else {
+				
+				ss << "uniform usamplerBuffer " << prefix << "_texture;\n"
+					<< "uint " << prefix << "_word (uint i) {\n"
+					<< "\treturn texelFetch(" << prefix << "_texture,int(i)).x;\n"
+					<< "}\n";
+				
+			}
+			
+			for (std::size_t i=0;i<layout.count;++i) {
+				
+				auto & d=layout.attributes[i];
+				if (d.type==GL_DOUBLE) throw vertex_format_error("Vertex pulling does not support double attributes");
+				
+				auto first=get_component(d,0);
+				auto type=type_name(d,first);
+				ss << type << " " << prefix << "_attribute" << d.location << " (uint vertex) {\n"
+					<< "\tuint base=vertex*" << (layout.stride/4) << "u;\n"
+					<< "\treturn " << type << "(";
+				for (GLint j=0;j<d.count;++j) {
+					
+					if (j!=0) ss << ",";
+					ss << expression(d,get_component(d,j),prefix);
+					
+				}
+				ss << ");\n"
+					<< "}\n";
+				
+			}
+			
+			return ss.str();
+			
+		}
+		
+		
+		vertex_pulling::guard::guard (vertex_array::guard vao, binding_table::guard table) noexcept : vao_(std::move(vao)), table_(std::move(table)) {	}
+		
+		
+		vertex_pulling & vertex_pulling::add_storage (GLuint binding, const buffer & b, GLintptr offset, GLsizeiptr size) {
+			
+			if (size==0) {
+				
+				if (offset!=0) throw std::logic_error("Binding a buffer from an offset requires a size");
+				table_.add_buffer_base(GL_SHADER_STORAGE_BUFFER,binding,b);
+				
+			} else {
+				
+				table_.add_buffer_range(GL_SHADER_STORAGE_BUFFER,binding,b,offset,size);
+				
+			}
+			
+			return *this;
+			
+		}
+		
+		
+		vertex_pulling & vertex_pulling::add_texture (GLuint unit, const texture & tex, const buffer & b) {
+			
+			{
+				
+				auto g=tex.bind(GL_TEXTURE_BUFFER);
+				glTexBuffer(GL_TEXTURE_BUFFER,GL_R32UI,b);
+				raise();
+				
+			}
+			
+			table_.add_texture(unit,GL_TEXTURE_BUFFER,tex);
+			
+			return *this;
+			
+		}
+		
+		
+		const vertex_array & vertex_pulling::vao () const noexcept {
+			
+			return vao_;
+			
+		}
+		
+		
+		vertex_pulling::guard vertex_pulling::bind () const {
+			
+			auto g=vao_.bind();
+			
+			return guard(std::move(g),table_.bind());
+			
+		}
+		
+		
+	}
+	
+	
+}
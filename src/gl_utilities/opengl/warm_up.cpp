@@ -0,0 +1,205 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include <gl_utilities/warm_up.hpp>
+#include <stdexcept>
+#include <utility>
+
+
+namespace gl_utilities {
+	
+	
+	namespace opengl {
+		
+		
+		namespace {
+			
+			
+			GLsizei vertices (GLenum mode) {
+				
+				switch (mode) {
+					
+					case GL_POINTS:
+						return 1;
+					case GL_LINES:
+					case GL_LINE_STRIP:
+					case GL_LINE_LOOP:
+						return 2;
+					case GL_LINES_ADJACENCY:
+					case GL_LINE_STRIP_ADJACENCY:
+						return 4;
+					case GL_TRIANGLES_ADJACENCY:
+					case GL_TRIANGLE_STRIP_ADJACENCY:
+						return 6;
+					case GL_PATCHES:{
+						
+						GLint retr;
+						glGetIntegerv(GL_PATCH_VERTICES,&retr);
+						raise();
+						
+						return retr;
+						
+					}
+					default:
+						return 3;
+					
+				}
+				
+			}
+			
+			
+			GLenum attachment (GLenum internal_format) noexcept {
+				
+				switch (internal_format) {
+					
+					case GL_DEPTH24_STENCIL8:
+					case GL_DEPTH32F_STENCIL8:
+					case GL_DEPTH_STENCIL:
+						return GL_DEPTH_STENCIL_ATTACHMENT;
+					case GL_STENCIL_INDEX1:
+					case GL_STENCIL_INDEX4:
+					case GL_STENCIL_INDEX8:
+					case GL_STENCIL_INDEX16:
+						return GL_STENCIL_ATTACHMENT;
+					default:
+						return GL_DEPTH_ATTACHMENT;
+					
+				}
+				
+			}
+			
+			
+			render_buffer attach (GLenum internal_format, GLenum attachment) {
+				
+				render_buffer retr;
+				auto g=retr.bind();
+				glRenderbufferStorage(GL_RENDERBUFFER,internal_format,1,1);
+				raise();
+				glFramebufferRenderbuffer(GL_FRAMEBUFFER,attachment,GL_RENDERBUFFER,retr);
+				raise();
+				
+				return retr;
+				
+			}
+			
+			
+		}
+		
+		
+		warm_up::target & warm_up::get_target (GLenum color, GLenum depth_stencil) {
+			
+			auto key=std::make_pair(color,depth_stencil);
+			auto iter=targets_.find(key);
+			if (iter!=targets_.end()) return iter->second;
+			
+			target t;
+			{
+				
+				auto g=t.fb.bind(GL_FRAMEBUFFER);
+				if (color==GL_NONE) {
+					
+					glDrawBuffer(GL_NONE);
+					raise();
+					glReadBuffer(GL_NONE);
+					raise();
+					
+				} else {
+					
+					t.color.emplace(attach(color,GL_COLOR_ATTACHMENT0));
+					
+				}
+				if (depth_stencil!=GL_NONE) t.depth_stencil.emplace(attach(depth_stencil,attachment(depth_stencil)));
+				
+				auto status=glCheckFramebufferStatus(GL_FRAMEBUFFER);
+				raise();
+				if (status!=GL_FRAMEBUFFER_COMPLETE) throw error("Warm up frame buffer is incomplete");
+				
+			}
+			
+			return targets_.emplace(key,std::move(t)).first->second;
+			
+		}
+		
+		
+		void warm_up::draw (const warm_up_state & s) {
+			
+			auto & t=get_target(s.color_format,s.depth_stencil_format);
+			if (!vao_) vao_.emplace();
+			
+			auto fg=t.fb.bind(GL_DRAW_FRAMEBUFFER);
+			auto vg=viewport(0,0,1,1);
+			//	No attributes are enabled, so the vertex shader
+			//	sees the current generic attribute values
+			auto ag=vao_->bind();
+			auto pg=polygon_mode(s.polygon_mode);
+			std::vector<enable_guard> enabled;
+			enabled.reserve(s.capabilities.size());
+			for (auto cap : s.capabilities) enabled.push_back(enable(cap));
+			
+			optional<program::guard> program_guard;
+			optional<program_pipeline::guard> pipeline_guard;
+			if (s.p==nullptr) pipeline_guard.emplace(s.pipeline->use());
+			else program_guard.emplace(s.p->use());
+			
+			glDrawArrays(s.mode,0,vertices(s.mode));
+			raise();
+			
+		}
+		
+		
+		warm_up::warm_up (progress_type progress) : done_(0), progress_(std::move(progress)) {	}
+		
+		
+		void warm_up::add (warm_up_state state) {
+			
+			if ((state.p==nullptr)==(state.pipeline==nullptr)) throw std::logic_error("Warm up states must have exactly one of a program and a pipeline");
+			
+			states_.push_back(std::move(state));
+			
+		}
+		
+		
+		bool warm_up::run (std::chrono::steady_clock::duration budget) {
+			
+			//	Drivers compile when the draw is issued rather than
+			//	when it executes, so the time spent issuing draws is
+			//	the time spent compiling
+			auto start=std::chrono::steady_clock::now();
+			while (done_<states_.size()) {
+				
+				draw(states_[done_]);
+				++done_;
+				if (progress_) progress_(done_,states_.size());
+				
+				if ((std::chrono::steady_clock::now()-start)>=budget) break;
+				
+			}
+			
+			if (done_<states_.size()) return false;
+			
+			targets_.clear();
+			vao_=nullopt;
+			
+			return true;
+			
+		}
+		
+		
+		std::size_t warm_up::done () const noexcept {
+			
+			return done_;
+			
+		}
+		
+		
+		std::size_t warm_up::total () const noexcept {
+			
+			return states_.size();
+			
+		}
+		
+		
+	}
+	
+	
+}
@@ -0,0 +1,577 @@
+#include <gl_utilities/pixel.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GL_UTILITIES_PIXEL_X86
+#include <immintrin.h>
+#endif
+
+
+namespace gl_utilities {
+	
+	
+	namespace pixel {
+		
+		
+		namespace {
+			
+			
+			class tables {
+				
+				
+				public:
+				
+				
+					float decode [256];
+					//	The smallest float which encodes as i+1 is
+					//	thresholds[i], this allows encoding to be
+					//	performed as a binary search which yields
+					//	correctly rounded results without calling
+					//	std::pow
+					float thresholds [255];
+					//	1.055*pow(2,e*5/12) for the octaves e=-9
+					//	to 0 (at index e+9) which the power
+					//	segment of the encoding spans, padded
+					//	to 16 entries so that two permutes
+					//	look it up
+					float octaves [16];
+					
+					
+					tables () noexcept {
+						
+						for (unsigned i=0;i<256;++i) decode[i]=float(to_linear(double(i)/255.0));
+						
+						for (unsigned i=0;i<255;++i) {
+							
+							auto t=to_linear((double(i)+0.5)/255.0);
+							auto f=float(t);
+							//	Round up so that comparing a float against
+							//	the threshold is exact
+							if (double(f)<t) f=std::nextafter(f,std::numeric_limits<float>::infinity());
+							thresholds[i]=f;
+							
+						}
+						
+						for (int i=0;i<16;++i) octaves[i]=float(1.055*std::pow(2.0,double(std::min(i,9)-9)*5.0/12.0));
+						
+					}
+					
+					
+					static double to_linear (double s) noexcept {
+						
+						if (s<=0.04045) return s/12.92;
+						
+						return std::pow((s+0.055)/1.055,2.4);
+						
+					}
+				
+				
+			};
+			
+			
+			const tables & get_tables () noexcept {
+				
+				static const tables retr;
+				return retr;
+				
+			}
+			
+			
+		}
+		
+		
+		namespace reference {
+			
+			
+			void rgb_to_rgba (const std::uint8_t * src, std::uint8_t * dst, std::size_t count, std::uint8_t alpha) noexcept {
+				
+				for (std::size_t i=0;i<count;++i,src+=3,dst+=4) {
+					
+					dst[0]=src[0];
+					dst[1]=src[1];
+					dst[2]=src[2];
+					dst[3]=alpha;
+					
+				}
+				
+			}
+			
+			
+			void swizzle_bgra (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+				
+				for (std::size_t i=0;i<count;++i,src+=4,dst+=4) {
+					
+					//	Read everything first so that this works
+					//	in place
+					auto b=src[0];
+					auto r=src[2];
+					dst[0]=r;
+					dst[1]=src[1];
+					dst[2]=b;
+					dst[3]=src[3];
+					
+				}
+				
+			}
+			
+			
+			std::uint16_t float_to_half (float f) noexcept {
+				
+				std::uint32_t u;
+				std::memcpy(&u,&f,sizeof(u));
+				std::uint32_t sign=(u>>16)&0x8000U;
+				u&=0x7FFFFFFFU;
+				
+				std::uint32_t h;
+				//	Too large to represent (i.e. rounds to infinity)
+				//	or infinity/NaN
+				if (u>=0x47800000U) {
+					
+					//	NaNs keep as much of their payload as fits
+					//	and are quieted, which is what F16C does
+					if (u>0x7F800000U) h=0x7E00U|((u>>13)&0x3FFU);
+					else h=0x7C00U;
+				
+				//	The result is subnormal (or zero), adding 0.5 aligns
+				//	the mantissa such that the FPU performs the rounding
+				} else if (u<0x38800000U) {
+					
+					float v;
+					std::memcpy(&v,&u,sizeof(v));
+					v+=0.5f;
+					std::memcpy(&u,&v,sizeof(u));
+					h=u-0x3F000000U;
+					
+				} else {
+					
+					auto odd=(u>>13)&1U;
+					//	Rebias the exponent and round to nearest even
+					u+=0xC8000FFFU;
+					u+=odd;
+					h=u>>13;
+					
+				}
+				
+				return std::uint16_t(h|sign);
+				
+			}
+			
+			
+			void float_to_half (const float * src, std::uint16_t * dst, std::size_t count) noexcept {
+				
+				for (std::size_t i=0;i<count;++i) dst[i]=float_to_half(src[i]);
+				
+			}
+			
+			
+			void unorm16_to_unorm8 (const std::uint16_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+				
+				//	This is round(v*255/65535) without a division
+				for (std::size_t i=0;i<count;++i) dst[i]=std::uint8_t((std::uint32_t(src[i])*255U+32895U)>>16);
+				
+			}
+			
+			
+			void premultiply (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+				
+				for (std::size_t i=0;i<count;++i,src+=4,dst+=4) {
+					
+					unsigned a=src[3];
+					for (std::size_t j=0;j<3;++j) {
+						
+						//	This is round(c*a/255) without a division
+						unsigned t=unsigned(src[j])*a+128U;
+						dst[j]=std::uint8_t((t+(t>>8))>>8);
+						
+					}
+					dst[3]=std::uint8_t(a);
+					
+				}
+				
+			}
+			
+			
+			std::uint8_t srgb_encode (float f) noexcept {
+				
+				auto t=get_tables().thresholds;
+				unsigned pos=0;
+				//	NaN compares false and therefore yields zero
+				for (unsigned step=128;step!=0;step>>=1) if (f>=t[pos+step-1]) pos+=step;
+				
+				return std::uint8_t(pos);
+				
+			}
+			
+			
+			void srgb_encode (const float * src, std::uint8_t * dst, std::size_t count) noexcept {
+				
+				for (std::size_t i=0;i<count;++i) dst[i]=srgb_encode(src[i]);
+				
+			}
+			
+			
+			float srgb_decode (std::uint8_t c) noexcept {
+				
+				return get_tables().decode[c];
+				
+			}
+			
+			
+			void srgb_decode (const std::uint8_t * src, float * dst, std::size_t count) noexcept {
+				
+				auto t=get_tables().decode;
+				for (std::size_t i=0;i<count;++i) dst[i]=t[src[i]];
+				
+			}
+			
+			
+		}
+		
+		
+		#ifdef GL_UTILITIES_PIXEL_X86
+		namespace {
+			
+			
+			__attribute__((target("sse2")))
+			void unorm16_to_unorm8_sse2 (const std::uint16_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+				
+				auto mul=_mm_set1_epi16(255);
+				auto bias=_mm_set1_epi32(32895);
+				std::size_t i=0;
+				for (;(count-i)>=8;i+=8) {
+					
+					auto v=_mm_loadu_si128(reinterpret_cast<const __m128i *>(src+i));
+					auto lo=_mm_mullo_epi16(v,mul);
+					auto hi=_mm_mulhi_epu16(v,mul);
+					auto a=_mm_srli_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo,hi),bias),16);
+					auto b=_mm_srli_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo,hi),bias),16);
+					auto r=_mm_packs_epi32(a,b);
+					_mm_storel_epi64(reinterpret_cast<__m128i *>(dst+i),_mm_packus_epi16(r,r));
+					
+				}
+				
+				reference::unorm16_to_unorm8(src+i,dst+i,count-i);
+				
+			}
+			
+			
+			__attribute__((target("sse2")))
+			inline __m128i premultiply_sse2 (__m128i c, __m128i alpha_mask) noexcept {
+				
+				auto a=_mm_shufflehi_epi16(_mm_shufflelo_epi16(c,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+				auto t=_mm_add_epi16(_mm_mullo_epi16(c,a),_mm_set1_epi16(128));
+				t=_mm_srli_epi16(_mm_add_epi16(t,_mm_srli_epi16(t,8)),8);
+				
+				return _mm_or_si128(_mm_andnot_si128(alpha_mask,t),_mm_and_si128(alpha_mask,c));
+				
+			}
+			
+			
+			__attribute__((target("sse2")))
+			void premultiply_sse2 (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+				
+				auto zero=_mm_setzero_si128();
+				auto alpha_mask=_mm_set_epi16(-1,0,0,0,-1,0,0,0);
+				std::size_t i=0;
+				for (;(count-i)>=4;i+=4) {
+					
+					auto v=_mm_loadu_si128(reinterpret_cast<const __m128i *>(src+i*4));
+					auto lo=premultiply_sse2(_mm_unpacklo_epi8(v,zero),alpha_mask);
+					auto hi=premultiply_sse2(_mm_unpackhi_epi8(v,zero),alpha_mask);
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+i*4),_mm_packus_epi16(lo,hi));
+					
+				}
+				
+				reference::premultiply(src+i*4,dst+i*4,count-i);
+				
+			}
+			
+			
+			__attribute__((target("ssse3")))
+			void rgb_to_rgba_ssse3 (const std::uint8_t * src, std::uint8_t * dst, std::size_t count, std::uint8_t alpha) noexcept {
+				
+				auto shuffle=_mm_setr_epi8(0,1,2,-1,3,4,5,-1,6,7,8,-1,9,10,11,-1);
+				auto a=_mm_set1_epi32(int(std::uint32_t(alpha)<<24));
+				std::size_t i=0;
+				//	Each iteration consumes 12 bytes but loads 16 so
+				//	stop while there are still at least 16 bytes left
+				for (;(count-i)>=6;i+=4) {
+					
+					auto v=_mm_loadu_si128(reinterpret_cast<const __m128i *>(src+i*3));
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+i*4),_mm_or_si128(_mm_shuffle_epi8(v,shuffle),a));
+					
+				}
+				
+				reference::rgb_to_rgba(src+i*3,dst+i*4,count-i,alpha);
+				
+			}
+			
+			
+			__attribute__((target("ssse3")))
+			void swizzle_bgra_ssse3 (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+				
+				auto shuffle=_mm_setr_epi8(2,1,0,3,6,5,4,7,10,9,8,11,14,13,12,15);
+				std::size_t i=0;
+				for (;(count-i)>=4;i+=4) {
+					
+					auto v=_mm_loadu_si128(reinterpret_cast<const __m128i *>(src+i*4));
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+i*4),_mm_shuffle_epi8(v,shuffle));
+					
+				}
+				
+				reference::swizzle_bgra(src+i*4,dst+i*4,count-i);
+				
+			}
+			
+			
+			__attribute__((target("avx,f16c")))
+			void float_to_half_f16c (const float * src, std::uint16_t * dst, std::size_t count) noexcept {
+				
+				std::size_t i=0;
+				for (;(count-i)>=8;i+=8) {
+					
+					auto v=_mm256_loadu_ps(src+i);
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+i),_mm256_cvtps_ph(v,_MM_FROUND_TO_NEAREST_INT));
+					
+				}
+				
+				reference::float_to_half(src+i,dst+i,count-i);
+				
+			}
+			
+			
+			//	Gathering thresholds for a binary search is slower
+			//	than the scalar search, so instead the encoding is
+			//	approximated and the approximation is only trusted
+			//	where it is not close to rounding either way.  The
+			//	error of the approximation is around 1e-4 of a step
+			//	so vectors containing a value within 1e-3 of a step
+			//	of a rounding boundary (including every value within
+			//	a float of a threshold) are handed to the reference
+			__attribute__((target("avx2,fma")))
+			void srgb_encode_avx2 (const float * src, std::uint8_t * dst, std::size_t count) noexcept {
+				
+				auto & t=get_tables();
+				auto octaves_lo=_mm256_loadu_ps(t.octaves);
+				auto octaves_hi=_mm256_loadu_ps(t.octaves+8);
+				auto zero=_mm256_setzero_ps();
+				auto one=_mm256_set1_ps(1.0f);
+				auto eps=_mm256_set1_ps(1e-3f);
+				std::size_t i=0;
+				for (;(count-i)>=8;i+=8) {
+					
+					//	max returns its second operand for NaN,
+					//	which must encode as zero
+					auto v=_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src+i),zero),one);
+					
+					//	v=m*2^e with m in [1,2), pow(v,1/2.4) is
+					//	then pow(m,5/12) (a polynomial in m-1.5)
+					//	times a per octave factor
+					auto bits=_mm256_castps_si256(v);
+					auto e=_mm256_sub_epi32(_mm256_srli_epi32(bits,23),_mm256_set1_epi32(127-9));
+					e=_mm256_max_epi32(e,_mm256_setzero_si256());
+					auto scale=_mm256_blendv_ps(
+						_mm256_permutevar8x32_ps(octaves_lo,e),
+						_mm256_permutevar8x32_ps(octaves_hi,e),
+						_mm256_castsi256_ps(_mm256_cmpgt_epi32(e,_mm256_set1_epi32(7)))
+					);
+					auto m=_mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits,_mm256_set1_epi32(0x7FFFFF)),_mm256_set1_epi32(0x3F800000)));
+					auto x=_mm256_sub_ps(m,_mm256_set1_ps(1.5f));
+					auto p=_mm256_set1_ps(-2.691525734e-3f);
+					p=_mm256_fmadd_ps(p,x,_mm256_set1_ps(5.235440120e-3f));
+					p=_mm256_fmadd_ps(p,x,_mm256_set1_ps(-9.645350204e-3f));
+					p=_mm256_fmadd_ps(p,x,_mm256_set1_ps(2.242407490e-2f));
+					p=_mm256_fmadd_ps(p,x,_mm256_set1_ps(-6.395487171e-2f));
+					p=_mm256_fmadd_ps(p,x,_mm256_set1_ps(3.289062385e-1f));
+					p=_mm256_fmadd_ps(p,x,_mm256_set1_ps(1.184053587e+0f));
+					auto power=_mm256_fmsub_ps(p,scale,_mm256_set1_ps(0.055f));
+					auto linear=_mm256_mul_ps(v,_mm256_set1_ps(12.92f));
+					auto srgb=_mm256_blendv_ps(power,linear,_mm256_cmp_ps(v,_mm256_set1_ps(0.04045f/12.92f),_CMP_LE_OQ));
+					
+					auto r=_mm256_fmadd_ps(srgb,_mm256_set1_ps(255.0f),_mm256_set1_ps(0.5f));
+					auto k=_mm256_cvttps_epi32(r);
+					auto frac=_mm256_sub_ps(r,_mm256_cvtepi32_ps(k));
+					auto near=_mm256_or_ps(
+						_mm256_cmp_ps(frac,eps,_CMP_LT_OQ),
+						_mm256_cmp_ps(frac,_mm256_sub_ps(one,eps),_CMP_GT_OQ)
+					);
+					if (_mm256_movemask_ps(near)!=0) {
+						
+						reference::srgb_encode(src+i,dst+i,8);
+						continue;
+						
+					}
+					
+					auto w=_mm_packus_epi32(_mm256_castsi256_si128(k),_mm256_extracti128_si256(k,1));
+					_mm_storel_epi64(reinterpret_cast<__m128i *>(dst+i),_mm_packus_epi16(w,w));
+					
+				}
+				
+				reference::srgb_encode(src+i,dst+i,count-i);
+				
+			}
+			
+			
+			__attribute__((target("avx2")))
+			void srgb_decode_avx2 (const std::uint8_t * src, float * dst, std::size_t count) noexcept {
+				
+				auto t=get_tables().decode;
+				std::size_t i=0;
+				for (;(count-i)>=8;i+=8) {
+					
+					auto idx=_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src+i)));
+					_mm256_storeu_ps(dst+i,_mm256_i32gather_ps(t,idx,4));
+					
+				}
+				
+				reference::srgb_decode(src+i,dst+i,count-i);
+				
+			}
+			
+			
+		}
+		#endif
+		
+		
+		namespace {
+			
+			
+			class kernels {
+				
+				
+				public:
+				
+				
+					const char * name;
+					void (*rgb_to_rgba) (const std::uint8_t *, std::uint8_t *, std::size_t, std::uint8_t) noexcept;
+					void (*swizzle_bgra) (const std::uint8_t *, std::uint8_t *, std::size_t) noexcept;
+					void (*float_to_half) (const float *, std::uint16_t *, std::size_t) noexcept;
+					void (*unorm16_to_unorm8) (const std::uint16_t *, std::uint8_t *, std::size_t) noexcept;
+					void (*premultiply) (const std::uint8_t *, std::uint8_t *, std::size_t) noexcept;
+					void (*srgb_encode) (const float *, std::uint8_t *, std::size_t) noexcept;
+					void (*srgb_decode) (const std::uint8_t *, float *, std::size_t) noexcept;
+					
+					
+					kernels () noexcept {
+						
+						name="scalar";
+						rgb_to_rgba=&reference::rgb_to_rgba;
+						swizzle_bgra=&reference::swizzle_bgra;
+						float_to_half=&reference::float_to_half;
+						unorm16_to_unorm8=&reference::unorm16_to_unorm8;
+						premultiply=&reference::premultiply;
+						srgb_encode=&reference::srgb_encode;
+						srgb_decode=&reference::srgb_decode;
+						
+						#ifdef GL_UTILITIES_PIXEL_X86
+						__builtin_cpu_init();
+						if (__builtin_cpu_supports("sse2")) {
+							
+							name="sse2";
+							unorm16_to_unorm8=&unorm16_to_unorm8_sse2;
+							premultiply=&premultiply_sse2;
+							
+						}
+						if (__builtin_cpu_supports("ssse3")) {
+							
+							name="ssse3";
+							rgb_to_rgba=&rgb_to_rgba_ssse3;
+							swizzle_bgra=&swizzle_bgra_ssse3;
+							
+						}
+						if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c")) {
+							
+							name="f16c";
+							float_to_half=&float_to_half_f16c;
+							
+						}
+						if (__builtin_cpu_supports("avx2")) {
+							
+							name="avx2";
+							srgb_decode=&srgb_decode_avx2;
+							
+						}
+						if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) srgb_encode=&srgb_encode_avx2;
+						#endif
+						
+					}
+				
+				
+			};
+			
+			
+			const kernels & get_kernels () noexcept {
+				
+				static const kernels retr;
+				return retr;
+				
+			}
+			
+			
+		}
+		
+		
+		void rgb_to_rgba (const std::uint8_t * src, std::uint8_t * dst, std::size_t count, std::uint8_t alpha) noexcept {
+			
+			get_kernels().rgb_to_rgba(src,dst,count,alpha);
+			
+		}
+		
+		
+		void swizzle_bgra (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+			
+			get_kernels().swizzle_bgra(src,dst,count);
+			
+		}
+		
+		
+		void float_to_half (const float * src, std::uint16_t * dst, std::size_t count) noexcept {
+			
+			get_kernels().float_to_half(src,dst,count);
+			
+		}
+		
+		
+		void unorm16_to_unorm8 (const std::uint16_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+			
+			get_kernels().unorm16_to_unorm8(src,dst,count);
+			
+		}
+		
+		
+		void premultiply (const std::uint8_t * src, std::uint8_t * dst, std::size_t count) noexcept {
+			
+			get_kernels().premultiply(src,dst,count);
+			
+		}
+		
+		
+		void srgb_encode (const float * src, std::uint8_t * dst, std::size_t count) noexcept {
+			
+			get_kernels().srgb_encode(src,dst,count);
+			
+		}
+		
+		
+		void srgb_decode (const std::uint8_t * src, float * dst, std::size_t count) noexcept {
+			
+			get_kernels().srgb_decode(src,dst,count);
+			
+		}
+		
+		
+		const char * implementation () noexcept {
+			
+			return get_kernels().name;
+			
+		}
+		
+		
+	}
+	
+	
+}
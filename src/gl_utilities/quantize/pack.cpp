@@ -0,0 +1,352 @@
+#include <gl_utilities/quantize.hpp>
+#include <algorithm>
+#include <cmath>
+
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GL_UTILITIES_QUANTIZE_X86
+#include <immintrin.h>
+#endif
+
+
+namespace gl_utilities {
+	
+	
+	namespace quantize {
+		
+		
+		namespace {
+			
+			
+			//	NaN compares false and therefore becomes -1
+			inline float clamp (float f) noexcept {
+				
+				if (!(f>=-1.0f)) return -1.0f;
+				if (f>1.0f) return 1.0f;
+				
+				return f;
+				
+			}
+			
+			
+			//	Rounds to nearest, ties to even, as the SIMD
+			//	conversions do in the default rounding mode
+			inline std::int32_t round (float f) noexcept {
+				
+				return std::int32_t(std::nearbyint(f));
+				
+			}
+			
+			
+			inline float sign (float f) noexcept {
+				
+				return (f>=0.0f) ? 1.0f : -1.0f;
+				
+			}
+			
+			
+		}
+		
+		
+		namespace reference {
+			
+			
+			std::int16_t float_to_snorm16 (float f) noexcept {
+				
+				return std::int16_t(round(clamp(f)*32767.0f));
+				
+			}
+			
+			
+			void float_to_snorm16 (const float * src, std::int16_t * dst, std::size_t count) noexcept {
+				
+				for (std::size_t i=0;i<count;++i) dst[i]=float_to_snorm16(src[i]);
+				
+			}
+			
+			
+			float snorm16_to_float (std::int16_t i) noexcept {
+				
+				//	Both -32768 and -32767 represent -1
+				auto f=float(i)/32767.0f;
+				
+				return (f<-1.0f) ? -1.0f : f;
+				
+			}
+			
+			
+			void pack_snorm_2_10_10_10 (const float * src, std::uint32_t * dst, std::size_t count) noexcept {
+				
+				for (std::size_t i=0;i<count;++i,src+=4) {
+					
+					auto x=std::uint32_t(round(clamp(src[0])*511.0f))&0x3FFU;
+					auto y=std::uint32_t(round(clamp(src[1])*511.0f))&0x3FFU;
+					auto z=std::uint32_t(round(clamp(src[2])*511.0f))&0x3FFU;
+					auto w=std::uint32_t(round(clamp(src[3])))&0x3U;
+					dst[i]=x|(y<<10)|(z<<20)|(w<<30);
+					
+				}
+				
+			}
+			
+			
+			void unpack_snorm_2_10_10_10 (std::uint32_t p, float * dst) noexcept {
+				
+				//	Sign extend each field
+				auto field=[&] (unsigned shift, unsigned bits) noexcept {
+					
+					auto v=std::int32_t(p<<(32U-shift-bits))>>(32U-bits);
+					auto max=float((1<<(bits-1))-1);
+					auto f=float(v)/max;
+					
+					return (f<-1.0f) ? -1.0f : f;
+					
+				};
+				dst[0]=field(0,10);
+				dst[1]=field(10,10);
+				dst[2]=field(20,10);
+				dst[3]=field(30,2);
+				
+			}
+			
+			
+			void octahedral_encode (const float * src, std::int16_t * dst, std::size_t count) noexcept {
+				
+				for (std::size_t i=0;i<count;++i,src+=3,dst+=2) {
+					
+					auto s=(std::abs(src[0])+std::abs(src[1]))+std::abs(src[2]);
+					if (s==0.0f) {
+						
+						dst[0]=0;
+						dst[1]=0;
+						continue;
+						
+					}
+					
+					auto x=src[0]/s;
+					auto y=src[1]/s;
+					//	The lower hemisphere is folded over the
+					//	diagonals onto the corners of the square
+					if (src[2]<0.0f) {
+						
+						auto fx=(1.0f-std::abs(y))*sign(x);
+						auto fy=(1.0f-std::abs(x))*sign(y);
+						x=fx;
+						y=fy;
+						
+					}
+					dst[0]=float_to_snorm16(x);
+					dst[1]=float_to_snorm16(y);
+					
+				}
+				
+			}
+			
+			
+			void octahedral_decode (const std::int16_t * src, float * dst) noexcept {
+				
+				auto x=snorm16_to_float(src[0]);
+				auto y=snorm16_to_float(src[1]);
+				auto z=1.0f-std::abs(x)-std::abs(y);
+				auto t=std::max(-z,0.0f);
+				x+=(x>=0.0f) ? -t : t;
+				y+=(y>=0.0f) ? -t : t;
+				auto len=std::sqrt((x*x)+(y*y)+(z*z));
+				dst[0]=x/len;
+				dst[1]=y/len;
+				dst[2]=z/len;
+				
+			}
+			
+			
+		}
+		
+		
+		#ifdef GL_UTILITIES_QUANTIZE_X86
+		namespace {
+			
+			
+			//	Matches clamp: max returns its second operand
+			//	when either is NaN
+			__attribute__((target("sse2")))
+			inline __m128 clamp_sse2 (__m128 v) noexcept {
+				
+				return _mm_min_ps(_mm_max_ps(v,_mm_set1_ps(-1.0f)),_mm_set1_ps(1.0f));
+				
+			}
+			
+			
+			__attribute__((target("sse2")))
+			void float_to_snorm16_sse2 (const float * src, std::int16_t * dst, std::size_t count) noexcept {
+				
+				auto scale=_mm_set1_ps(32767.0f);
+				std::size_t i=0;
+				for (;(count-i)>=8;i+=8) {
+					
+					auto a=_mm_cvtps_epi32(_mm_mul_ps(clamp_sse2(_mm_loadu_ps(src+i)),scale));
+					auto b=_mm_cvtps_epi32(_mm_mul_ps(clamp_sse2(_mm_loadu_ps(src+i+4)),scale));
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+i),_mm_packs_epi32(a,b));
+					
+				}
+				
+				reference::float_to_snorm16(src+i,dst+i,count-i);
+				
+			}
+			
+			
+			__attribute__((target("sse4.1")))
+			void pack_snorm_2_10_10_10_sse41 (const float * src, std::uint32_t * dst, std::size_t count) noexcept {
+				
+				auto scale=_mm_setr_ps(511.0f,511.0f,511.0f,1.0f);
+				auto mask=_mm_setr_epi32(0x3FF,0x3FF,0x3FF,0x3);
+				auto shift=_mm_setr_epi32(1,1<<10,1<<20,1<<30);
+				for (std::size_t i=0;i<count;++i) {
+					
+					auto v=_mm_cvtps_epi32(_mm_mul_ps(clamp_sse2(_mm_loadu_ps(src+(i*4))),scale));
+					//	Fields do not overlap so adding them is
+					//	the same as or-ing them
+					v=_mm_mullo_epi32(_mm_and_si128(v,mask),shift);
+					v=_mm_or_si128(v,_mm_shuffle_epi32(v,_MM_SHUFFLE(1,0,3,2)));
+					v=_mm_or_si128(v,_mm_shuffle_epi32(v,_MM_SHUFFLE(2,3,0,1)));
+					dst[i]=std::uint32_t(_mm_cvtsi128_si32(v));
+					
+				}
+				
+			}
+			
+			
+			__attribute__((target("sse4.1")))
+			void octahedral_encode_sse41 (const float * src, std::int16_t * dst, std::size_t count) noexcept {
+				
+				auto sign_mask=_mm_set1_ps(-0.0f);
+				auto zero=_mm_setzero_ps();
+				auto one=_mm_set1_ps(1.0f);
+				auto scale=_mm_set1_ps(32767.0f);
+				std::size_t i=0;
+				for (;(count-i)>=4;i+=4) {
+					
+					//	Transpose four xyz triples into x, y, and z
+					auto a=_mm_loadu_ps(src+(i*3));
+					auto b=_mm_loadu_ps(src+(i*3)+4);
+					auto c=_mm_loadu_ps(src+(i*3)+8);
+					auto x=_mm_shuffle_ps(a,_mm_shuffle_ps(b,c,_MM_SHUFFLE(1,1,2,2)),_MM_SHUFFLE(2,0,3,0));
+					auto y=_mm_shuffle_ps(_mm_shuffle_ps(a,b,_MM_SHUFFLE(0,0,1,1)),_mm_shuffle_ps(b,c,_MM_SHUFFLE(2,2,3,3)),_MM_SHUFFLE(2,0,2,0));
+					auto z=_mm_shuffle_ps(_mm_shuffle_ps(a,b,_MM_SHUFFLE(1,1,2,2)),c,_MM_SHUFFLE(3,0,2,0));
+					
+					auto s=_mm_add_ps(_mm_add_ps(_mm_andnot_ps(sign_mask,x),_mm_andnot_ps(sign_mask,y)),_mm_andnot_ps(sign_mask,z));
+					auto nonzero=_mm_cmpneq_ps(s,zero);
+					x=_mm_div_ps(x,s);
+					y=_mm_div_ps(y,s);
+					
+					auto sx=_mm_blendv_ps(_mm_set1_ps(-1.0f),one,_mm_cmpge_ps(x,zero));
+					auto sy=_mm_blendv_ps(_mm_set1_ps(-1.0f),one,_mm_cmpge_ps(y,zero));
+					auto fx=_mm_mul_ps(_mm_sub_ps(one,_mm_andnot_ps(sign_mask,y)),sx);
+					auto fy=_mm_mul_ps(_mm_sub_ps(one,_mm_andnot_ps(sign_mask,x)),sy);
+					auto lower=_mm_cmplt_ps(z,zero);
+					x=_mm_and_ps(_mm_blendv_ps(x,fx,lower),nonzero);
+					y=_mm_and_ps(_mm_blendv_ps(y,fy,lower),nonzero);
+					
+					auto ix=_mm_cvtps_epi32(_mm_mul_ps(clamp_sse2(x),scale));
+					auto iy=_mm_cvtps_epi32(_mm_mul_ps(clamp_sse2(y),scale));
+					auto p=_mm_packs_epi32(ix,iy);
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+(i*2)),_mm_unpacklo_epi16(p,_mm_srli_si128(p,8)));
+					
+				}
+				
+				reference::octahedral_encode(src+(i*3),dst+(i*2),count-i);
+				
+			}
+			
+			
+		}
+		#endif
+		
+		
+		namespace {
+			
+			
+			class kernels {
+				
+				
+				public:
+				
+				
+					const char * name;
+					void (*float_to_snorm16) (const float *, std::int16_t *, std::size_t) noexcept;
+					void (*pack_snorm_2_10_10_10) (const float *, std::uint32_t *, std::size_t) noexcept;
+					void (*octahedral_encode) (const float *, std::int16_t *, std::size_t) noexcept;
+					
+					
+					kernels () noexcept {
+						
+						name="scalar";
+						float_to_snorm16=&reference::float_to_snorm16;
+						pack_snorm_2_10_10_10=&reference::pack_snorm_2_10_10_10;
+						octahedral_encode=&reference::octahedral_encode;
+						
+						#ifdef GL_UTILITIES_QUANTIZE_X86
+						__builtin_cpu_init();
+						if (__builtin_cpu_supports("sse2")) {
+							
+							name="sse2";
+							float_to_snorm16=&float_to_snorm16_sse2;
+							
+						}
+						if (__builtin_cpu_supports("sse4.1")) {
+							
+							name="sse4.1";
+							pack_snorm_2_10_10_10=&pack_snorm_2_10_10_10_sse41;
+							octahedral_encode=&octahedral_encode_sse41;
+							
+						}
+						#endif
+						
+					}
+				
+				
+			};
+			
+			
+			const kernels & get_kernels () noexcept {
+				
+				static const kernels retr;
+				return retr;
+				
+			}
+			
+			
+		}
+		
+		
+		void float_to_snorm16 (const float * src, std::int16_t * dst, std::size_t count) noexcept {
+			
+			get_kernels().float_to_snorm16(src,dst,count);
+			
+		}
+		
+		
+		void pack_snorm_2_10_10_10 (const float * src, std::uint32_t * dst, std::size_t count) noexcept {
+			
+			get_kernels().pack_snorm_2_10_10_10(src,dst,count);
+			
+		}
+		
+		
+		void octahedral_encode (const float * src, std::int16_t * dst, std::size_t count) noexcept {
+			
+			get_kernels().octahedral_encode(src,dst,count);
+			
+		}
+		
+		
+		const char * implementation () noexcept {
+			
+			return get_kernels().name;
+			
+		}
+		
+		
+	}
+	
+	
+}
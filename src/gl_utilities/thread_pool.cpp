@@ -0,0 +1,152 @@
+#include <gl_utilities/thread_pool.hpp>
+#include <algorithm>
+#include <exception>
+
+
+namespace gl_utilities {
+	
+	
+	void thread_pool::worker () {
+		
+		for (;;) {
+			
+			std::function<void ()> task;
+			{
+				
+				std::unique_lock<std::mutex> l(m_);
+				cv_.wait(l,[&] () {	return stop_ || !queue_.empty();	});
+				//	Only exit once the queue has been drained
+				if (queue_.empty()) return;
+				task=std::move(queue_.front());
+				queue_.pop_front();
+				
+			}
+			
+			//	Tasks are always packaged_tasks which capture
+			//	exceptions into their futures
+			task();
+			
+		}
+		
+	}
+	
+	
+	void thread_pool::push (std::function<void ()> task) {
+		
+		{
+			
+			std::lock_guard<std::mutex> l(m_);
+			queue_.push_back(std::move(task));
+			
+		}
+		
+		cv_.notify_one();
+		
+	}
+	
+	
+	thread_pool::thread_pool (std::size_t threads) : stop_(false) {
+		
+		if (threads==0) threads=std::max(std::thread::hardware_concurrency(),1U);
+		
+		threads_.reserve(threads);
+		try {
+			
+			for (std::size_t i=0;i<threads;++i) threads_.emplace_back([this] () {	worker();	});
+			
+		} catch (...) {
+			
+			{
+				
+				std::lock_guard<std::mutex> l(m_);
+				stop_=true;
+				
+			}
+			cv_.notify_all();
+			for (auto & t : threads_) t.join();
+			
+			throw;
+			
+		}
+		
+	}
+	
+	
+	thread_pool::~thread_pool () noexcept {
+		
+		{
+			
+			std::lock_guard<std::mutex> l(m_);
+			stop_=true;
+			
+		}
+		
+		cv_.notify_all();
+		for (auto & t : threads_) t.join();
+		
+	}
+	
+	
+	std::size_t thread_pool::size () const noexcept {
+		
+		return threads_.size();
+		
+	}
+	
+	
+	void thread_pool::parallel_for (std::size_t begin, std::size_t end, const std::function<void (std::size_t, std::size_t)> & func) {
+		
+		if (begin>=end) return;
+		
+		//	The calling thread counts as a worker
+		auto count=end-begin;
+		auto chunks=std::min(count,size()+1);
+		auto per=count/chunks;
+		auto extra=count%chunks;
+		
+		std::vector<std::future<void>> futures;
+		futures.reserve(chunks-1);
+		//	The first chunk is reserved for the calling thread
+		auto first_end=begin+per+((extra==0) ? 0 : 1);
+		auto curr=first_end;
+		for (std::size_t i=1;i<chunks;++i) {
+			
+			auto next=curr+per+((i<extra) ? 1 : 0);
+			futures.push_back(enqueue([&func,curr,next] () {	func(curr,next);	}));
+			curr=next;
+			
+		}
+		
+		std::exception_ptr ex;
+		try {
+			
+			func(begin,first_end);
+			
+		} catch (...) {
+			
+			ex=std::current_exception();
+			
+		}
+		
+		//	Every chunk must complete before returning since
+		//	they all refer to func
+		for (auto & f : futures) {
+			
+			try {
+				
+				f.get();
+				
+			} catch (...) {
+				
+				if (!ex) ex=std::current_exception();
+				
+			}
+			
+		}
+		
+		if (ex) std::rethrow_exception(ex);
+		
+	}
+	
+	
+}
@@ -0,0 +1,122 @@
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include "context.hpp"
+#include <gl_utilities/glew.hpp>
+#include <EGL/eglext.h>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace headless {
+	
+	
+	namespace {
+		
+		
+		bool has_extension (const char * extensions, const char * name) noexcept {
+			
+			if (extensions==nullptr) return false;
+			
+			auto len=std::strlen(name);
+			for (auto p=extensions;(p=std::strstr(p,name))!=nullptr;p+=len) {
+				
+				if (((p==extensions) || (p[-1]==' ')) && ((p[len]==' ') || (p[len]=='\0'))) return true;
+				
+			}
+			
+			return false;
+			
+		}
+		
+		
+		//	gl_utilities::glew::init cannot be used: GLEW built for
+		//	GLX (the default) loads every OpenGL entry point and only
+		//	then looks for a GLX display, of which there is none
+		//	under EGL, and reports GLEW_ERROR_NO_GLX_DISPLAY.  The
+		//	entry points resolve through libglvnd to whichever
+		//	context is current, so that error is harmless here.
+		//	GLEW built for EGL does not report it at all.
+		void init_glew () {
+			
+			glewExperimental=GL_TRUE;
+			auto c=glewInit();
+			#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+			if (c==GLEW_ERROR_NO_GLX_DISPLAY) c=GLEW_OK;
+			#endif
+			if (c!=GLEW_OK) throw gl_utilities::glew::error(c);
+			
+			//	GLEW leaves GL_INVALID_ENUM behind on core profiles
+			while (glGetError()!=GL_NO_ERROR);
+			
+		}
+		
+		
+	}
+	
+	
+	context::context (EGLint major, EGLint minor) : display_(EGL_NO_DISPLAY), context_(EGL_NO_CONTEXT) {
+		
+		auto client=eglQueryString(EGL_NO_DISPLAY,EGL_EXTENSIONS);
+		if (has_extension(client,"EGL_MESA_platform_surfaceless")) {
+			
+			auto get=reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+			if (get!=nullptr) display_=get(EGL_PLATFORM_SURFACELESS_MESA,EGL_DEFAULT_DISPLAY,nullptr);
+			
+		}
+		if (display_==EGL_NO_DISPLAY) display_=eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		if (display_==EGL_NO_DISPLAY) throw std::runtime_error("eglGetDisplay failed");
+		
+		if (eglInitialize(display_,nullptr,nullptr)==EGL_FALSE) throw std::runtime_error("eglInitialize failed");
+		
+		try {
+			
+			auto extensions=eglQueryString(display_,EGL_EXTENSIONS);
+			if (!has_extension(extensions,"EGL_KHR_surfaceless_context")) throw std::runtime_error("EGL_KHR_surfaceless_context is not supported");
+			if (eglBindAPI(EGL_OPENGL_API)==EGL_FALSE) throw std::runtime_error("eglBindAPI failed");
+			
+			EGLConfig config=EGL_NO_CONFIG_KHR;
+			if (!has_extension(extensions,"EGL_KHR_no_config_context")) {
+				
+				const EGLint config_attribs []={EGL_RENDERABLE_TYPE,EGL_OPENGL_BIT,EGL_NONE};
+				EGLint count;
+				if ((eglChooseConfig(display_,config_attribs,&config,1,&count)==EGL_FALSE) || (count==0)) throw std::runtime_error("eglChooseConfig failed");
+				
+			}
+			
+			const EGLint context_attribs []={
+				EGL_CONTEXT_MAJOR_VERSION_KHR,major,
+				EGL_CONTEXT_MINOR_VERSION_KHR,minor,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR,EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+				EGL_NONE
+			};
+			context_=eglCreateContext(display_,config,EGL_NO_CONTEXT,context_attribs);
+			if (context_==EGL_NO_CONTEXT) throw std::runtime_error("eglCreateContext failed");
+			
+			if (eglMakeCurrent(display_,EGL_NO_SURFACE,EGL_NO_SURFACE,context_)==EGL_FALSE) throw std::runtime_error("eglMakeCurrent failed");
+			
+			init_glew();
+			
+		} catch (...) {
+			
+			eglMakeCurrent(display_,EGL_NO_SURFACE,EGL_NO_SURFACE,EGL_NO_CONTEXT);
+			if (context_!=EGL_NO_CONTEXT) eglDestroyContext(display_,context_);
+			eglTerminate(display_);
+			
+			throw;
+			
+		}
+		
+	}
+	
+	
+	context::~context () noexcept {
+		
+		eglMakeCurrent(display_,EGL_NO_SURFACE,EGL_NO_SURFACE,EGL_NO_CONTEXT);
+		eglDestroyContext(display_,context_);
+		eglTerminate(display_);
+		
+	}
+	
+	
+}
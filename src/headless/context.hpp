@@ -0,0 +1,47 @@
+//	A headless OpenGL context for the command line tools, which
+//	must run where there is no display server
+
+
+#pragma once
+
+
+#include <EGL/egl.h>
+
+
+namespace headless {
+	
+	
+	//	A context without any surface on the Mesa surfaceless
+	//	platform (which needs neither a display server nor a
+	//	GPU when llvmpipe is used) or, failing that, on the
+	//	default display
+	//
+	//	The context is current on the calling thread for the
+	//	lifetime of the object and GLEW has been initialized
+	class context {
+		
+		
+		private:
+		
+		
+			EGLDisplay display_;
+			EGLContext context_;
+		
+		
+		public:
+		
+		
+			context (const context &) = delete;
+			context & operator = (const context &) = delete;
+			
+			
+			context (EGLint major, EGLint minor);
+			
+			
+			~context () noexcept;
+		
+		
+	};
+	
+	
+}
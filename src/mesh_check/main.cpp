@@ -0,0 +1,308 @@
+//	Checks that mesh optimization preserves the triangles of a
+//	large shuffled grid whose vertices are not shared, that it is
+//	deterministic, that it improves the cache miss and transform
+//	to vertex ratios, and that it narrows indices when the welded
+//	mesh allows, and then times each pass
+//
+//	Usage: mesh_check [<quads along each side>]
+//
+//	Exits with 1 if any check fails and 2 on any other error.
+
+
+#include <gl_utilities/mesh.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+	
+	
+	using namespace gl_utilities;
+	
+	
+	std::size_t failures=0;
+	
+	
+	void expect (bool condition, const char * what) {
+		
+		if (condition) return;
+		
+		std::cout << "FAILED: " << what << '\n';
+		++failures;
+		
+	}
+	
+	
+	class vertex {
+		
+		
+		public:
+		
+		
+			float position [3];
+			float uv [2];
+		
+		
+	};
+	
+	
+	class grid {
+		
+		
+		public:
+		
+		
+			std::vector<vertex> vertices;
+			std::vector<std::uint32_t> indices;
+		
+		
+	};
+	
+	
+	//	Every triangle has its own three vertices, as though the
+	//	mesh had been exported without an index buffer, and the
+	//	triangles are shuffled so that the input is as unfriendly
+	//	to the vertex cache as possible
+	grid make_grid (std::size_t n) {
+		
+		grid retr;
+		retr.vertices.reserve(n*n*6);
+		auto add=[&] (std::size_t x, std::size_t y) {
+			
+			vertex v{
+				{float(x),float(y),std::sin(float(x)*0.1f)*std::cos(float(y)*0.1f)},
+				{float(x)/float(n),float(y)/float(n)}
+			};
+			retr.vertices.push_back(v);
+			
+		};
+		for (std::size_t y=0;y<n;++y) for (std::size_t x=0;x<n;++x) {
+			
+			add(x,y);
+			add(x+1,y);
+			add(x,y+1);
+			add(x+1,y);
+			add(x+1,y+1);
+			add(x,y+1);
+			
+		}
+		
+		std::vector<std::uint32_t> order(n*n*2);
+		std::iota(order.begin(),order.end(),std::uint32_t(0));
+		std::mt19937 rng(1);
+		std::shuffle(order.begin(),order.end(),rng);
+		retr.indices.reserve(order.size()*3);
+		for (auto t : order) for (std::uint32_t i=0;i<3;++i) retr.indices.push_back((t*3)+i);
+		
+		return retr;
+		
+	}
+	
+	
+	std::vector<std::uint32_t> widen (const mesh::result & r) {
+		
+		std::vector<std::uint32_t> retr(r.index_count);
+		if (r.index_type==GL_UNSIGNED_SHORT) {
+			
+			for (std::size_t i=0;i<r.index_count;++i) {
+				
+				std::uint16_t index;
+				std::memcpy(&index,r.indices.data()+(i*sizeof(index)),sizeof(index));
+				retr[i]=index;
+				
+			}
+			
+		} else {
+			
+			std::memcpy(retr.data(),r.indices.data(),r.index_count*sizeof(std::uint32_t));
+			
+		}
+		
+		return retr;
+		
+	}
+	
+	
+	//	Each triangle as the contents of its vertices, rotated so
+	//	that the smallest comes first, which keeps the winding,
+	//	and then sorted so that the order of triangles does not
+	//	matter
+	using triangle=std::array<float,15>;
+	std::vector<triangle> triangles (const vertex * vertices, const std::vector<std::uint32_t> & indices) {
+		
+		std::vector<triangle> retr;
+		retr.reserve(indices.size()/3);
+		for (std::size_t t=0;t<indices.size();t+=3) {
+			
+			std::array<std::array<float,5>,3> corners;
+			for (std::size_t i=0;i<3;++i) std::memcpy(corners[i].data(),vertices+indices[t+i],sizeof(vertex));
+			auto first=std::min_element(corners.begin(),corners.end());
+			std::rotate(corners.begin(),first,corners.end());
+			triangle tri;
+			for (std::size_t i=0;i<3;++i) std::copy(corners[i].begin(),corners[i].end(),tri.begin()+(i*5));
+			retr.push_back(tri);
+			
+		}
+		std::sort(retr.begin(),retr.end());
+		
+		return retr;
+		
+	}
+	
+	
+	template <typename Func>
+	double seconds (Func func) {
+		
+		//	The fastest of several runs is the least disturbed
+		double retr=std::numeric_limits<double>::infinity();
+		for (int i=0;i<5;++i) {
+			
+			auto start=std::chrono::steady_clock::now();
+			func();
+			std::chrono::duration<double> elapsed=std::chrono::steady_clock::now()-start;
+			if (elapsed.count()<retr) retr=elapsed.count();
+			
+		}
+		
+		return retr;
+		
+	}
+	
+	
+	void print (const char * name, const mesh::statistics & s) {
+		
+		std::cout << std::left << std::setw(24) << name << std::right
+			<< "ACMR " << std::setw(6) << s.acmr
+			<< "  ATVR " << std::setw(6) << s.atvr << '\n';
+		
+	}
+	
+	
+	void check (const grid & g, std::size_t n) {
+		
+		auto r=mesh::optimize(g.indices.data(),g.indices.size(),g.vertices.data(),g.vertices.size(),sizeof(vertex));
+		
+		//	Every vertex of the input is referenced exactly once
+		//	so its transform to vertex ratio is trivially one, the
+		//	meaningful baseline is the same triangles with their
+		//	vertices merged but still in shuffled order
+		auto welded=mesh::weld(g.vertices.data(),g.vertices.size(),sizeof(vertex));
+		auto shuffled=g.indices;
+		mesh::remap_indices(shuffled.data(),shuffled.size(),welded);
+		auto baseline=mesh::analyze(shuffled.data(),shuffled.size(),welded.vertex_count);
+		
+		std::cout << std::fixed << std::setprecision(3);
+		print("Input",r.before);
+		print("Welded",baseline);
+		print("Optimized",r.after);
+		
+		expect(r.vertex_count==((n+1)*(n+1)),"identical vertices are welded");
+		expect(r.index_count==g.indices.size(),"every triangle is kept");
+		expect(r.after.acmr<r.before.acmr,"cache miss ratio improves on the input");
+		expect(r.after.acmr<baseline.acmr,"cache miss ratio improves on the welded input");
+		expect(r.after.atvr<baseline.atvr,"transform to vertex ratio improves on the welded input");
+		
+		//	The input needs 32 bit indices so narrowing is only
+		//	possible because of welding
+		auto expected=mesh::index_type(r.vertex_count);
+		expect(mesh::index_type(g.vertices.size())==GL_UNSIGNED_INT,"input needs 32 bit indices");
+		expect(r.index_type==expected,"indices are narrowed when the welded mesh allows");
+		std::size_t index_size=(expected==GL_UNSIGNED_SHORT) ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+		expect(r.indices.size()==(r.index_count*index_size),"indices are packed as their type");
+		std::cout << "Indices: " << ((r.index_type==GL_UNSIGNED_SHORT) ? 16 : 32) << " bit\n";
+		
+		auto indices=widen(r);
+		bool in_range=true;
+		for (auto i : indices) if (i>=r.vertex_count) in_range=false;
+		expect(in_range,"every index refers to a vertex");
+		if (in_range) {
+			
+			auto optimized=reinterpret_cast<const vertex *>(r.vertices.data());
+			expect(triangles(g.vertices.data(),g.indices)==triangles(optimized,indices),"triangles and their winding are preserved");
+			
+		}
+		
+		auto again=mesh::optimize(g.indices.data(),g.indices.size(),g.vertices.data(),g.vertices.size(),sizeof(vertex));
+		expect((again.vertices==r.vertices) && (again.indices==r.indices),"output is deterministic");
+		
+	}
+	
+	
+	void time (const grid & g) {
+		
+		auto welded=mesh::weld(g.vertices.data(),g.vertices.size(),sizeof(vertex));
+		auto indices=g.indices;
+		mesh::remap_indices(indices.data(),indices.size(),welded);
+		auto vertices=mesh::remap_vertices(g.vertices.data(),sizeof(vertex),welded);
+		auto cached=mesh::optimize_vertex_cache(indices.data(),indices.size(),welded.vertex_count);
+		auto drawn=mesh::optimize_overdraw(cached.data(),cached.size(),vertices.data(),welded.vertex_count,sizeof(vertex),0);
+		auto fetched=mesh::optimize_vertex_fetch(drawn.data(),drawn.size(),welded.vertex_count);
+		auto final_indices=drawn;
+		mesh::remap_indices(final_indices.data(),final_indices.size(),fetched);
+		
+		auto row=[] (const char * name, double s) {
+			
+			std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << (s*1000.0) << " ms\n";
+			
+		};
+		std::cout << std::setprecision(1) << g.indices.size()/3 << " triangles, " << g.vertices.size() << " vertices\n";
+		row("weld",seconds([&] () {	mesh::weld(g.vertices.data(),g.vertices.size(),sizeof(vertex));	}));
+		row("optimize_vertex_cache",seconds([&] () {	mesh::optimize_vertex_cache(indices.data(),indices.size(),welded.vertex_count);	}));
+		row("optimize_overdraw",seconds([&] () {	mesh::optimize_overdraw(cached.data(),cached.size(),vertices.data(),welded.vertex_count,sizeof(vertex),0);	}));
+		row("optimize_vertex_fetch",seconds([&] () {	mesh::optimize_vertex_fetch(drawn.data(),drawn.size(),welded.vertex_count);	}));
+		if (mesh::index_type(fetched.vertex_count)==GL_UNSIGNED_SHORT) row("narrow",seconds([&] () {	mesh::narrow(final_indices.data(),final_indices.size());	}));
+		row("optimize",seconds([&] () {	mesh::optimize(g.indices.data(),g.indices.size(),g.vertices.data(),g.vertices.size(),sizeof(vertex));	}));
+		
+	}
+	
+	
+}
+
+
+int main (int argc, char ** argv) {
+	
+	try {
+		
+		std::size_t n=1000;
+		if (argc>2) throw std::runtime_error("Usage: mesh_check [<quads along each side>]");
+		if (argc==2) n=std::size_t(std::strtoull(argv[1],nullptr,10));
+		//	Below this the unwelded input fits in 16 bit indices
+		if (n<105) throw std::runtime_error("The grid must have at least 105 quads along each side");
+		
+		auto g=make_grid(n);
+		check(g,n);
+		time(g);
+		
+		if (failures!=0) {
+			
+			std::cout << failures << " checks failed\n";
+			return EXIT_FAILURE;
+			
+		}
+		
+		std::cout << "All checks passed\n";
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		return 2;
+		
+	}
+	
+	return EXIT_SUCCESS;
+	
+}
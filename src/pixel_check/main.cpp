@@ -0,0 +1,279 @@
+//	Checks that every dispatched pixel conversion kernel produces
+//	output identical to its reference implementation and then
+//	times both
+//
+//	Usage: pixel_check [<values to time>]
+//
+//	Exits with 1 if any kernel disagrees with its reference and
+//	2 on any other error.
+
+
+#include <gl_utilities/pixel.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+	
+	
+	using namespace gl_utilities;
+	
+	
+	std::mt19937 rng(1);
+	std::size_t failures=0;
+	
+	
+	std::vector<std::uint8_t> random_bytes (std::size_t count) {
+		
+		std::vector<std::uint8_t> retr(count);
+		std::uniform_int_distribution<unsigned> d(0,255);
+		for (auto & b : retr) b=std::uint8_t(d(rng));
+		
+		return retr;
+		
+	}
+	
+	
+	std::vector<std::uint16_t> random_unorm16 (std::size_t count) {
+		
+		std::vector<std::uint16_t> retr(count);
+		std::uniform_int_distribution<unsigned> d(0,65535);
+		for (auto & v : retr) v=std::uint16_t(d(rng));
+		
+		return retr;
+		
+	}
+	
+	
+	//	Mixes ordinary values with those most likely to expose
+	//	differences: signed zeroes, infinities, NaN, denormals,
+	//	values at rounding boundaries, and values out of range
+	std::vector<float> random_floats (std::size_t count, float lo, float hi) {
+		
+		const float special []={
+			0.0f,-0.0f,1.0f,-1.0f,0.5f,
+			std::numeric_limits<float>::infinity(),
+			-std::numeric_limits<float>::infinity(),
+			std::numeric_limits<float>::quiet_NaN(),
+			std::numeric_limits<float>::denorm_min(),
+			std::numeric_limits<float>::min(),
+			65504.0f,65520.0f,1e-8f,6.1e-5f,0.0031308f,2.0f
+		};
+		std::vector<float> retr(count);
+		std::uniform_real_distribution<float> d(lo,hi);
+		std::uniform_int_distribution<unsigned> pick(0,15);
+		for (std::size_t i=0;i<count;++i) retr[i]=(pick(rng)==0) ? special[pick(rng)] : d(rng);
+		
+		return retr;
+		
+	}
+	
+	
+	template <typename Out>
+	void compare (const char * name, std::size_t count, const std::vector<Out> & a, const std::vector<Out> & b) {
+		
+		//	Bytes rather than values so that NaN and signed zero
+		//	must match exactly
+		if ((a.size()==b.size()) && ((a.empty()) || (std::memcmp(a.data(),b.data(),a.size()*sizeof(Out))==0))) return;
+		
+		std::cout << name << ": mismatch with " << count << " elements\n";
+		++failures;
+		
+	}
+	
+	
+	//	Runs a kernel and its reference over every length up to
+	//	a few vector widths (to cover every tail) and a long,
+	//	misaligned run
+	template <typename In, typename Out, typename Make, typename Kernel, typename Reference>
+	void check (const char * name, std::size_t in_per, std::size_t out_per, Make make, Kernel kernel, Reference ref) {
+		
+		std::vector<std::size_t> lengths;
+		for (std::size_t i=0;i<=70;++i) lengths.push_back(i);
+		lengths.push_back(4099);
+		
+		for (auto n : lengths) {
+			
+			//	Offset by one element so that the kernel cannot
+			//	rely on alignment
+			std::vector<In> in=make((n*in_per)+1);
+			std::vector<Out> a((n*out_per)+1,Out(0x5A));
+			auto b=a;
+			kernel(in.data()+1,a.data()+1,n);
+			ref(in.data()+1,b.data()+1,n);
+			compare(name,n,a,b);
+			
+		}
+		
+	}
+	
+	
+	template <typename Func>
+	double seconds (Func func) {
+		
+		//	The fastest of several runs is the least disturbed
+		double retr=std::numeric_limits<double>::infinity();
+		for (int i=0;i<5;++i) {
+			
+			auto start=std::chrono::steady_clock::now();
+			func();
+			std::chrono::duration<double> elapsed=std::chrono::steady_clock::now()-start;
+			if (elapsed.count()<retr) retr=elapsed.count();
+			
+		}
+		
+		return retr;
+		
+	}
+	
+	
+	template <typename In, typename Out, typename Make, typename Kernel, typename Reference>
+	void time (const char * name, std::size_t count, std::size_t in_per, std::size_t out_per, Make make, Kernel kernel, Reference ref) {
+		
+		std::vector<In> in=make(count*in_per);
+		std::vector<Out> out(count*out_per);
+		auto k=seconds([&] () {	kernel(in.data(),out.data(),count);	});
+		auto r=seconds([&] () {	ref(in.data(),out.data(),count);	});
+		auto rate=[&] (double s) {	return (double(count)/s)/1e6;	};
+		
+		std::cout << std::left << std::setw(20) << name << std::right
+			<< std::setw(10) << rate(k) << " M/s"
+			<< std::setw(10) << rate(r) << " M/s"
+			<< std::setw(8) << (r/k) << "x\n";
+		
+	}
+	
+	
+	template <typename In, typename Out, typename Make, typename Kernel, typename Reference>
+	void run (const char * name, std::size_t count, std::size_t in_per, std::size_t out_per, Make make, Kernel kernel, Reference ref) {
+		
+		check<In,Out>(name,in_per,out_per,make,kernel,ref);
+		time<In,Out>(name,count,in_per,out_per,make,kernel,ref);
+		
+	}
+	
+	
+}
+
+
+int main (int argc, char ** argv) {
+	
+	try {
+		
+		std::size_t count=1<<22;
+		if (argc>2) throw std::runtime_error("Usage: pixel_check [<values to time>]");
+		if (argc==2) count=std::size_t(std::strtoull(argv[1],nullptr,10));
+		
+		std::cout << "Implementation: " << pixel::implementation() << '\n'
+			<< std::fixed << std::setprecision(1)
+			<< std::left << std::setw(20) << "Kernel" << std::right
+			<< std::setw(14) << "Dispatched"
+			<< std::setw(14) << "Reference"
+			<< std::setw(9) << "Speedup\n";
+		
+		auto bytes=[] (std::size_t n) {	return random_bytes(n);	};
+		run<std::uint8_t,std::uint8_t>("rgb_to_rgba",count,3,4,bytes,
+			[] (const std::uint8_t * s, std::uint8_t * d, std::size_t n) {	pixel::rgb_to_rgba(s,d,n,7);	},
+			[] (const std::uint8_t * s, std::uint8_t * d, std::size_t n) {	pixel::reference::rgb_to_rgba(s,d,n,7);	}
+		);
+		run<std::uint8_t,std::uint8_t>("swizzle_bgra",count,4,4,bytes,
+			[] (const std::uint8_t * s, std::uint8_t * d, std::size_t n) {	pixel::swizzle_bgra(s,d,n);	},
+			[] (const std::uint8_t * s, std::uint8_t * d, std::size_t n) {	pixel::reference::swizzle_bgra(s,d,n);	}
+		);
+		run<float,std::uint16_t>("float_to_half",count,1,1,[] (std::size_t n) {	return random_floats(n,-70000.0f,70000.0f);	},
+			[] (const float * s, std::uint16_t * d, std::size_t n) {	pixel::float_to_half(s,d,n);	},
+			[] (const float * s, std::uint16_t * d, std::size_t n) {	pixel::reference::float_to_half(s,d,n);	}
+		);
+		run<std::uint16_t,std::uint8_t>("unorm16_to_unorm8",count,1,1,[] (std::size_t n) {	return random_unorm16(n);	},
+			[] (const std::uint16_t * s, std::uint8_t * d, std::size_t n) {	pixel::unorm16_to_unorm8(s,d,n);	},
+			[] (const std::uint16_t * s, std::uint8_t * d, std::size_t n) {	pixel::reference::unorm16_to_unorm8(s,d,n);	}
+		);
+		run<std::uint8_t,std::uint8_t>("premultiply",count,4,4,bytes,
+			[] (const std::uint8_t * s, std::uint8_t * d, std::size_t n) {	pixel::premultiply(s,d,n);	},
+			[] (const std::uint8_t * s, std::uint8_t * d, std::size_t n) {	pixel::reference::premultiply(s,d,n);	}
+		);
+		run<float,std::uint8_t>("srgb_encode",count,1,1,[] (std::size_t n) {	return random_floats(n,-0.25f,1.25f);	},
+			[] (const float * s, std::uint8_t * d, std::size_t n) {	pixel::srgb_encode(s,d,n);	},
+			[] (const float * s, std::uint8_t * d, std::size_t n) {	pixel::reference::srgb_encode(s,d,n);	}
+		);
+		run<std::uint8_t,float>("srgb_decode",count,1,1,bytes,
+			[] (const std::uint8_t * s, float * d, std::size_t n) {	pixel::srgb_decode(s,d,n);	},
+			[] (const std::uint8_t * s, float * d, std::size_t n) {	pixel::reference::srgb_decode(s,d,n);	}
+		);
+		
+		//	Every possible input of the single value conversions
+		//	which have few enough inputs to enumerate
+		for (unsigned i=0;i<256;++i) {
+			
+			auto c=std::uint8_t(i);
+			if (pixel::reference::srgb_encode(pixel::reference::srgb_decode(c))!=c) {
+				
+				std::cout << "srgb_decode: " << i << " does not round trip\n";
+				++failures;
+				
+			}
+			
+		}
+		
+		//	Every float within a few of a rounding boundary of
+		//	the encoding, which the dispatched kernel must not
+		//	round differently from the reference
+		std::vector<float> boundaries;
+		for (unsigned c=1;c<256;++c) {
+			
+			//	The smallest float in [0,1] which encodes to c
+			std::uint32_t lo=0;
+			std::uint32_t hi=0x3F800000U;
+			while (lo<hi) {
+				
+				auto mid=lo+((hi-lo)/2);
+				float f;
+				std::memcpy(&f,&mid,sizeof(f));
+				if (pixel::reference::srgb_encode(f)>=c) hi=mid;
+				else lo=mid+1;
+				
+			}
+			for (std::uint32_t u=lo-4;u!=(lo+4);++u) {
+				
+				float f;
+				std::memcpy(&f,&u,sizeof(f));
+				boundaries.push_back(f);
+				
+			}
+			
+		}
+		std::vector<std::uint8_t> a(boundaries.size());
+		auto b=a;
+		pixel::srgb_encode(boundaries.data(),a.data(),boundaries.size());
+		pixel::reference::srgb_encode(boundaries.data(),b.data(),boundaries.size());
+		compare("srgb_encode boundaries",boundaries.size(),a,b);
+		
+		if (failures!=0) {
+			
+			std::cout << failures << " mismatches\n";
+			return EXIT_FAILURE;
+			
+		}
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		return 2;
+		
+	}
+	
+	return EXIT_SUCCESS;
+	
+}
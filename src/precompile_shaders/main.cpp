@@ -0,0 +1,263 @@
+//	Compiles and links every program variant listed in a manifest
+//	in a headless OpenGL context, reporting how long each took and
+//	optionally filling a program binary cache
+//
+//	Usage: precompile_shaders [-I <include path>]... [-c <cache directory>]
+//		[-s <cache size in bytes>] [-g <major>.<minor>] <manifest>
+//
+//	Each non-empty line of the manifest which does not begin with
+//	'#' describes one variant:
+//
+//		<name> <stage>=<file>... [-D<definition>]...
+//
+//	where <stage> is one of vertex, tess_control, tess_evaluation,
+//	geometry, fragment, or compute.  Files are relative to the
+//	directory containing the manifest.
+//
+//	Exits with 1 if any variant fails to compile or link (after
+//	attempting every variant) and 2 on any other error.
+
+
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include "../headless/context.hpp"
+#include <gl_utilities/opengl.hpp>
+#include <gl_utilities/preprocessor.hpp>
+#include <gl_utilities/program_cache.hpp>
+#include <gl_utilities/variant_cache.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+	
+	
+	class variant {
+		
+		
+		public:
+		
+		
+			std::string name;
+			std::vector<gl_utilities::opengl::shader_file> stages;
+			std::vector<std::string> defines;
+			std::size_t line;
+		
+		
+	};
+	
+	
+	GLenum stage_type (const std::string & name) {
+		
+		if (name=="vertex") return GL_VERTEX_SHADER;
+		if (name=="tess_control") return GL_TESS_CONTROL_SHADER;
+		if (name=="tess_evaluation") return GL_TESS_EVALUATION_SHADER;
+		if (name=="geometry") return GL_GEOMETRY_SHADER;
+		if (name=="fragment") return GL_FRAGMENT_SHADER;
+		if (name=="compute") return GL_COMPUTE_SHADER;
+		
+		throw std::runtime_error("Unknown stage \""+name+"\"");
+		
+	}
+	
+	
+	std::vector<variant> parse (const std::string & path) {
+		
+		std::ifstream is(path.c_str());
+		if (!is) throw std::runtime_error("Could not open "+path);
+		
+		auto slash=path.rfind('/');
+		auto base=(slash==std::string::npos) ? std::string{} : path.substr(0,slash+1);
+		
+		std::vector<variant> retr;
+		std::string line;
+		for (std::size_t n=1;std::getline(is,line);++n) {
+			
+			std::istringstream ls(line);
+			variant v;
+			v.line=n;
+			if (!(ls >> v.name) || (v.name[0]=='#')) continue;
+			
+			std::ostringstream where;
+			where << path << ':' << n << ": ";
+			std::string token;
+			while (ls >> token) {
+				
+				if (token.compare(0,2,"-D")==0) {
+					
+					if (token.size()==2) throw std::runtime_error(where.str()+"Empty definition");
+					v.defines.push_back(token.substr(2));
+					continue;
+					
+				}
+				
+				auto equals=token.find('=');
+				if ((equals==std::string::npos) || (equals==0) || ((equals+1)==token.size())) throw std::runtime_error(where.str()+"Expected <stage>=<file> but found \""+token+"\"");
+				
+				auto file=token.substr(equals+1);
+				if (file[0]!='/') file=base+file;
+				v.stages.push_back(gl_utilities::opengl::shader_file{stage_type(token.substr(0,equals)),std::move(file)});
+				
+			}
+			if (v.stages.empty()) throw std::runtime_error(where.str()+"Variant \""+v.name+"\" has no stages");
+			
+			retr.push_back(std::move(v));
+			
+		}
+		
+		return retr;
+		
+	}
+	
+	
+	double milliseconds (std::chrono::steady_clock::duration d) noexcept {
+		
+		return std::chrono::duration<double,std::milli>(d).count();
+		
+	}
+	
+	
+	[[noreturn]]
+	void usage () {
+		
+		throw std::runtime_error("Usage: precompile_shaders [-I <include path>]... [-c <cache directory>] [-s <cache size in bytes>] [-g <major>.<minor>] <manifest>");
+		
+	}
+	
+	
+}
+
+
+int main (int argc, char ** argv) {
+	
+	using namespace gl_utilities::opengl;
+	
+	try {
+		
+		std::vector<std::string> include_paths;
+		std::string cache_directory;
+		std::size_t cache_size=std::size_t(256)*1024*1024;
+		EGLint major=3;
+		EGLint minor=3;
+		std::string manifest;
+		for (int i=1;i<argc;++i) {
+			
+			std::string arg(argv[i]);
+			if ((arg=="-I") || (arg=="-c") || (arg=="-s") || (arg=="-g")) {
+				
+				if ((i+1)==argc) usage();
+				std::string value(argv[++i]);
+				if (arg=="-I") include_paths.push_back(value);
+				else if (arg=="-c") cache_directory=value;
+				else if (arg=="-s") cache_size=std::size_t(std::strtoull(value.c_str(),nullptr,10));
+				else if (std::sscanf(value.c_str(),"%d.%d",&major,&minor)!=2) usage();
+				
+			} else {
+				
+				if (!manifest.empty()) usage();
+				manifest=arg;
+				
+			}
+			
+		}
+		if (manifest.empty()) usage();
+		
+		auto variants=parse(manifest);
+		
+		headless::context ctx(major,minor);
+		std::cout << "Renderer: " << reinterpret_cast<const char *>(glGetString(GL_RENDERER)) << '\n'
+			<< "Version: " << reinterpret_cast<const char *>(glGetString(GL_VERSION)) << '\n';
+		
+		shader_preprocessor pre(include_paths);
+		gl_utilities::optional<program_cache> cache;
+		if (!cache_directory.empty()) {
+			
+			cache.emplace(cache_directory,cache_size);
+			if (!cache->supported()) std::cout << "Warning: no program binary formats are supported, nothing will be cached\n";
+			
+		}
+		
+		std::size_t failures=0;
+		std::chrono::steady_clock::duration compile_total{};
+		std::chrono::steady_clock::duration link_total{};
+		std::cout << std::fixed << std::setprecision(2);
+		for (auto & v : variants) {
+			
+			std::cout << v.name;
+			for (auto & d : v.defines) std::cout << " -D" << d;
+			std::cout << ": " << std::flush;
+			
+			try {
+				
+				//	The cache injects the definitions itself, so it
+				//	is given the sources as loaded
+				auto defines=canonical_defines(v.defines);
+				std::vector<shader_source> sources;
+				for (auto & s : v.stages) sources.push_back(shader_source{s.type,pre.load(s.filename)});
+				
+				auto start=std::chrono::steady_clock::now();
+				program p;
+				std::vector<shader> shaders;
+				for (auto & s : sources) {
+					
+					shaders.emplace_back(s.type,inject_defines(s.source,defines));
+					p.attach(shaders.back());
+					
+				}
+				auto compiled=std::chrono::steady_clock::now();
+				
+				if (cache) {
+					
+					glProgramParameteri(p,GL_PROGRAM_BINARY_RETRIEVABLE_HINT,GL_TRUE);
+					raise();
+					
+				}
+				p.link();
+				auto linked=std::chrono::steady_clock::now();
+				
+				if (cache) cache->store(sources,defines,p);
+				
+				compile_total+=compiled-start;
+				link_total+=linked-compiled;
+				std::cout << "compile " << milliseconds(compiled-start) << " ms, link " << milliseconds(linked-compiled) << " ms\n";
+				
+			} catch (const shader_compilation_error & ex) {
+				
+				++failures;
+				std::cout << "FAILED\n";
+				std::cerr << manifest << ':' << v.line << ": " << v.name << ": compilation failed:\n" << ex.what() << std::endl;
+				
+			} catch (const program_linking_error & ex) {
+				
+				++failures;
+				std::cout << "FAILED\n";
+				std::cerr << manifest << ':' << v.line << ": " << v.name << ": linking failed:\n" << ex.what() << std::endl;
+				
+			}
+			
+		}
+		
+		std::cout << variants.size() << " variants, " << failures << " failed, compile " << milliseconds(compile_total)
+			<< " ms, link " << milliseconds(link_total) << " ms" << std::endl;
+		
+		return (failures==0) ? 0 : 1;
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		
+		return 2;
+		
+	}
+	
+}
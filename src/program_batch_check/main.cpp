@@ -0,0 +1,172 @@
+//	Builds the same number of distinct programs one at a time
+//	(querying the status of each compile and link as it is
+//	issued) and through a program_batch, reporting how long each
+//	took, and checks that errors are reported when a program is
+//	taken rather than when it is added
+//
+//	Usage: program_batch_check [<programs>]
+//
+//	Exits with 1 if the batch does not behave as documented and
+//	2 on any other error.
+
+
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include "../headless/context.hpp"
+#include <gl_utilities/opengl.hpp>
+#include <gl_utilities/program_batch.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+	
+	
+	using namespace gl_utilities::opengl;
+	
+	
+	const char * const vertex_source=
+		"#version 330 core\n"
+		"layout(location=0) in vec4 position;\n"
+		"out vec2 uv;\n"
+		"void main () {\n"
+		"\tuv=position.zw;\n"
+		"\tgl_Position=vec4(position.xy,0.0,1.0);\n"
+		"}\n";
+	
+	
+	//	Every program differs in its constants so that no
+	//	implementation or on disk cache can share work between
+	//	them, neither within a run nor across runs
+	std::vector<shader_source> make_sources (unsigned seed) {
+		
+		std::string fragment=
+			"#version 330 core\n"
+			"in vec2 uv;\n"
+			"out vec4 color;\n"
+			"uniform sampler2D tex;\n"
+			"const float seed=";
+		fragment+=std::to_string(seed);
+		fragment+=
+			".0;\n"
+			"vec3 shade (vec2 p, float k) {\n"
+			"\tvec3 c=texture(tex,p).rgb;\n"
+			"\tfor (int i=0;i<8;++i) {\n"
+			"\t\tp=vec2(p.x*p.x-p.y*p.y,2.0*p.x*p.y)+vec2(k,seed*0.001);\n"
+			"\t\tc+=sin(vec3(p,k)*float(i+1))*exp(-dot(p,p));\n"
+			"\t}\n"
+			"\treturn c;\n"
+			"}\n"
+			"void main () {\n"
+			"\tvec3 c=shade(uv,seed)+shade(uv.yx,-seed)+shade(uv*2.0,seed*0.5);\n"
+			"\tcolor=vec4(pow(clamp(c,0.0,1.0),vec3(1.0/2.2)),1.0);\n"
+			"}\n";
+		
+		return std::vector<shader_source>{
+			shader_source{GL_VERTEX_SHADER,vertex_source},
+			shader_source{GL_FRAGMENT_SHADER,std::move(fragment)}
+		};
+		
+	}
+	
+	
+	double milliseconds (std::chrono::steady_clock::duration d) {
+		
+		return std::chrono::duration<double,std::milli>(d).count();
+		
+	}
+	
+	
+}
+
+
+int main (int argc, char ** argv) {
+	
+	try {
+		
+		std::size_t count=200;
+		if (argc>2) throw std::runtime_error("Usage: program_batch_check [<programs>]");
+		if (argc==2) count=std::size_t(std::strtoull(argv[1],nullptr,10));
+		
+		headless::context ctx(3,3);
+		auto parallel=GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+		std::cout << "Renderer: " << reinterpret_cast<const char *>(glGetString(GL_RENDERER)) << '\n'
+			<< "Parallel shader compile: " << (parallel ? "yes" : "no") << '\n';
+		
+		std::random_device rd;
+		auto seed=rd()%1000000U;
+		
+		auto start=std::chrono::steady_clock::now();
+		std::vector<program> serial;
+		for (std::size_t i=0;i<count;++i) {
+			
+			program p;
+			std::vector<shader> shaders;
+			for (auto & s : make_sources(seed+unsigned(i))) {
+				
+				shaders.emplace_back(s.type,s.source);
+				p.attach(shaders.back());
+				
+			}
+			p.link();
+			serial.push_back(std::move(p));
+			
+		}
+		auto serial_time=std::chrono::steady_clock::now()-start;
+		
+		//	Distinct from the programs built serially
+		seed+=unsigned(count);
+		start=std::chrono::steady_clock::now();
+		program_batch batch;
+		for (std::size_t i=0;i<count;++i) batch.add(make_sources(seed+unsigned(i)));
+		auto issued=std::chrono::steady_clock::now();
+		std::vector<program> batched;
+		for (std::size_t i=0;i<count;++i) batched.push_back(batch.take(i));
+		auto batch_time=std::chrono::steady_clock::now()-start;
+		
+		std::cout << std::fixed << std::setprecision(1)
+			<< count << " programs\n"
+			<< "One at a time: " << std::setw(10) << milliseconds(serial_time) << " ms\n"
+			<< "Batched:       " << std::setw(10) << milliseconds(batch_time) << " ms (issuing "
+			<< milliseconds(issued-start) << " ms, " << std::setprecision(2)
+			<< (milliseconds(serial_time)/milliseconds(batch_time)) << "x)\n";
+		
+		//	A broken program must neither throw when added nor
+		//	prevent the programs around it from being taken
+		program_batch errors;
+		errors.add(make_sources(seed+unsigned(count)));
+		auto broken=errors.add(std::vector<shader_source>{shader_source{GL_FRAGMENT_SHADER,"#version 330 core\nvoid main () {\n\tnot glsl;\n}\n"}});
+		errors.add(make_sources(seed+unsigned(count)+1U));
+		
+		std::size_t failures=0;
+		errors.take(0);
+		errors.take(2);
+		try {
+			
+			errors.take(broken);
+			std::cout << "FAILED: broken program was taken\n";
+			++failures;
+			
+		} catch (const shader_compilation_error &) {	}
+		
+		if (failures!=0) return EXIT_FAILURE;
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		return 2;
+		
+	}
+	
+	return EXIT_SUCCESS;
+	
+}
@@ -0,0 +1,365 @@
+//	Checks that every dispatched quantization kernel produces
+//	output identical to its reference implementation, that the
+//	error each conversion introduces stays within its bound, and
+//	then times both
+//
+//	Usage: quantize_check [<vectors to time>]
+//
+//	Exits with 1 if any kernel disagrees with its reference or
+//	exceeds its error bound and 2 on any other error.
+
+
+#include <gl_utilities/quantize.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+	
+	
+	using namespace gl_utilities;
+	
+	
+	std::mt19937 rng(1);
+	std::size_t failures=0;
+	
+	
+	void fail (const char * name, const char * what) {
+		
+		std::cout << name << ": " << what << '\n';
+		++failures;
+		
+	}
+	
+	
+	//	Mixes ordinary values with those most likely to expose
+	//	differences: signed zeroes, infinities, NaN, denormals,
+	//	values exactly halfway between two results, and values
+	//	out of range
+	std::vector<float> random_floats (std::size_t count) {
+		
+		const float special []={
+			0.0f,-0.0f,1.0f,-1.0f,0.5f,-0.5f,
+			std::numeric_limits<float>::infinity(),
+			-std::numeric_limits<float>::infinity(),
+			std::numeric_limits<float>::quiet_NaN(),
+			std::numeric_limits<float>::denorm_min(),
+			-std::numeric_limits<float>::denorm_min(),
+			0.5f/32767.0f,1.5f/32767.0f,-2.5f/32767.0f,
+			0.5f/511.0f,1.5f
+		};
+		std::vector<float> retr(count);
+		std::uniform_real_distribution<float> d(-1.5f,1.5f);
+		std::uniform_int_distribution<unsigned> pick(0,15);
+		for (std::size_t i=0;i<count;++i) retr[i]=(pick(rng)==0) ? special[pick(rng)] : d(rng);
+		
+		return retr;
+		
+	}
+	
+	
+	//	Unit vectors distributed uniformly over the sphere, mixed
+	//	with the zero vector, signed zero components, and the
+	//	axes, which lie on the folds of the octahedron
+	std::vector<float> random_directions (std::size_t count) {
+		
+		const float special [][3]={
+			{0.0f,0.0f,0.0f},{-0.0f,-0.0f,-0.0f},
+			{1.0f,0.0f,0.0f},{-1.0f,0.0f,0.0f},
+			{0.0f,1.0f,0.0f},{0.0f,-1.0f,0.0f},
+			{0.0f,0.0f,1.0f},{0.0f,0.0f,-1.0f},
+			{-0.0f,0.0f,-1.0f},{0.0f,-0.0f,-1.0f}
+		};
+		std::vector<float> retr(count*3);
+		std::normal_distribution<float> d;
+		std::uniform_int_distribution<unsigned> pick(0,15);
+		for (std::size_t i=0;i<count;++i) {
+			
+			auto v=&retr[i*3];
+			auto p=pick(rng);
+			if (p<10) {
+				
+				std::copy(special[p],special[p]+3,v);
+				continue;
+				
+			}
+			
+			float l;
+			do {
+				
+				for (std::size_t j=0;j<3;++j) v[j]=d(rng);
+				l=std::sqrt((v[0]*v[0])+(v[1]*v[1])+(v[2]*v[2]));
+				
+			} while (l==0.0f);
+			for (std::size_t j=0;j<3;++j) v[j]/=l;
+			
+		}
+		
+		return retr;
+		
+	}
+	
+	
+	//	Runs a kernel and its reference over every length up to
+	//	a few vector widths (to cover every tail) and a long,
+	//	misaligned run and compares the bytes of the results, so
+	//	that NaN and signed zero must be handled identically
+	template <typename Out, typename Make, typename Kernel, typename Reference>
+	void check (const char * name, std::size_t in_per, std::size_t out_per, Make make, Kernel kernel, Reference ref) {
+		
+		std::vector<std::size_t> lengths;
+		for (std::size_t i=0;i<=70;++i) lengths.push_back(i);
+		lengths.push_back(4099);
+		
+		for (auto n : lengths) {
+			
+			//	Offset by one element so that the kernel cannot
+			//	rely on alignment
+			std::vector<float> in=make((n*in_per)+1);
+			std::vector<Out> a((n*out_per)+1,Out(0x5A));
+			auto b=a;
+			kernel(in.data()+1,a.data()+1,n);
+			ref(in.data()+1,b.data()+1,n);
+			if (std::memcmp(a.data(),b.data(),a.size()*sizeof(Out))!=0) {
+				
+				std::cout << name << ": mismatch with " << n << " elements\n";
+				++failures;
+				
+			}
+			
+		}
+		
+	}
+	
+	
+	float clamp (float f) noexcept {
+		
+		if (std::isnan(f)) return -1.0f;
+		
+		return std::min(std::max(f,-1.0f),1.0f);
+		
+	}
+	
+	
+	//	The rounding of the decoded value itself is allowed
+	//	for on top of half a step
+	float bound (float steps) noexcept {
+		
+		return (0.5f/steps)+std::numeric_limits<float>::epsilon();
+		
+	}
+	
+	
+	void check_snorm16 (const std::vector<float> & in) {
+		
+		std::vector<std::int16_t> out(in.size());
+		quantize::float_to_snorm16(in.data(),out.data(),in.size());
+		
+		float worst=0.0f;
+		for (std::size_t i=0;i<in.size();++i) worst=std::max(worst,std::abs(quantize::reference::snorm16_to_float(out[i])-clamp(in[i])));
+		std::cout << "float_to_snorm16: worst error " << worst << ", bound " << bound(32767.0f) << '\n';
+		if (worst>bound(32767.0f)) fail("float_to_snorm16","error exceeds half a step");
+		
+		//	Exact results required by the documentation
+		const float nan=std::numeric_limits<float>::quiet_NaN();
+		if (quantize::reference::float_to_snorm16(nan)!=-32767) fail("float_to_snorm16","NaN does not become -1");
+		if (quantize::reference::float_to_snorm16(-0.0f)!=0) fail("float_to_snorm16","-0 does not become 0");
+		if (quantize::reference::float_to_snorm16(2.0f)!=32767) fail("float_to_snorm16","2 is not clamped");
+		if (quantize::reference::float_to_snorm16(-2.0f)!=-32767) fail("float_to_snorm16","-2 is not clamped");
+		//	Ties go to even
+		if (quantize::reference::float_to_snorm16(0.5f/32767.0f)!=0) fail("float_to_snorm16","0.5 does not round to even");
+		if (quantize::reference::float_to_snorm16(1.5f/32767.0f)!=2) fail("float_to_snorm16","1.5 does not round to even");
+		
+	}
+	
+	
+	void check_2_10_10_10 (const std::vector<float> & in) {
+		
+		auto count=in.size()/4;
+		std::vector<std::uint32_t> out(count);
+		quantize::pack_snorm_2_10_10_10(in.data(),out.data(),count);
+		
+		float worst=0.0f;
+		for (std::size_t i=0;i<count;++i) {
+			
+			float v [4];
+			quantize::reference::unpack_snorm_2_10_10_10(out[i],v);
+			for (std::size_t j=0;j<3;++j) worst=std::max(worst,std::abs(v[j]-clamp(in[(i*4)+j])));
+			
+		}
+		std::cout << "pack_snorm_2_10_10_10: worst error " << worst << ", bound " << bound(511.0f) << '\n';
+		if (worst>bound(511.0f)) fail("pack_snorm_2_10_10_10","error exceeds half a step");
+		
+		//	The last component can only represent -1, 0, and 1
+		const float w []={-1.0f,0.0f,-0.0f,1.0f};
+		for (auto f : w) {
+			
+			const float src []={0.0f,0.0f,0.0f,f};
+			std::uint32_t p;
+			quantize::reference::pack_snorm_2_10_10_10(src,&p,1);
+			float v [4];
+			quantize::reference::unpack_snorm_2_10_10_10(p,v);
+			if (v[3]!=(f+0.0f)) fail("pack_snorm_2_10_10_10","last component does not round trip");
+			
+		}
+		
+	}
+	
+	
+	void check_octahedral (const std::vector<float> & in) {
+		
+		auto count=in.size()/3;
+		std::vector<std::int16_t> out(count*2);
+		quantize::octahedral_encode(in.data(),out.data(),count);
+		
+		//	In double and through the cross product since the arc
+		//	cosine of a dot product close to one is too imprecise
+		//	(in float it alone accounts for about 0.04 degrees)
+		double worst=0.0;
+		for (std::size_t i=0;i<count;++i) {
+			
+			auto a=&in[i*3];
+			if ((a[0]==0.0f) && (a[1]==0.0f) && (a[2]==0.0f)) {
+				
+				if ((out[i*2]!=0) || (out[(i*2)+1]!=0)) fail("octahedral_encode","zero vector does not encode as (0,0)");
+				continue;
+				
+			}
+			
+			float b [3];
+			quantize::reference::octahedral_decode(&out[i*2],b);
+			double cross [3]={
+				(double(a[1])*b[2])-(double(a[2])*b[1]),
+				(double(a[2])*b[0])-(double(a[0])*b[2]),
+				(double(a[0])*b[1])-(double(a[1])*b[0])
+			};
+			double dot=(double(a[0])*b[0])+(double(a[1])*b[1])+(double(a[2])*b[2]);
+			double sin=std::sqrt((cross[0]*cross[0])+(cross[1]*cross[1])+(cross[2]*cross[2]));
+			worst=std::max(worst,std::atan2(sin,dot));
+			
+		}
+		
+		const double pi=3.14159265358979323846;
+		auto degrees=worst*180.0/pi;
+		std::cout << "octahedral_encode: worst error " << degrees << " degrees, bound 0.005\n";
+		if (degrees>0.005) fail("octahedral_encode","error exceeds 0.005 degrees");
+		
+	}
+	
+	
+	template <typename Func>
+	double seconds (Func func) {
+		
+		//	The fastest of several runs is the least disturbed
+		double retr=std::numeric_limits<double>::infinity();
+		for (int i=0;i<5;++i) {
+			
+			auto start=std::chrono::steady_clock::now();
+			func();
+			std::chrono::duration<double> elapsed=std::chrono::steady_clock::now()-start;
+			if (elapsed.count()<retr) retr=elapsed.count();
+			
+		}
+		
+		return retr;
+		
+	}
+	
+	
+	template <typename Out, typename Kernel, typename Reference>
+	void time (const char * name, const std::vector<float> & in, std::size_t count, std::size_t out_per, Kernel kernel, Reference ref) {
+		
+		std::vector<Out> out(count*out_per);
+		auto k=seconds([&] () {	kernel(in.data(),out.data(),count);	});
+		auto r=seconds([&] () {	ref(in.data(),out.data(),count);	});
+		auto rate=[&] (double s) {	return (double(count)/s)/1e6;	};
+		
+		std::cout << std::left << std::setw(24) << name << std::right
+			<< std::setw(10) << rate(k) << " M/s"
+			<< std::setw(10) << rate(r) << " M/s"
+			<< std::setw(8) << (r/k) << "x\n";
+		
+	}
+	
+	
+}
+
+
+int main (int argc, char ** argv) {
+	
+	try {
+		
+		std::size_t count=1<<22;
+		if (argc>2) throw std::runtime_error("Usage: quantize_check [<vectors to time>]");
+		if (argc==2) count=std::size_t(std::strtoull(argv[1],nullptr,10));
+		
+		std::cout << "Implementation: " << quantize::implementation() << '\n';
+		
+		auto floats=[] (std::size_t n) {	return random_floats(n);	};
+		check<std::int16_t>("float_to_snorm16",1,1,floats,
+			[] (const float * s, std::int16_t * d, std::size_t n) {	quantize::float_to_snorm16(s,d,n);	},
+			[] (const float * s, std::int16_t * d, std::size_t n) {	quantize::reference::float_to_snorm16(s,d,n);	}
+		);
+		check<std::uint32_t>("pack_snorm_2_10_10_10",4,1,floats,
+			[] (const float * s, std::uint32_t * d, std::size_t n) {	quantize::pack_snorm_2_10_10_10(s,d,n);	},
+			[] (const float * s, std::uint32_t * d, std::size_t n) {	quantize::reference::pack_snorm_2_10_10_10(s,d,n);	}
+		);
+		//	Directions are padded to a whole number of vectors
+		check<std::int16_t>("octahedral_encode",3,2,[] (std::size_t n) {	return random_directions((n+2)/3);	},
+			[] (const float * s, std::int16_t * d, std::size_t n) {	quantize::octahedral_encode(s,d,n);	},
+			[] (const float * s, std::int16_t * d, std::size_t n) {	quantize::reference::octahedral_encode(s,d,n);	}
+		);
+		
+		auto values=random_floats(count*4);
+		auto directions=random_directions(count);
+		check_snorm16(values);
+		check_2_10_10_10(values);
+		check_octahedral(directions);
+		
+		std::cout << std::fixed << std::setprecision(1)
+			<< std::left << std::setw(24) << "Kernel" << std::right
+			<< std::setw(14) << "Dispatched"
+			<< std::setw(14) << "Reference"
+			<< std::setw(9) << "Speedup\n";
+		time<std::int16_t>("float_to_snorm16",values,count*4,1,
+			[] (const float * s, std::int16_t * d, std::size_t n) {	quantize::float_to_snorm16(s,d,n);	},
+			[] (const float * s, std::int16_t * d, std::size_t n) {	quantize::reference::float_to_snorm16(s,d,n);	}
+		);
+		time<std::uint32_t>("pack_snorm_2_10_10_10",values,count,1,
+			[] (const float * s, std::uint32_t * d, std::size_t n) {	quantize::pack_snorm_2_10_10_10(s,d,n);	},
+			[] (const float * s, std::uint32_t * d, std::size_t n) {	quantize::reference::pack_snorm_2_10_10_10(s,d,n);	}
+		);
+		time<std::int16_t>("octahedral_encode",directions,count,2,
+			[] (const float * s, std::int16_t * d, std::size_t n) {	quantize::octahedral_encode(s,d,n);	},
+			[] (const float * s, std::int16_t * d, std::size_t n) {	quantize::reference::octahedral_encode(s,d,n);	}
+		);
+		
+		if (failures!=0) {
+			
+			std::cout << failures << " failures\n";
+			return EXIT_FAILURE;
+			
+		}
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		return 2;
+		
+	}
+	
+	return EXIT_SUCCESS;
+	
+}
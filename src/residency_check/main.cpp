@@ -0,0 +1,235 @@
+//	Checks that the residency manager evicts in least recently
+//	bound order, that a texture which has had levels dropped
+//	keeps its place in that order, its sampling parameters, and
+//	its remaining levels, and that storage sizes count the faces
+//	of cube maps exactly once.  Also checks that a texture which
+//	must lose several levels loses them all at once, no further
+//	than its minimum number of levels
+//
+//	Usage: residency_check
+//
+//	Exits with 1 if any check fails and 2 on any other error.
+
+
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include "../headless/context.hpp"
+#include <gl_utilities/opengl.hpp>
+#include <gl_utilities/residency.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+	
+	
+	using namespace gl_utilities::opengl;
+	
+	
+	const GLsizei size=64;
+	const GLsizei levels=7;
+	std::size_t failures=0;
+	
+	
+	void expect (bool condition, const char * what) {
+		
+		if (condition) return;
+		
+		std::cout << "FAILED: " << what << '\n';
+		++failures;
+		
+	}
+	
+	
+	texture_storage storage () noexcept {
+		
+		return texture_storage{GL_TEXTURE_2D,GL_RGBA8,size,size,1,levels,0};
+		
+	}
+	
+	
+	//	Every texel of each level is filled with the index of
+	//	that level so that levels can be told apart once they
+	//	have been renumbered
+	texture make () {
+		
+		texture retr;
+		auto g=retr.bind(GL_TEXTURE_2D);
+		glTexStorage2D(GL_TEXTURE_2D,levels,GL_RGBA8,size,size);
+		for (GLsizei i=0;i<levels;++i) {
+			
+			GLsizei d=std::max(size>>i,1);
+			std::vector<std::uint8_t> texels(std::size_t(d)*std::size_t(d)*4,std::uint8_t(i));
+			glTexSubImage2D(GL_TEXTURE_2D,i,0,0,d,d,GL_RGBA,GL_UNSIGNED_BYTE,texels.data());
+			
+		}
+		raise();
+		
+		return retr;
+		
+	}
+	
+	
+	GLint parameter (GLenum name) {
+		
+		GLint retr;
+		glGetTexParameteriv(GL_TEXTURE_2D,name,&retr);
+		raise();
+		
+		return retr;
+		
+	}
+	
+	
+	void check_sizes () {
+		
+		texture_storage cube{GL_TEXTURE_CUBE_MAP,GL_RGBA8,4,4,1,1,0};
+		expect(cube.size()==4*4*4*6,"cube map size counts six faces");
+		
+		//	Two cubes, the depth already counts layer-faces
+		texture_storage cube_array{GL_TEXTURE_CUBE_MAP_ARRAY,GL_RGBA8,4,4,12,1,0};
+		expect(cube_array.size()==4*4*4*12,"cube map array size counts each layer-face once");
+		
+	}
+	
+	
+	void check_eviction () {
+		
+		auto bytes=storage().size();
+		
+		//	Bound in the order a, b, c, so a is least recently
+		//	used
+		auto ta=make();
+		{
+			
+			auto g=ta.bind(GL_TEXTURE_2D);
+			glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
+			const GLint swizzle []={GL_RED,GL_RED,GL_RED,GL_ONE};
+			glTexParameteriv(GL_TEXTURE_2D,GL_TEXTURE_SWIZZLE_RGBA,swizzle);
+			glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAX_LEVEL,4);
+			raise();
+			
+		}
+		auto tb=make();
+		auto tc=make();
+		
+		residency_manager m((bytes*3)-100);
+		auto a=m.add(std::move(ta),storage());
+		auto b=m.add(std::move(tb),storage());
+		auto c=m.add(std::move(tc),storage());
+		
+		m.enforce();
+		expect(m.storage(a).levels==levels-1,"least recently bound texture loses its top level");
+		expect(m.storage(b).levels==levels,"more recently bound texture is untouched");
+		expect(m.get(a).last_bound()<m.get(b).last_bound(),"downgraded texture stays at the front of the order");
+		
+		//	Goes over budget again, which must once more be
+		//	resolved by the same texture
+		auto extra=m.account(GL_RGBA8,size,size);
+		m.enforce();
+		expect(m.storage(a).levels==levels-2,"downgraded texture is downgraded again");
+		expect(m.storage(b).levels==levels,"more recently bound texture is still untouched");
+		expect(m.storage(c).levels==levels,"most recently bound texture is untouched");
+		expect(m.used()<=m.budget(),"usage is within budget");
+		
+		auto g=m.get(a).bind(GL_TEXTURE_2D);
+		expect(parameter(GL_TEXTURE_MIN_FILTER)==GL_NEAREST,"minification filter is kept");
+		expect(parameter(GL_TEXTURE_WRAP_S)==GL_CLAMP_TO_EDGE,"wrap mode is kept");
+		expect(parameter(GL_TEXTURE_SWIZZLE_G)==GL_RED,"swizzle is kept");
+		expect(parameter(GL_TEXTURE_MAX_LEVEL)==2,"maximum level is renumbered");
+		
+		//	Sized from the texture itself so that a wrong number
+		//	of dropped levels cannot overrun the buffer
+		GLint w;
+		GLint h;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D,0,GL_TEXTURE_WIDTH,&w);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D,0,GL_TEXTURE_HEIGHT,&h);
+		raise();
+		expect(w==(size>>2),"top level is the third level of the original");
+		std::vector<std::uint8_t> texels(std::size_t(w)*std::size_t(h)*4);
+		glGetTexImage(GL_TEXTURE_2D,0,GL_RGBA,GL_UNSIGNED_BYTE,texels.data());
+		raise();
+		bool kept=true;
+		for (auto t : texels) if (t!=2) kept=false;
+		expect(kept,"remaining levels are copied");
+		
+	}
+	
+	
+	void check_multiple_levels () {
+		
+		//	Only fits once the three largest levels are gone
+		texture_storage fits{GL_TEXTURE_2D,GL_RGBA8,size>>3,size>>3,1,levels-3,0};
+		residency_manager m(fits.size());
+		auto a=m.add(make(),storage());
+		
+		m.enforce();
+		expect(m.storage(a).levels==levels-3,"texture loses exactly as many levels as needed");
+		expect(m.evictions()==3,"each dropped level is an eviction");
+		expect(m.used()<=m.budget(),"usage is within budget");
+		
+		auto g=m.get(a).bind(GL_TEXTURE_2D);
+		GLint w;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D,0,GL_TEXTURE_WIDTH,&w);
+		raise();
+		expect(w==(size>>3),"top level is the fourth level of the original");
+		std::vector<std::uint8_t> texels(std::size_t(w)*std::size_t(w)*4);
+		glGetTexImage(GL_TEXTURE_2D,0,GL_RGBA,GL_UNSIGNED_BYTE,texels.data());
+		raise();
+		bool kept=true;
+		for (auto t : texels) if (t!=3) kept=false;
+		expect(kept,"remaining levels are copied");
+		
+		//	Cannot fit at all, so levels are dropped down to the
+		//	minimum before the texture is freed
+		residency_manager n(1);
+		auto b=n.add(make(),storage(),residency_manager::evict_type{},4);
+		n.enforce();
+		expect(n.storage(b).levels==4,"levels are not dropped beyond the minimum");
+		expect(!n.resident(b),"texture which cannot fit is freed");
+		expect(n.evictions()==4,"dropped levels and the freed texture are evictions");
+		
+	}
+	
+	
+}
+
+
+int main () {
+	
+	try {
+		
+		headless::context ctx(4,3);
+		if (!(GLEW_ARB_texture_storage && GLEW_ARB_copy_image)) throw std::runtime_error("ARB_texture_storage and ARB_copy_image are required");
+		
+		check_sizes();
+		check_eviction();
+		check_multiple_levels();
+		
+		if (failures!=0) {
+			
+			std::cout << failures << " checks failed\n";
+			return EXIT_FAILURE;
+			
+		}
+		
+		std::cout << "All checks passed\n";
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		return 2;
+		
+	}
+	
+	return EXIT_SUCCESS;
+	
+}
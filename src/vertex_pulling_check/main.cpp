@@ -0,0 +1,379 @@
+//	Builds a program which reads a vertex_format through fixed
+//	function vertex fetch and programs which pull the same format
+//	from a shader storage buffer and from a buffer texture, checks
+//	that all of them compile, link, and see identical attributes,
+//	and then times drawing with each
+//
+//	Usage: vertex_pulling_check [<vertices to time>]
+//
+//	Exits with 1 if the programs disagree and 2 on any other
+//	error (including failure to compile or link).
+
+
+//	We must include in this order because glew.h insists
+//	on being included before gl.h
+#include <GL/glew.h>
+#include "../headless/context.hpp"
+#include <gl_utilities/opengl.hpp>
+#include <gl_utilities/pixel.hpp>
+#include <gl_utilities/render_target_pool.hpp>
+#include <gl_utilities/vertex_format.hpp>
+#include <gl_utilities/vertex_pulling.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace {
+	
+	
+	using namespace gl_utilities;
+	using namespace gl_utilities::opengl;
+	
+	
+	//	One attribute of every kind of conversion
+	class vertex {
+		
+		
+		public:
+		
+		
+			float position [3];
+			packed_2_10_10_10 normal;
+			half uv [2];
+			GLshort tangent [2];
+			GLubyte color [4];
+			GLuint id;
+		
+		
+	};
+	
+	
+	using format=vertex_format<
+		vertex,
+		vertex_attribute<0,float,3,offsetof(vertex,position)>,
+		vertex_attribute<1,packed_2_10_10_10,4,offsetof(vertex,normal),conversion::normalized>,
+		vertex_attribute<2,half,2,offsetof(vertex,uv)>,
+		vertex_attribute<3,GLshort,2,offsetof(vertex,tangent),conversion::normalized>,
+		vertex_attribute<4,GLubyte,4,offsetof(vertex,color),conversion::normalized>,
+		vertex_attribute<5,GLuint,1,offsetof(vertex,id),conversion::integer>
+	>;
+	
+	
+	//	Each vertex is captured as 15 floats followed by the
+	//	integer attribute
+	const std::size_t words=16;
+	
+	
+	const char * const outputs []={"o0","o1","o2","o3","o4","o5"};
+	
+	
+	const char * const declarations=
+		"out vec3 o0;\n"
+		"out vec4 o1;\n"
+		"out vec2 o2;\n"
+		"out vec2 o3;\n"
+		"out vec4 o4;\n"
+		"flat out uint o5;\n";
+	
+	
+	std::string classic_source () {
+		
+		std::string retr("#version 430 core\n");
+		retr+=
+			"layout(location=0) in vec3 a0;\n"
+			"layout(location=1) in vec4 a1;\n"
+			"layout(location=2) in vec2 a2;\n"
+			"layout(location=3) in vec2 a3;\n"
+			"layout(location=4) in vec4 a4;\n"
+			"layout(location=5) in uint a5;\n";
+		retr+=declarations;
+		retr+=
+			"void main () {\n"
+			"\to0=a0;\n"
+			"\to1=a1;\n"
+			"\to2=a2;\n"
+			"\to3=a3;\n"
+			"\to4=a4;\n"
+			"\to5=a5;\n"
+			"\tgl_Position=vec4(a0,1.0);\n"
+			"}\n";
+		
+		return retr;
+		
+	}
+	
+	
+	std::string pulling_source (vertex_pulling_storage storage) {
+		
+		std::string retr("#version 430 core\n");
+		retr+=vertex_pulling_source<format>("mesh",0,storage);
+		retr+=declarations;
+		retr+=
+			"void main () {\n"
+			"\tuint v=uint(gl_VertexID);\n"
+			"\to0=mesh_attribute0(v);\n"
+			"\to1=mesh_attribute1(v);\n"
+			"\to2=mesh_attribute2(v);\n"
+			"\to3=mesh_attribute3(v);\n"
+			"\to4=mesh_attribute4(v);\n"
+			"\to5=mesh_attribute5(v);\n"
+			"\tgl_Position=vec4(o0,1.0);\n"
+			"}\n";
+		
+		return retr;
+		
+	}
+	
+	
+	program make_program (const std::string & src) {
+		
+		shader s(GL_VERTEX_SHADER,src);
+		program retr;
+		retr.attach(s);
+		glTransformFeedbackVaryings(retr,GLsizei(sizeof(outputs)/sizeof(*outputs)),outputs,GL_INTERLEAVED_ATTRIBS);
+		raise();
+		retr.link();
+		
+		return retr;
+		
+	}
+	
+	
+	//	Raw bits for the packed and short attributes so that
+	//	the most negative values, which must clamp to -1, are
+	//	covered
+	std::vector<vertex> make_vertices (std::size_t count) {
+		
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> d(-100.0f,100.0f);
+		std::uniform_int_distribution<std::uint32_t> bits;
+		std::vector<vertex> retr(count);
+		for (std::size_t i=0;i<count;++i) {
+			
+			auto & v=retr[i];
+			for (auto & p : v.position) p=d(rng);
+			v.normal.bits=bits(rng);
+			const float uv []={d(rng),d(rng)};
+			std::uint16_t h [2];
+			pixel::float_to_half(uv,h,2);
+			v.uv[0].bits=h[0];
+			v.uv[1].bits=h[1];
+			auto t=bits(rng);
+			v.tangent[0]=GLshort(std::int16_t(t&0xFFFFU));
+			v.tangent[1]=GLshort(std::int16_t(t>>16));
+			auto c=bits(rng);
+			for (std::size_t j=0;j<4;++j) v.color[j]=GLubyte(c>>(j*8));
+			v.id=GLuint(i);
+			
+		}
+		
+		return retr;
+		
+	}
+	
+	
+	//	Draws every vertex as a point with rasterization
+	//	disabled, capturing the outputs of the vertex shader
+	void draw (const program & p, const buffer & captured, std::size_t count) {
+		
+		auto g=p.use();
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER,0,captured);
+		glBeginTransformFeedback(GL_POINTS);
+		glDrawArrays(GL_POINTS,0,GLsizei(count));
+		glEndTransformFeedback();
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER,0,0);
+		raise();
+		
+	}
+	
+	
+	std::vector<std::uint32_t> read (const buffer & captured, std::size_t count) {
+		
+		std::vector<std::uint32_t> retr(count*words);
+		auto g=captured.bind(GL_COPY_READ_BUFFER);
+		glGetBufferSubData(GL_COPY_READ_BUFFER,0,GLsizeiptr(retr.size()*sizeof(std::uint32_t)),retr.data());
+		raise();
+		
+		return retr;
+		
+	}
+	
+	
+	//	Returns the number of vertices whose attributes differ,
+	//	conversions are compared as floats since the fixed
+	//	function fetch need not round in the same way as the
+	//	shader
+	std::size_t compare (const char * name, const std::vector<std::uint32_t> & a, const std::vector<std::uint32_t> & b) {
+		
+		std::size_t retr=0;
+		float worst=0.0f;
+		for (std::size_t i=0;i<a.size();i+=words) {
+			
+			bool same=a[i+words-1]==b[i+words-1];
+			for (std::size_t j=0;j<(words-1);++j) {
+				
+				float x;
+				float y;
+				std::memcpy(&x,&a[i+j],sizeof(x));
+				std::memcpy(&y,&b[i+j],sizeof(y));
+				//	Relative to the magnitude for the positions
+				//	and half floats, absolute for the rest
+				auto diff=std::abs(x-y)/std::max(std::abs(x),1.0f);
+				worst=std::max(worst,diff);
+				if (!(diff<=1e-6f)) same=false;
+				
+			}
+			if (!same) ++retr;
+			
+		}
+		
+		std::cout << name << ": " << retr << " vertices differ, worst relative difference " << worst << '\n';
+		
+		return retr;
+		
+	}
+	
+	
+	template <typename Func>
+	double seconds (Func func) {
+		
+		//	The fastest of several runs is the least disturbed
+		double retr=std::numeric_limits<double>::infinity();
+		for (int i=0;i<5;++i) {
+			
+			auto start=std::chrono::steady_clock::now();
+			func();
+			glFinish();
+			std::chrono::duration<double> elapsed=std::chrono::steady_clock::now()-start;
+			if (elapsed.count()<retr) retr=elapsed.count();
+			
+		}
+		
+		return retr;
+		
+	}
+	
+	
+}
+
+
+int main (int argc, char ** argv) {
+	
+	try {
+		
+		std::size_t count=1<<20;
+		if (argc>2) throw std::runtime_error("Usage: vertex_pulling_check [<vertices to time>]");
+		if (argc==2) count=std::size_t(std::strtoull(argv[1],nullptr,10));
+		if (count==0) throw std::runtime_error("At least one vertex is required");
+		
+		headless::context ctx(4,3);
+		std::cout << "Renderer: " << reinterpret_cast<const char *>(glGetString(GL_RENDERER)) << '\n';
+		
+		auto classic=make_program(classic_source());
+		auto storage=make_program(pulling_source(vertex_pulling_storage::shader_storage));
+		auto texture_buffer=make_program(pulling_source(vertex_pulling_storage::texture_buffer));
+		std::cout << "All programs compiled and linked\n";
+		
+		auto vertices=make_vertices(count);
+		buffer vb;
+		{
+			
+			auto g=vb.bind(GL_ARRAY_BUFFER);
+			glBufferData(GL_ARRAY_BUFFER,GLsizeiptr(vertices.size()*sizeof(vertex)),vertices.data(),GL_STATIC_DRAW);
+			raise();
+			
+		}
+		buffer captured;
+		{
+			
+			auto g=captured.bind(GL_ARRAY_BUFFER);
+			glBufferData(GL_ARRAY_BUFFER,GLsizeiptr(count*words*sizeof(std::uint32_t)),nullptr,GL_STREAM_READ);
+			raise();
+			
+		}
+		
+		vertex_array vao;
+		format::apply(vao,vb);
+		vertex_pulling from_storage;
+		from_storage.add_storage(0,vb);
+		texture tb;
+		vertex_pulling from_texture;
+		from_texture.add_texture(0,tb,vb);
+		{
+			
+			auto g=texture_buffer.use();
+			glUniform1i(glGetUniformLocation(texture_buffer,"mesh_texture"),0);
+			raise();
+			
+		}
+		
+		//	A surfaceless context has no default frame buffer
+		//	and drawing requires a complete one even though
+		//	nothing is rasterized
+		render_target target(render_target_description{1,1,0,{render_target_attachment{GL_COLOR_ATTACHMENT0,GL_RGBA8,false}}});
+		auto fg=target.fb.bind(GL_DRAW_FRAMEBUFFER);
+		glEnable(GL_RASTERIZER_DISCARD);
+		
+		auto draw_classic=[&] () {
+			
+			auto g=vao.bind();
+			draw(classic,captured,count);
+			
+		};
+		auto draw_storage=[&] () {
+			
+			auto g=from_storage.bind();
+			draw(storage,captured,count);
+			
+		};
+		auto draw_texture=[&] () {
+			
+			auto g=from_texture.bind();
+			draw(texture_buffer,captured,count);
+			
+		};
+		
+		draw_classic();
+		auto expected=read(captured,count);
+		draw_storage();
+		std::size_t failures=compare("shader storage",expected,read(captured,count));
+		draw_texture();
+		failures+=compare("texture buffer",expected,read(captured,count));
+		
+		auto c=seconds(draw_classic);
+		auto s=seconds(draw_storage);
+		auto t=seconds(draw_texture);
+		auto rate=[&] (double secs) {	return (double(count)/secs)/1e6;	};
+		std::cout << std::fixed << std::setprecision(1)
+			<< "Attributes:     " << std::setw(10) << rate(c) << " M vertices/s\n"
+			<< "Shader storage: " << std::setw(10) << rate(s) << " M vertices/s (" << std::setprecision(2) << (c/s) << "x)\n"
+			<< std::setprecision(1)
+			<< "Texture buffer: " << std::setw(10) << rate(t) << " M vertices/s (" << std::setprecision(2) << (c/t) << "x)\n";
+		
+		glDisable(GL_RASTERIZER_DISCARD);
+		
+		if (failures!=0) return EXIT_FAILURE;
+		
+	} catch (const std::exception & ex) {
+		
+		std::cerr << ex.what() << std::endl;
+		return 2;
+		
+	}
+	
+	return EXIT_SUCCESS;
+	
+}